@@ -21,8 +21,16 @@
 ; flaglar
 MBOOT_PAGE_ALIGN	equ	1<<0		; sayfa hizalamasi
 MBOOT_MEM_INFO		equ	1<<1		; bellek bilgisi
+MBOOT_VIDEO_MODE	equ	1<<2		; grafik modu istegi
 
-MBOOT_HEADER_FLAGS	equ	MBOOT_PAGE_ALIGN | MBOOT_MEM_INFO
+; grub.cfg'de gfxpayload=text ise text modda kalinir, degilse
+; asagidaki lfb modu istenir ve vbe bilgisi kernele verilir.
+MBOOT_VIDEO_LINEAR	equ	0		; 0 = dogrusal grafik modu
+MBOOT_VIDEO_WIDTH	equ	1024
+MBOOT_VIDEO_HEIGHT	equ	768
+MBOOT_VIDEO_DEPTH	equ	32
+
+MBOOT_HEADER_FLAGS	equ	MBOOT_PAGE_ALIGN | MBOOT_MEM_INFO | MBOOT_VIDEO_MODE
 MBOOT_HEADER_MAGIC	equ	0x1BADB002	; multiboot header magic number
 MBOOT_CHECKSUM		equ	-(MBOOT_HEADER_MAGIC + MBOOT_HEADER_FLAGS)
 
@@ -44,6 +52,10 @@ mboot_header:
 		dd	bss			; '.data' bolumu sonu
 		dd	end			; kernel sonu
 		dd	kentry			; kernel giris noktasi (ilk EIP)
+		dd	MBOOT_VIDEO_LINEAR	; grafik modu tipi
+		dd	MBOOT_VIDEO_WIDTH	; genislik (piksel)
+		dd	MBOOT_VIDEO_HEIGHT	; yukseklik (piksel)
+		dd	MBOOT_VIDEO_DEPTH	; piksel basina bit
 
 
 SECTION .text
@@ -0,0 +1,432 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Local APIC
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/apic.h>
+#include <uniq/mpconf.h>
+#include <uniq/cpuid.h>
+#include <uniq/smp.h>
+#include <uniq/div64.h>
+#include <drivers/pit.h>
+
+#define LAPIC_DEFAULT_ADDR	0xFEE00000
+#define KERN_CODE_SEGMENT	0x8
+#define INT_GATE		0x8E
+#define ISA_IRQS		16
+#define LAPIC_CALIBRATE_MS	10
+#define TIMER_IRQ		0
+
+typedef struct{
+	volatile uint32_t *base;	/* mmio */
+	uint32_t gsi_base;		/* ilk global sistem kesmesi */
+	uint32_t nentries;		/* yonlendirme girisi sayisi */
+}ioapic_t;
+
+extern void _lapic_spurious(void);
+
+volatile uint32_t *lapic_base = NULL;
+bool apic_enabled = false;
+volatile uint32_t lapic_spurious_count = 0;
+
+static ioapic_t ioapics[MAX_IOAPICS];
+static uint32_t nioapics = 0;
+static uint32_t isa_gsi[ISA_IRQS];		/* isa irq -> gsi */
+static uint32_t isa_flags[ISA_IRQS];		/* polarite ve tetikleme */
+
+static void lapic_timer_periodic(void);
+static void lapic_timer_oneshot(uint32_t count);
+static uint32_t lapic_timer_read(void);
+
+static tick_device_t lapic_tick_device = {
+	.name = "lapic",
+	.set_periodic = lapic_timer_periodic,
+	.set_oneshot = lapic_timer_oneshot,
+	.read_count = lapic_timer_read,
+};
+
+/*
+ * lapic_init, local apic'i kernel_dir'e esler. islemcide local apic
+ * yoksa false doner.
+ */
+bool lapic_init(void){
+
+	uint32_t addr = mpconf.lapic_addr ? mpconf.lapic_addr : LAPIC_DEFAULT_ADDR;
+
+	if(!cpu_has_feature(CPU_FEATURE_APIC))
+		return false;
+
+	if(!lapic_base){
+		lapic_base = ioremap(addr,FRAME_SIZE_BYTE);
+		if(!lapic_base)
+			return false;
+
+		/* sahte kesmeler eoi istemez, sayilip dogrudan iret edilir */
+		idt_set_gate(LAPIC_SPURIOUS_VECTOR,_lapic_spurious,KERN_CODE_SEGMENT,INT_GATE);
+	}
+
+	return true;
+
+}
+
+/*
+ * lapic_enable, calisan cpu'nun local apic'ini etkinlestirir.
+ */
+void lapic_enable(void){
+
+	lapic_write(LAPIC_SVR,LAPIC_SVR_ENABLE | LAPIC_SPURIOUS_VECTOR);
+	lapic_write(LAPIC_TPR,0);
+
+	/* bekleyen hatalari temizle */
+	lapic_write(LAPIC_ESR,0);
+	lapic_write(LAPIC_ESR,0);
+
+}
+
+/*
+ * lapic_id, calisan cpu'nun local apic id'sini dondurur.
+ */
+uint32_t lapic_id(void){
+
+	return lapic_read(LAPIC_ID) >> 24;
+
+}
+
+/*
+ * lapic_send_ipi, verilen cpu'ya islemciler arasi kesme gonderir ve
+ * teslim edilene kadar bekler.
+ *
+ * @param apic_id : hedef local apic id
+ * @param icr : icr'in alt 32 biti (teslim modu, vektor)
+ */
+void lapic_send_ipi(uint32_t apic_id,uint32_t icr){
+
+	uint32_t flags = irq_save();
+
+	lapic_write(LAPIC_ICR_HIGH,apic_id << 24);
+	lapic_write(LAPIC_ICR_LOW,icr);
+
+	while(lapic_read(LAPIC_ICR_LOW) & ICR_DELIVERY_PENDING)
+		relax_cpu();
+
+	irq_restore(flags);
+
+}
+
+/*
+ * ioapic_read, io apic yazmacini okur.
+ *
+ * @param ioapic : io apic
+ * @param reg : yazmac
+ */
+static uint32_t ioapic_read(ioapic_t *ioapic,uint32_t reg){
+
+	ioapic->base[IOAPIC_REGSEL / 4] = reg;
+
+	return ioapic->base[IOAPIC_WINDOW / 4];
+
+}
+
+/*
+ * ioapic_write, io apic yazmacina yazar.
+ *
+ * @param ioapic : io apic
+ * @param reg : yazmac
+ * @param val : deger
+ */
+static void ioapic_write(ioapic_t *ioapic,uint32_t reg,uint32_t val){
+
+	ioapic->base[IOAPIC_REGSEL / 4] = reg;
+	ioapic->base[IOAPIC_WINDOW / 4] = val;
+
+}
+
+/*
+ * ioapic_from_gsi, gsi'nin bagli oldugu io apic'i bulur ve girisi
+ * pin'e yazar.
+ *
+ * @param gsi : global sistem kesmesi
+ * @param pin : io apic giris numarasi
+ */
+static ioapic_t *ioapic_from_gsi(uint32_t gsi,uint32_t *pin){
+
+	for(uint32_t i = 0; i < nioapics; i++){
+		if(gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].nentries){
+			*pin = gsi - ioapics[i].gsi_base;
+			return &ioapics[i];
+		}
+	}
+
+	return NULL;
+
+}
+
+/*
+ * ioapic_route, isa irq'sunu IRQ_VECTOR_BASE + irq vektorune ve verilen
+ * cpu'ya yonlendirir.
+ *
+ * @param irq : isa irq
+ * @param apic_id : hedef local apic id
+ * @param masked : giris maskeli mi kalsin?
+ */
+static bool ioapic_route(uint8_t irq,uint32_t apic_id,bool masked){
+
+	uint32_t pin;
+	ioapic_t *ioapic = ioapic_from_gsi(isa_gsi[irq],&pin);
+	uint32_t low = (IRQ_VECTOR_BASE + irq) | isa_flags[irq];
+
+	if(!ioapic)
+		return false;
+
+	if(masked)
+		low |= IOAPIC_MASKED;
+
+	/* once maskeleyip hedefi, sonra alt yariyi yaziyoruz */
+	ioapic_write(ioapic,IOAPIC_REG_REDTBL + pin * 2,IOAPIC_MASKED);
+	ioapic_write(ioapic,IOAPIC_REG_REDTBL + pin * 2 + 1,apic_id << 24);
+	ioapic_write(ioapic,IOAPIC_REG_REDTBL + pin * 2,low);
+
+	return true;
+
+}
+
+/*
+ * ioapic_set_mask, isa irq'sunun io apic girisini maskeler ya da acar.
+ *
+ * @param irq : isa irq
+ * @param masked : maskeli mi?
+ */
+static void ioapic_set_mask(uint8_t irq,bool masked){
+
+	uint32_t pin,low,flags;
+	ioapic_t *ioapic;
+
+	if(irq >= ISA_IRQS || !(ioapic = ioapic_from_gsi(isa_gsi[irq],&pin)))
+		return;
+
+	flags = irq_save();
+
+	low = ioapic_read(ioapic,IOAPIC_REG_REDTBL + pin * 2);
+	if(masked)
+		low |= IOAPIC_MASKED;
+	else
+		low &= ~IOAPIC_MASKED;
+	ioapic_write(ioapic,IOAPIC_REG_REDTBL + pin * 2,low);
+
+	irq_restore(flags);
+
+}
+
+void ioapic_mask_irq(uint8_t irq){
+
+	ioapic_set_mask(irq,true);
+
+}
+
+void ioapic_unmask_irq(uint8_t irq){
+
+	ioapic_set_mask(irq,false);
+
+}
+
+/*
+ * ioapic_set_affinity, isa irq'sunu verilen cpu'ya yonlendirir.
+ * maske durumu korunur.
+ *
+ * @param irq : isa irq
+ * @param apic_id : hedef local apic id
+ */
+bool ioapic_set_affinity(uint8_t irq,uint32_t apic_id){
+
+	uint32_t pin,flags;
+	ioapic_t *ioapic;
+	bool ret;
+
+	if(irq >= ISA_IRQS || !(ioapic = ioapic_from_gsi(isa_gsi[irq],&pin)))
+		return false;
+
+	flags = irq_save();
+	ret = ioapic_route(irq,apic_id,ioapic_read(ioapic,IOAPIC_REG_REDTBL + pin * 2) & IOAPIC_MASKED);
+	irq_restore(flags);
+
+	return ret;
+
+}
+
+/*
+ * ioapic_init, io apic'leri esler, tum girislerini maskeler ve isa
+ * irq'larini firmware'in bildirdigi gsi'lara gore bsp'ye yonlendirir.
+ */
+static bool ioapic_init(void){
+
+	for(uint32_t i = 0; i < mpconf.nioapics; i++){
+
+		ioapic_t *ioapic = &ioapics[nioapics];
+
+		ioapic->base = ioremap(mpconf.ioapics[i].addr,FRAME_SIZE_BYTE);
+		if(!ioapic->base)
+			continue;
+
+		ioapic->gsi_base = mpconf.ioapics[i].gsi_base;
+		ioapic->nentries = ((ioapic_read(ioapic,IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+
+		for(uint32_t pin = 0; pin < ioapic->nentries; pin++)
+			ioapic_write(ioapic,IOAPIC_REG_REDTBL + pin * 2,IOAPIC_MASKED);
+
+		nioapics++;
+
+	}
+
+	if(!nioapics)
+		return false;
+
+	/* isa irq'lari varsayilan olarak ayni numarali gsi'ya, kenar tetiklemeli */
+	for(uint32_t irq = 0; irq < ISA_IRQS; irq++){
+		isa_gsi[irq] = irq;
+		isa_flags[irq] = 0;
+	}
+
+	for(uint32_t i = 0; i < mpconf.noverrides; i++){
+
+		irq_override_t *over = &mpconf.overrides[i];
+
+		if(over->irq >= ISA_IRQS)
+			continue;
+
+		isa_gsi[over->irq] = over->gsi;
+		isa_flags[over->irq] = 0;
+		if((over->flags & MP_IRQ_POLARITY_MASK) == MP_IRQ_POLARITY_LOW)
+			isa_flags[over->irq] |= IOAPIC_POLARITY_LOW;
+		if((over->flags & MP_IRQ_TRIGGER_MASK) == MP_IRQ_TRIGGER_LEVEL)
+			isa_flags[over->irq] |= IOAPIC_TRIGGER_LEVEL;
+
+	}
+
+	for(uint32_t irq = 0; irq < ISA_IRQS; irq++)
+		ioapic_route(irq,cpus[0].apic_id,true);
+
+	return true;
+
+}
+
+/*
+ * lapic_timer_periodic, local apic zamanlayicisini PIT_HZ ile
+ * periyodik calistirir.
+ */
+static void lapic_timer_periodic(void){
+
+	lapic_write(LAPIC_TIMER_DIVIDE,LAPIC_TIMER_DIV16);
+	lapic_write(LAPIC_LVT_TIMER,LAPIC_TIMER_PERIODIC | (IRQ_VECTOR_BASE + TIMER_IRQ));
+	lapic_write(LAPIC_TIMER_INITIAL,lapic_tick_device.tick_count);
+
+}
+
+/*
+ * lapic_timer_oneshot, count sonra tek kesme uretir.
+ *
+ * @param count : sayac degeri
+ */
+static void lapic_timer_oneshot(uint32_t count){
+
+	lapic_write(LAPIC_LVT_TIMER,IRQ_VECTOR_BASE + TIMER_IRQ);
+	lapic_write(LAPIC_TIMER_INITIAL,count);
+
+}
+
+/*
+ * lapic_timer_read, zamanlayicinin kalan sayacini dondurur.
+ */
+static uint32_t lapic_timer_read(void){
+
+	return lapic_read(LAPIC_TIMER_CURRENT);
+
+}
+
+/*
+ * lapic_timer_calibrate, local apic zamanlayicisinin bir tick'teki
+ * sayac degerini pit kanal 2'ye gore olcer. tsc olcumu icin yazilan
+ * timer_calibrate_tsc ayni zamanda tam LAPIC_CALIBRATE_MS bekledigi
+ * icin burada da kullanilir.
+ */
+static uint32_t lapic_timer_calibrate(void){
+
+	uint32_t pit_count,elapsed;
+
+	lapic_write(LAPIC_TIMER_DIVIDE,LAPIC_TIMER_DIV16);
+	lapic_write(LAPIC_LVT_TIMER,LAPIC_LVT_MASKED);
+	lapic_write(LAPIC_TIMER_INITIAL,0xFFFFFFFF);
+
+	if(!timer_calibrate_tsc(LAPIC_CALIBRATE_MS,&pit_count))
+		return 0;
+
+	elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CURRENT);
+	lapic_write(LAPIC_TIMER_INITIAL,0);
+
+	/* tick = elapsed / (pit_count / PIT_CLOCK) / PIT_HZ */
+	return (uint32_t)div_u64((uint64_t)elapsed * PIT_CLOCK,pit_count * PIT_HZ);
+
+}
+
+/*
+ * apic_init, local apic ve io apic varsa kesmeleri pic'ten io apic'e
+ * alir ve tick kaynagi olarak local apic zamanlayicisini kullanir.
+ * herhangi bir adim basarisiz olursa pic ve pit ile devam edilir.
+ */
+void apic_init(void){
+
+	uint32_t flags,tick_count;
+
+	if(!lapic_base || !mpconf.nioapics){
+		debug_print(KERN_INFO,"No IO APIC, using the 8259 PIC.");
+		return;
+	}
+
+	flags = irq_save();
+
+	if(!ioapic_init()){
+		irq_restore(flags);
+		debug_print(KERN_WARNING,"IO APIC could not be mapped, using the 8259 PIC.");
+		return;
+	}
+
+	tick_count = lapic_timer_calibrate();
+	irq_enable_apic(mpconf.imcr);
+	apic_enabled = true;
+
+	/*
+	 * local apic zamanlayicisi kullanilabiliyorsa pit kesmesini io
+	 * apic'te kapali tutuyoruz, ayni vektoru local apic uretecek.
+	 */
+	if(tick_count){
+		lapic_tick_device.tick_count = tick_count;
+		lapic_tick_device.max_oneshot_ticks = 0xFFFFFFFF / tick_count;
+		ioapic_mask_irq(TIMER_IRQ);
+		timer_set_tick_device(&lapic_tick_device);
+	}
+
+	irq_restore(flags);
+
+	debug_print(KERN_INFO,"APIC enabled, %u io apic(s), lapic timer %u counts/tick.",nioapics,tick_count);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -310,6 +310,59 @@ static void do_amd_cpuinfo(cpuid_info_t *cpuid_info){
 
 }
 
+/*
+ * cpu_has_feature, islemcinin verilen ozelligi (CPU_FEATURE_*)
+ * destekleyip desteklemedigini dondurur. ozellik bitleri ilk
+ * cagrida okunup saklanir.
+ *
+ * @param feature : ozellik
+ */
+bool cpu_has_feature(uint32_t feature){
+
+	static bool features_read = false;
+	static uint32_t features[2];		/* ecx, edx */
+	uint32_t unused;
+
+	if(!features_read){
+		features[0] = features[1] = 0;
+
+		if(have_cpuid())
+			cpuid(CPUID_PROCESSOR_DETAIL,&unused,&unused,&features[0],&features[1]);
+
+		features_read = true;
+	}
+
+	return (features[feature / 32] >> (feature % 32)) & 1;
+
+}
+
+/*
+ * cpu_enable_sse, islemci sse2 destekliyorsa calisan cpu'da sse
+ * komutlarini acar (CR0.EM = 0, CR0.MP = 1, CR4.OSFXSR ve
+ * CR4.OSXMMEXCPT = 1). her cpu icin ayri cagrilmalidir. xmm
+ * kaydedicileri surec degisiminde saklanmadigi icin kernel bunlari
+ * sadece kesmeler kapaliyken kullanabilir.
+ */
+bool cpu_enable_sse(void){
+
+	uint32_t cr0,cr4;
+
+	if(!cpu_has_feature(CPU_FEATURE_FXSR) || !cpu_has_feature(CPU_FEATURE_SSE2))
+		return false;
+
+	__asm__ volatile("movl %%cr0, %0" : "=r"(cr0));
+	cr0 &= ~0x4;		/* EM, x87 emulasyonu */
+	cr0 |= 0x2;		/* MP */
+	__asm__ volatile("movl %0, %%cr0" : : "r"(cr0));
+
+	__asm__ volatile("movl %%cr4, %0" : "=r"(cr4));
+	cr4 |= 0x600;		/* OSFXSR | OSXMMEXCPT */
+	__asm__ volatile("movl %0, %%cr4" : : "r"(cr4));
+
+	return true;
+
+}
+
 /*
  * get_cpuid_info, islemci bilgilerini cpuid_info_t yapisina
  * doldurur.
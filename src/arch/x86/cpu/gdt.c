@@ -21,6 +21,8 @@
 #include <uniq/module.h>
 #include <uniq/kernel.h>
 #include <compiler.h>
+#include <uniq/smp.h>
+#include <string.h>
 
 /*
  * -Genel bilgiler-
@@ -530,14 +532,22 @@ struct gdt_ptr_t{
 #define USER_CODE_SEGMENT	SEGMENT_PRESENT | SEGMENT_DPL3 | SEGMENT_NORMAL | SEGMENT_CODE_EXECR	/* 0xFA */
 #define USER_DATA_SEGMENT	SEGMENT_PRESENT | SEGMENT_DPL3 | SEGMENT_NORMAL | SEGMENT_DATA_RW	/* 0xF2 */
 
-struct gdt_entry_t	gdt_entry[5];
-struct gdt_ptr_t	gdt_ptr;
+#define SEGMENT_TSS		0x89		/* bellekte, 32 bit tss (hazir) */
+#define SEGMENT_BYTE_GRAN	0x40		/* 32 bit, byte cinsinden limit */
+
+/*
+ * her cpu'nun kendi gdt'si vardir. tablolar cpu numarasina gore
+ * secilir, selektorler tum cpu'larda aynidir (uniq/smp.h).
+ */
+struct gdt_entry_t	gdt_entry[MAX_CPUS][GDT_ENTRIES];
+struct gdt_ptr_t	gdt_ptr[MAX_CPUS];
 
 extern void gdt_load(uint32_t gdt_ptr);
 
 /*
  * gdt_set_gate, gdt tablosunun girdilerinin ayarlanmasini saglar.
  *
+ * @param cpu : gdt'si ayarlanacak cpu numarasi
  * @param num : ayarlanacak tanimlayici icin numara, kisaca tanimlayici numarasi
  *              diyebiliriz.
  * @param base : taban adres
@@ -545,61 +555,97 @@ extern void gdt_load(uint32_t gdt_ptr);
  * @param access : erisim izinleri
  * @param gran : diger flaglar
  */
-void gdt_set_gate(size_t num,uint32_t base,uint32_t limit,uint8_t access,uint8_t gran){
+void gdt_set_gate(uint32_t cpu,size_t num,uint32_t base,uint32_t limit,uint8_t access,uint8_t gran){
 	
+	struct gdt_entry_t *entry = &gdt_entry[cpu][num];
+
 	/* taban adres */
-	gdt_entry[num].base_low    	= (base & 0xFFFF);
-	gdt_entry[num].base_middle 	= (base >> 16) & 0xFF;
-	gdt_entry[num].base_high  	= (base >> 24) & 0xFF;
+	entry->base_low    	= (base & 0xFFFF);
+	entry->base_middle 	= (base >> 16) & 0xFF;
+	entry->base_high  	= (base >> 24) & 0xFF;
 
 	/* limit */
-	gdt_entry[num].limit_low 	= (limit & 0xFFFF);
-	gdt_entry[num].granularity 	= (limit >> 16) & 0x0F;
+	entry->limit_low 	= (limit & 0xFFFF);
+	entry->granularity 	= (limit >> 16) & 0x0F;
 
 	/* diger flaglar */
-	gdt_entry[num].granularity 	|= (gran & 0xF0);
+	entry->granularity 	|= (gran & 0xF0);
 
 	/* erisim flaglari */
-	gdt_entry[num].access 	= access;	
+	entry->access 		= access;	
 	
 } 
 
 /*
- * gdt_init, gdt tablosunun hazirlanmasi ve yuklenmesi islemleri 
- * gerceklestirir.
+ * gdt_init_cpu, cpu'nun gdt'sini ve tss'ini hazirlayip yukler. %gs
+ * cpu'nun cpu_t yapisini gosterecek sekilde ayarlanir.
+ *
+ * @param cpu : cpu
  */
-void gdt_init(void){
-	
-	debug_print(KERN_INFO,"Initializing the GDT. GDT table address is \033[1;37m%P",(uint32_t)&gdt_entry);
-	
+void gdt_init_cpu(cpu_t *cpu){
+
+	uint32_t id = cpu->id;
+
 	/*
 	 * peki neden sizeof(struct gdt_entry_t), yani 8 bayt ile
 	 * carpiyoruz? cunku segment tanimlayicilari 8 bayt uzunlugunda
 	 * ve limit degeri gdt tablosunun toplam uzunlugunu tutuyor.
 	 * kisaca gdt limiti diyebiliriz.
 	 */
-	gdt_ptr.limit = (sizeof(struct gdt_entry_t) * 5) - 1;
-	gdt_ptr.base = (uint32_t)&gdt_entry;
+	gdt_ptr[id].limit = (sizeof(struct gdt_entry_t) * GDT_ENTRIES) - 1;
+	gdt_ptr[id].base = (uint32_t)&gdt_entry[id];
+
+	/*
+	 * kullanici modundan kesme geldiginde islemci stack'i tss'ten
+	 * alir.
+	 */
+	memset(&cpu->tss,0,sizeof(tss_entry_t));
+	cpu->tss.ss0 = GDT_KERNEL_DATA;
+	cpu->tss.esp0 = cpu->stack;
+	cpu->tss.iomap_base = sizeof(tss_entry_t);
 	
 	/*
 	 * gdt ve ldt tablolarinda bir tane bos diger bir tabirle null
 	 * segment olmasi gerekmektedir.
 	 */
-	gdt_set_gate(0, 0, 0, 0, 0);
+	gdt_set_gate(id, 0, 0, 0, 0, 0);
 	/* kernel kod segmenti */
-	gdt_set_gate(1, 0, SEGMENT_MAX_LIMIT, KERNEL_CODE_SEGMENT, SEGMENT_NORMAL_GRAN);
+	gdt_set_gate(id, 1, 0, SEGMENT_MAX_LIMIT, KERNEL_CODE_SEGMENT, SEGMENT_NORMAL_GRAN);
 	/* kernel veri segmenti */
-	gdt_set_gate(2, 0, SEGMENT_MAX_LIMIT, KERNEL_DATA_SEGMENT, SEGMENT_NORMAL_GRAN);
+	gdt_set_gate(id, 2, 0, SEGMENT_MAX_LIMIT, KERNEL_DATA_SEGMENT, SEGMENT_NORMAL_GRAN);
 	/* kullanici kod segmenti */
-	gdt_set_gate(3, 0, SEGMENT_MAX_LIMIT, USER_CODE_SEGMENT, SEGMENT_NORMAL_GRAN);
+	gdt_set_gate(id, 3, 0, SEGMENT_MAX_LIMIT, USER_CODE_SEGMENT, SEGMENT_NORMAL_GRAN);
 	/* kullanici veri segmenti */
-	gdt_set_gate(4, 0, SEGMENT_MAX_LIMIT, USER_DATA_SEGMENT, SEGMENT_NORMAL_GRAN);
+	gdt_set_gate(id, 4, 0, SEGMENT_MAX_LIMIT, USER_DATA_SEGMENT, SEGMENT_NORMAL_GRAN);
+	/* cpu'ya ozel veri segmenti, %gs */
+	gdt_set_gate(id, 5, (uint32_t)cpu, sizeof(cpu_t) - 1, KERNEL_DATA_SEGMENT, SEGMENT_BYTE_GRAN);
+	/* tss */
+	gdt_set_gate(id, 6, (uint32_t)&cpu->tss, sizeof(tss_entry_t) - 1, SEGMENT_TSS, 0);
 	
 	/*
 	 * son ayarlarimizi yapalim...
 	 * go go go ;)
 	 */
-	gdt_load((uint32_t)&gdt_ptr);
+	gdt_load((uint32_t)&gdt_ptr[id]);
+	__asm__ volatile("mov %0, %%gs" : : "r"(GDT_PERCPU));
+	__asm__ volatile("ltr %w0" : : "r"(GDT_TSS));
+
+}
+
+/*
+ * gdt_init, bsp'nin gdt tablosunun hazirlanmasi ve yuklenmesi
+ * islemleri gerceklestirir.
+ */
+void gdt_init(void){
+	
+	cpu_t *cpu = &cpus[0];
+
+	debug_print(KERN_INFO,"Initializing the GDT. GDT table address is \033[1;37m0x%08X",(uint32_t)&gdt_entry[0]);
+
+	cpu->self = cpu;
+	cpu->id = 0;
+	cpu->online = 1;
+	gdt_init_cpu(cpu);
 	
 }
 
@@ -325,7 +325,7 @@ void idt_set_gate(uint8_t num,void (*base)(void),uint16_t sel,uint8_t flags){
  */
 void idt_init(void){
 	
- 	debug_print(KERN_INFO,"Initializing the IDT. IDT table address is \033[1;37m%P",(uint32_t)&idt_entry);
+ 	debug_print(KERN_INFO,"Initializing the IDT. IDT table address is \033[1;37m0x%08X",(uint32_t)&idt_entry);
 
 	idt_ptr.limit = (sizeof(struct idt_entry_t) * IDT_MAX_ENTRY) - 1;
 	idt_ptr.base = (uint32_t)&idt_entry;
@@ -334,5 +334,15 @@ void idt_init(void){
 	
 }
 
+/*
+ * idt_load_cpu, idt_init'te hazirlanan tabloyu calisan cpu'ya yukler.
+ * tum cpu'lar ayni idt'yi kullanir.
+ */
+void idt_load_cpu(void){
+
+	idt_load((uint32_t)&idt_ptr);
+
+}
+
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
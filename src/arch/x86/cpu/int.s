@@ -23,12 +23,14 @@ BITS 32
 ; isr ve irq makrolari
 ; tum isr ve irq'lara ayri ayri kod yazicagimiza isimizi
 ; makrolarla halledelim ;)
+;
+; idt'deki tum girisler kesme kapisidir (INT_GATE), islemci kesmeye
+; girerken eflags.if'i zaten temizler. bu yuzden giriste cli yoktur.
 
 ; hata kodu icermeyen istisna kesmeleri icin macro
 %macro ISR_NOERR 1			; 1 sayisi 1 adet parametre aldigini gosteriyor
 	global _isr%1			; %1 , 1. parametre
 	_isr%1:	
-		cli			; kesmeleri devre disi birak
 		push byte 0		; bos hata kodu stack'a atilir,registers_t yi 
 					; alirken sikinti yasanmamasi icin
 		push byte %1		; kesme numarasini sakla.
@@ -39,7 +41,6 @@ BITS 32
 %macro ISR_ERR 1			; 1 sayisi 1 adet parametre aldigini gosteriyor
 	global _isr%1			; %1 , 1. parametre
 	_isr%1:
-		cli			; kesmeleri devre disi birak
 					; yukarida bos hata kodunu saklamistik,burda 
 					; otomatik olarak hata kodu zaten islemci
 					; tarafindan saklaniyor
@@ -51,12 +52,67 @@ BITS 32
 %macro IRQ_ENTRY 2			; 2 parametre aliyor
 	global _irq%1			; %1,  1. parametre
 	_irq%1:
-		cli			; kesmeleri devre disi birak
 		push byte 0		; bos hata kodu sakla
 		push byte %2		; %2, 2.parametre. kesme numarasini sakla
 		jmp irq_common_entry    ; irq'lar icin ortak girise zipla
 %endmacro
 
+REGS_CS		equ	60		; registers_t icinde cs'nin yeri
+
+; registers_t'yi stack'ta olusturur. edi,esi,ebp,esp,ebx,edx,ecx,eax
+; pusha ile, selektorler ise tek tek stack'a atilir. selektorleri stack'a
+; atmak ucuzdur fakat yuklemek (mov ds, ax) her seferinde tanimlayici
+; kontrolu yapar. kernel modunda ds/es/fs zaten kernel veri segmentini,
+; gs ise cpu'ya ozel veri segmentini gosterir. bu yuzden selektorler
+; sadece user moddan (cs'nin rpl'si 3) gelindiyse yuklenir. stack
+; ss uzerinden okundugu icin ds'nin ne oldugu onemli degildir.
+%macro SAVE_REGS 0
+	pusha
+	push ds
+	push es
+	push fs
+	push gs
+	test byte [esp + REGS_CS], 3
+	jz %%kernel
+	mov ax, 0x10
+	mov ds, ax
+	mov es, ax
+	mov fs, ax
+	mov ax, 0x28		; cpu'ya ozel veri segmenti (uniq/smp.h, GDT_PERCPU)
+	mov gs, ax
+%%kernel:
+%endmacro
+
+; SAVE_REGS'in tersi. selektorler sadece user moda donerken geri
+; yuklenir, kernel moduna donerken stack'tan atlanir. surec degismis
+; olabilecegi icin karar donulecek cercevedeki cs'ye gore verilir.
+;
+; iret'ten bahsedelim. bir kesme oldugunda calismakta olan fonksiyon
+; askiya alinir ve kesme yoneticisi cagrilir,islemci otomatik olarak kesme
+; yoneticisinin yigitina eip, cs, eflags, esp, ss kaydedicilerini atar. eger
+; askiya alinan fonksiyon ve kesme yoneticisi ayni ayricalik duzeyine sahip
+; olsa bir guvenlik sikintisi cikmaz fakat askiya alinan fonksiyonun user
+; modda olan bir fonksiyon olmasi guvenlik acigi meydana getirebilir. cunku
+; kesme yoneticisinin isi bittiginde otomatik olarak stack'a atilan bu
+; kaydediciler askiya alinan fonksiyonunun stack'inda da olur ve guvenlik
+; sikintisi cikar. iret fonksiyonu atilan bu kaydedicileri stack'tan geri
+; almamizi saglar.( iret = interrupt return)
+%macro RESTORE_REGS 0
+	test byte [esp + REGS_CS], 3
+	jz %%kernel
+	pop gs
+	pop fs
+	pop es
+	pop ds
+	jmp %%restore
+%%kernel:
+	add esp, 16
+%%restore:
+	popa			; edi,esi,ebp,esp,ebx,edx,ecx,eax'leri stack'tan al
+	add esp, 8		; kesme numarasi ve hata kodunu kaldir.("idt.c'yi inceleyin")
+	iret			; eip, cs, eflags, esp ve ss'yi geri al
+%endmacro
+
 
 ; standart x86 kesme servis rutinleri
 ISR_NOERR 0
@@ -92,9 +148,25 @@ ISR_NOERR 29
 ISR_NOERR 30
 ISR_NOERR 31
 
-
-; irq
-IRQ_ENTRY 0, 32
+; sistem cagrisi (int 0x80). 128 sayisi "push byte" ile isaretli
+; genisletilecegi icin makroyu kullanmiyoruz.
+global _isr128
+_isr128:
+	push byte 0
+	push dword 128
+	jmp isr_common_entry
+
+; local apic sahte kesmesi. eoi gerektirmez, sadece sayilir (irq_stat).
+; kullanici modundan gelinmis olabilir, ds yerine her zaman kernel
+; veri segmentini gosteren ss kullanilir.
+extern lapic_spurious_count
+global _lapic_spurious
+_lapic_spurious:
+	lock inc dword [ss:lapic_spurious_count]
+	iret
+
+
+; irq. irq0 (timer) asagida, hizli yoldan girer.
 IRQ_ENTRY 1, 33
 IRQ_ENTRY 2, 34
 IRQ_ENTRY 3, 35
@@ -113,134 +185,39 @@ IRQ_ENTRY 15, 47
 
 
 extern isr_handler
+extern irq_handler
+extern irq_timer_handler
 
 ; standart x86 kesme servisi rutinleri icin ortak giris
+;
+; peki neden stack pointer'i stack'a atiyoruz diye dusunebilirsiniz.
+; isr_handler fonksiyonunu incelediginizde onun direk registers_t
+; yapisini almadigini goreceksiniz. bir pointer aliyor yani adresini
+; en son kaldigimiz yer bizim registers_t yapisinin adresi olacaktir.
 isr_common_entry:
-  
-  	; edi,esi,ebp,esp,ebx,edx,ecx,eax'leri sakla
-	pusha
-	
-	; selektorleri sakla
-	push ds
-	push es
-	push fs
-	push gs
-	
-	; user modda cagrildiginda veri segmenti selektorleri 
-	; farkli segmentleri gosterecekleri icin onlari yukarida
-  	; stack'a attik. ve kernel mod veri segmentini tanimlayicisini
-	; ayarliyoruz.
-	mov ax, 0x10
-	mov ds, ax
-	mov es, ax
-	mov fs, ax
-	mov gs, ax
-	
-	; peki neden stack pointer'i sakladik diye dusunebilirsiniz.
-	; fault_handler fonksiyonunuzu incelediginizde onun direk
-	; registers_t yapisini almadigini goreceksiniz. bir pointer
-	; aliyor yani adresini en son kaldigimiz yer bizim registers_t
-	; yapisinin adresi olacaktir. ve adreside stack'a atiyoruz.
-	; fonksiyon cagrildiginda parametre olarak bir isaretci lazimdi
-	; ve bunu parametre olarak aliyor
-	
-	mov eax, esp          ; stack pointer'i eax kaydedicisine kopyala
-	push eax              ; sakla
-	call isr_handler      ; istisna isleyicisini cagir
-	
-	; en son olarak stack'a attigimiz deger fault_handler fonksiyonunun
-	; parametresi olan isaretcinin adresiydi yukarida bahsettigimiz gibi
-	; fonksiyonun isi bittigine gore stack'tan alalim artik.
-	pop eax
-	
-	; orjinal yada eski mi desek daha mi iyi olur bilmiyorum ama segment selektorleri
-	; stack'tan alalim.
-	pop gs
-	pop fs
-	pop es
-	pop ds
-	
-	; edi,esi,ebp,esp,ebx,edx,ecx,eax'leri stack'tan al
-	popa
-	
-	; kesme numarasi ve hata kodunu kaldir.("idt.c'yi inceleyin")
-	add esp, 8
-	
-	; iret'ten bahsetmistik. bir kesme oldugunda calismakta olan fonksiyon
-	; askiya alinir ve kesme yoneticisi cagrilir,islemci otomatik olarak kesme
-	; yoneticisinin yigitina eip, cs, eflags, esp, ss kaydedicilerini atar. eger
-	; askiya alinan fonksiyon ve kesme yoneticisi ayni ayricalik duzeyine sahip
-	; olsa bir guvenlik sikintisi cikmaz fakat askiya alinan fonksiyonun user
-	; modda olan bir fonksiyon olmasi guvenlik acigi meydana getirebilir. cunku
-	; kesme yoneticisinin isi bittiginde otomatik olarak stack'a atilan bu
-	; kaydediciler askiya alinan fonksiyonunun stack'inda da olur ve guvenlik
-	; sikintisi cikar. iret fonksiyonu atilan bu kaydedicileri stack'tan geri
-	; almamizi saglar.( iret = interrupt return)
-	iret      ; eip, cs, eflags, esp ve ss'yi geri al
-
-
-extern irq_handler
+	SAVE_REGS
+	push esp		; registers_t *regs
+	call isr_handler	; istisna isleyicisini cagir
+	add esp, 4
+	RESTORE_REGS
 
 ; irq'lar icin ortak giris
 irq_common_entry:
-  
-  	; edi,esi,ebp,esp,ebx,edx,ecx,eax'leri sakla
-	pusha
-	
-	; selektorleri sakla
-	push ds
-	push es
-	push fs
-	push gs
-	
-	; user modda cagrildiginda veri segmenti selektorleri 
-	; farkli segmentleri gosterecekleri icin onlari yukarida
-  	; stack'a attik. ve kernel mod veri segmentini tanimlayicisini
-	; ayarliyoruz.
-	mov ax, 0x10
-	mov ds, ax
-	mov es, ax
-	mov fs, ax
-	mov gs, ax
-	
-	; peki neden stack pointer'i sakladik diye dusunebilirsiniz.
-	; fault_handler fonksiyonunuzu incelediginizde onun direk
-	; registers_t yapisini almadigini goreceksiniz. bir pointer
-	; aliyor yani adresini en son kaldigimiz yer bizim registers_t
-	; yapisinin adresi olacaktir. ve adreside stack'a atiyoruz.
-	; fonksiyon cagrildiginda parametre olarak bir isaretci lazimdi
-	; ve bunu parametre olarak aliyor
-	
-	mov eax, esp          ; stack pointer'i eax kaydedicisine kopyala
-	push eax              ; sakla
-	call irq_handler      ; irq isleyicisini cagir
-	
-	; en son olarak stack'a attigimiz deger fault_handler fonksiyonunun
-	; parametresi olan isaretcinin adresiydi yukarida bahsettigimiz gibi
-	; fonksiyonun isi bittigine gore stack'tan alalim artik.
-	pop eax
-	
-	; orjinal yada eski mi desek daha mi iyi olur bilmiyorum ama segment selektorleri
-	; stack'tan alalim.
-	pop gs
-	pop fs
-	pop es
-	pop ds
-	
-	; edi,esi,ebp,esp,ebx,edx,ecx,eax'leri stack'tan al
-	popa
-	
-	; kesme numarasi ve hata kodunu kaldir.("idt.c'yi inceleyin")
-	add esp, 8
-	
-	; iret'ten bahsetmistik. bir kesme oldugunda calismakta olan fonksiyon
-	; askiya alinir ve kesme yoneticisi cagrilir,islemci otomatik olarak kesme
-	; yoneticisinin yigitina eip, cs, eflags, esp, ss kaydedicilerini atar. eger
-	; askiya alinan fonksiyon ve kesme yoneticisi ayni ayricalik duzeyine sahip
-	; olsa bir guvenlik sikintisi cikmaz fakat askiya alinan fonksiyonun user
-	; modda olan bir fonksiyon olmasi guvenlik acigi meydana getirebilir. cunku
-	; kesme yoneticisinin isi bittiginde otomatik olarak stack'a atilan bu
-	; kaydediciler askiya alinan fonksiyonunun stack'inda da olur ve guvenlik
-	; sikintisi cikar. iret fonksiyonu atilan bu kaydedicileri stack'tan geri
-	; almamizi saglar.( iret = interrupt return)
-	iret      ; eip, cs, eflags, esp ve ss'yi geri al
+	SAVE_REGS
+	push esp		; registers_t *regs
+	call irq_handler	; irq isleyicisini cagir
+	add esp, 4
+	RESTORE_REGS
+
+; timer kesmesi icin hizli yol. en sik gelen kesme oldugu icin
+; irq_common_entry'ye ziplamadan dogrudan irq_timer_handler cagrilir,
+; o da irq_handler'daki kontrolleri ve isleyici zincirini atlar.
+global _irq0
+_irq0:
+	push byte 0
+	push byte 32
+	SAVE_REGS
+	push esp
+	call irq_timer_handler
+	add esp, 4
+	RESTORE_REGS
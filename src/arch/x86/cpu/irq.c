@@ -20,6 +20,12 @@
 #include <uniq/module.h>
 #include <uniq/regs.h>
 #include <uniq/kernel.h>
+#include <uniq/apic.h>
+#include <uniq/smp.h>
+#include <uniq/irq_stat.h>
+#include <uniq/irq.h>
+#include <uniq/spin_lock.h>
+#include <uniq/errno.h>
 
 /*
  * teorik bilgiler
@@ -109,7 +115,6 @@ extern void _irq13(void);
 extern void _irq14(void);
 extern void _irq15(void);
 
-#define MAX_IRQ  			16
 #define INT_GATE_TYPE			0xE
 #define INT_PRESENT			0x80
 #define INT_GATE			INT_PRESENT | INT_GATE_TYPE	/* kesme kapisi */
@@ -126,6 +131,8 @@ extern void _irq15(void);
 #define PIC_SLAVE_COMMAND		0xA0
 #define PIC_SLAVE_DATA			0xA1
 #define PIC_EOI				0x20
+#define PIC_READ_ISR			0x0B	/* OCW3, komut portundan isr okunur */
+#define PIC_SPURIOUS_BIT		0x80	/* IRQ7/IRQ15'in isr biti */
 
 /*
  * ICW'ler
@@ -149,35 +156,144 @@ extern void _irq15(void);
 #define ICW4				ICW4_8086_MODE
 #define ICW_NULL			0x0
 
-static int_handler_t irq_handlers[MAX_IRQ] = { NULL };
+#define PIC_MASK_ALL			0xFF
+
+/* imcr, mp tablosundaki pic modundan apic moduna gecis icin */
+#define IMCR_SELECT			0x22
+#define IMCR_DATA			0x23
+#define IMCR_REG			0x70
+#define IMCR_APIC			0x01
 
 /*
- * irq_add_handler, irq isleyicisi ekler.
+ * her hattin isleyicileri tek yonlu bir zincirde tutulur. zincir
+ * irq_lock ile degistirilir, kesme isleyicisi ise kilit almadan
+ * dolasir. running, zinciri o an dolasan cpu sayisidir ve irq_free
+ * cikarilan isleyicinin artik cagrilmayacagindan emin olmak icin
+ * onu bekler.
+ */
+typedef struct{
+	irq_action_t *volatile actions;		/* isleyici zinciri */
+	volatile uint32_t running;		/* zinciri dolasan cpu sayisi */
+}irq_line_t;
+
+static irq_line_t irq_lines[MAX_IRQ];
+static spinlock_t irq_lock = SPIN_LOCK_UNLOCKED("irq");
+static bool irq_apic_mode = false;		/* kesmeler io apic'ten mi geliyor? */
+
+/*
+ * irq_request, hatta bir isleyici ekler. hat doluysa hem mevcut hem
+ * yeni isleyici IRQF_SHARED ile istemis olmalidir, aksi halde -EBUSY
+ * doner. isleyici zincirin sonuna eklenir.
  *
  * @param irq_num : irq numarasi
+ * @param action : aygita ait isleyici yapisi
  * @param handler : kesme isleyicisi
+ * @param flags : IRQF_*
+ * @param name : aygit adi
+ * @param dev : isleyiciye gonderilecek aygit verisi
  */
-void irq_add_handler(uint8_t irq_num, int_handler_t handler){
-	
+int32_t irq_request(uint8_t irq_num,irq_action_t *action,irq_func_t handler,uint32_t flags,
+									const char *name,void *dev){
+
+	irq_line_t *line;
+	irq_action_t *volatile *pos;
+	uint32_t lock_flags;
+
+	if(irq_num >= MAX_IRQ || !action || !handler)
+		return -EINVAL;
+
+	line = &irq_lines[irq_num];
+	lock_flags = spin_lock_irqsave(&irq_lock);
+
+	if(line->actions && !(line->actions->flags & flags & IRQF_SHARED)){
+		spin_unlock_irqrestore(&irq_lock,lock_flags);
+		return -EBUSY;
+	}
+
+	for(pos = &line->actions; *pos; pos = &(*pos)->next){
+		if(*pos == action){
+			spin_unlock_irqrestore(&irq_lock,lock_flags);
+			return -EEXIST;
+		}
+	}
+
+	/* alanlar yazildiktan sonra zincire baglanir, dolasan cpu yarim yapi gormez */
+	action->next = NULL;
+	action->handler = handler;
+	action->dev = dev;
+	action->name = name;
+	action->flags = flags;
+	*pos = action;
+
+	if(irq_apic_mode && line->actions == action)
+		ioapic_unmask_irq(irq_num);
+
+	spin_unlock_irqrestore(&irq_lock,lock_flags);
+
+	return 0;
+
+}
+
+/*
+ * irq_free, isleyiciyi hattan cikarir. dondugunde isleyici hicbir
+ * cpu'da calismiyordur ve action serbest birakilabilir. bu yuzden
+ * ayni hattin isleyicisi icinden cagrilmamalidir.
+ *
+ * @param irq_num : irq numarasi
+ * @param action : irq_request'e verilen isleyici yapisi
+ */
+void irq_free(uint8_t irq_num,irq_action_t *action){
+
+	irq_line_t *line;
+	irq_action_t *volatile *pos;
+	uint32_t lock_flags;
+
 	if(irq_num >= MAX_IRQ)
 		return;
-		
-	irq_handlers[irq_num] = handler;
-	
+
+	line = &irq_lines[irq_num];
+	lock_flags = spin_lock_irqsave(&irq_lock);
+
+	for(pos = &line->actions; *pos; pos = &(*pos)->next){
+		if(*pos == action){
+			/* action->next korunur, zinciri dolasan cpu devam edebilir */
+			*pos = action->next;
+			break;
+		}
+	}
+
+	if(irq_apic_mode && !line->actions)
+		ioapic_mask_irq(irq_num);
+
+	spin_unlock_irqrestore(&irq_lock,lock_flags);
+
+	while(line->running)
+		relax_cpu();
+
 }
 
 /*
- * irq_remove_handler, irq isleyicisini kaldirir.
+ * irq_action_names, hattaki isleyicilerin adlarini virgulle ayirarak
+ * tampona yazar. kilit almaz, panik sirasinda da kullanilabilir.
  *
  * @param irq_num : irq numarasi
+ * @param buf : tampon
+ * @param size : tamponun boyutu
  */
-void irq_remove_handler(uint8_t irq_num){
+size_t irq_action_names(uint8_t irq_num,char *buf,size_t size){
+
+	size_t len = 0;
+
+	buf[0] = '\0';
 
 	if(irq_num >= MAX_IRQ)
-		return;
-		
-	irq_handlers[irq_num] = NULL;
-	
+		return 0;
+
+	for(irq_action_t *action = irq_lines[irq_num].actions; action && len < size; action = action->next)
+		len += snprintf(buf + len,size - len,"%s%s",len ? "," : "",action->name ? action->name : "?");
+
+	return len < size ? len : size - 1;
+
 }
 
 /*
@@ -233,7 +349,56 @@ static void irq_remap(void){
 }
 
 /*
- * irq_eoi, PIC'lere kesme sonu sinyali gonderir.
+ * irq_enable_apic, kesmeleri pic'ten io apic'e devreder. pic'ler
+ * maskelenir, isleyicisi olan irq'lar io apic'te acilir. io apic
+ * girisleri apic_init tarafindan maskeli olarak kurulmus olmalidir.
+ *
+ * @param imcr : pic modundan imcr ile cikilmali mi?
+ */
+void irq_enable_apic(bool imcr){
+
+	uint32_t flags = irq_save();
+
+	outbyte(PIC_MASTER_DATA, PIC_MASK_ALL);
+	outbyte(PIC_SLAVE_DATA, PIC_MASK_ALL);
+
+	if(imcr){
+		outbyte(IMCR_SELECT, IMCR_REG);
+		outbyte(IMCR_DATA, IMCR_APIC);
+	}
+
+	irq_apic_mode = true;
+
+	for(uint32_t i = 0; i < MAX_IRQ; i++){
+		if(irq_lines[i].actions)
+			ioapic_unmask_irq(i);
+	}
+
+	irq_restore(flags);
+
+}
+
+/*
+ * irq_set_affinity, irq'nun hangi cpu'ya gidecegini belirler. sadece
+ * io apic kullanilirken mumkundur.
+ *
+ * @param irq_num : irq numarasi
+ * @param cpu : cpu numarasi
+ */
+bool irq_set_affinity(uint8_t irq_num,uint32_t cpu){
+
+	if(!irq_apic_mode || irq_num >= MAX_IRQ || cpu >= cpu_count || !cpus[cpu].online)
+		return false;
+
+	return ioapic_set_affinity(irq_num,cpus[cpu].apic_id);
+
+}
+
+/*
+ * irq_eoi, kesme denetleyicisine kesme sonu sinyali gonderir. apic
+ * modunda tek bir mmio yazmasi, pic modunda bir ya da iki port
+ * yazmasi gerekir. isleyiciler eoi'yi genelde irq_handler'a birakir,
+ * kendisi gonderen isleyici (timer) icin irq_handler tekrar gondermez.
  * 
  * (END OF INTERRUPT) = EOI
  *
@@ -241,6 +406,16 @@ static void irq_remap(void){
  */
 void irq_eoi(uint8_t irq_num){
 
+	irq_frame_t *frame = this_cpu()->irq_frame;
+
+	if(frame)
+		frame->eoi = true;
+
+	if(irq_apic_mode){
+		lapic_eoi();
+		return;
+	}
+
 	if (irq_num >= 8) 
 		outbyte(PIC_SLAVE_COMMAND, PIC_EOI);
 		
@@ -249,25 +424,108 @@ void irq_eoi(uint8_t irq_num){
 }
 
 /*
- * irq_handler, irq isleyicisidir.
+ * irq_spurious, pic'in sahte kesme gonderip gondermedigini kontrol eder.
+ * istek isleyici secilmeden once kalkarsa pic en dusuk oncelikli hatti
+ * (IRQ7/IRQ15) bildirir fakat isr'de o bit set edilmez. sahte IRQ7'ye
+ * eoi gonderilmez, sahte IRQ15'te ise master pic slave'in hattini
+ * gercekten gordugu icin sadece master'a eoi gonderilir.
+ *
+ * @param irq_num : irq numarasi
+ */
+static bool irq_spurious(uint8_t irq_num){
+
+	if(irq_apic_mode)
+		return false;
+
+	if(irq_num == 7){
+		outbyte(PIC_MASTER_COMMAND, PIC_READ_ISR);
+		return !(inbyte(PIC_MASTER_COMMAND) & PIC_SPURIOUS_BIT);
+	}
+
+	if(irq_num == 15){
+		outbyte(PIC_SLAVE_COMMAND, PIC_READ_ISR);
+		if(inbyte(PIC_SLAVE_COMMAND) & PIC_SPURIOUS_BIT)
+			return false;
+
+		outbyte(PIC_MASTER_COMMAND, PIC_EOI);
+		return true;
+	}
+
+	return false;
+
+}
+
+/*
+ * irq_handler, irq isleyicisidir. hattaki tum isleyiciler sirayla
+ * cagrilir, paylasilan seviye tetiklemeli hatta birden fazla aygit
+ * ayni anda kesme istemis olabilir. isleyicide gecen sure ve kesme
+ * sayisi vektor basina tutulur (uniq/irq_stat.h).
  *
  * @param regs : kaydediciler. hangi kaydedicileri icerdigini ogrenmek
  *		 icin registers_t yapisini inceleyin.
  */
 void irq_handler(registers_t *regs){
 
-	int_handler_t handler = NULL;
-	
-	if(regs->int_num > 31  && regs->int_num < 48)
-		handler = irq_handlers[regs->int_num - 32];
+	uint8_t irq_num = regs->int_num - 32;
+	irq_line_t *line;
+	irq_frame_t frame;
+	bool handled = false;
 	
-	if(!handler)
-		irq_eoi(regs->int_num - 32);
-	else
-		handler(regs);
+	if(regs->int_num < 32 || regs->int_num > 47)
+		return;
+
+	if((irq_num & 7) == 7 && irq_spurious(irq_num)){
+		irq_stat_spurious(regs->int_num);
+		return;
+	}
+
+	irq_stat_enter(&frame,regs->int_num);
+	line = &irq_lines[irq_num];
+
+	__sync_fetch_and_add(&line->running,1);
+	for(irq_action_t *action = line->actions; action; action = action->next){
+		if(action->handler(regs,action->dev) == IRQ_HANDLED)
+			handled = true;
+	}
+	__sync_fetch_and_sub(&line->running,1);
+
+	/* hicbir aygit sahiplenmedi */
+	if(!handled)
+		irq_stat_spurious(regs->int_num);
+
+	if(!frame.eoi)
+		irq_eoi(irq_num);
+
+	irq_stat_exit(&frame,regs->int_num);
 	
 }
 
+/*
+ * irq_timer_handler, irq0'in (pit ya da local apic zamanlayicisi) hizli
+ * yoludur, int.s'teki _irq0 dogrudan bunu cagirir. timer hatti
+ * paylasilmaz ve hic serbest birakilmaz, bu yuzden menzil ve sahte
+ * kesme kontrolu, zincir dolasma ve running sayaci atlanip tek isleyici
+ * cagrilir.
+ *
+ * @param regs : kaydediciler
+ */
+void irq_timer_handler(registers_t *regs){
+
+	irq_action_t *action = irq_lines[0].actions;
+	irq_frame_t frame;
+
+	irq_stat_enter(&frame,IRQ_VECTOR_BASE);
+
+	if(action)
+		action->handler(regs,action->dev);
+
+	if(!frame.eoi)
+		irq_eoi(0);
+
+	irq_stat_exit(&frame,IRQ_VECTOR_BASE);
+
+}
+
 /*
  * irq_init, irq-donanim kesmelerini baslatir.
  */
@@ -21,6 +21,8 @@
 #include <uniq/regs.h>
 #include <string.h>
 #include <uniq/kernel.h>
+#include <uniq/irq_stat.h>
+#include <uniq/div64.h>
 
 /*
  * istisna kesmeleri mesaj listesi
@@ -102,6 +104,9 @@ extern void _isr31(void);
 #define INT_GATE		INT_PRESENT | INT_GATE_TYPE	/* kesme kapisi */
 #define KERN_CODE_SEGMENT	0x8
 
+#define INT_BENCH_VECTOR	3		/* int3, bos isleyiciyle olculur */
+#define INT_BENCH_LOOPS		100000
+
 static int_handler_t isr_handlers[MAX_ISR_HANDLER] = { NULL };
 
 /*
@@ -139,6 +144,7 @@ static void isr_fault(registers_t *regs){
 	debug_print(KERN_EMERG, "Unhandled exception: [interrupt number = %u] %s", regs->int_num
 										 , fault_msglist[regs->int_num]);
 	dump_regs(regs);
+	irq_stat_dump();
 	halt_system();
 
 }
@@ -152,11 +158,16 @@ static void isr_fault(registers_t *regs){
 void isr_handler(registers_t *regs){
 	
 	int_handler_t handler = isr_handlers[regs->int_num];
+	irq_frame_t frame;
 	
-	if(!handler)
+	if(!handler){
 		isr_fault(regs);
-	else
-		handler(regs);
+		return;
+	}
+
+	irq_stat_enter(&frame,regs->int_num);
+	handler(regs);
+	irq_stat_exit(&frame,regs->int_num);
 		
 }
 
@@ -217,5 +228,49 @@ void __int_test(void){
 	int x = 0/0;
 }
 
+/*
+ * int_bench_handler, __int_bench icin bos isleyici.
+ */
+static void int_bench_handler(registers_t *regs){
+
+}
+
+/*
+ * __int_bench, bir kesmenin giris ve cikis maliyetini olcer. int3 bos
+ * bir isleyiciyle isr_common_entry ve isr_handler uzerinden doner,
+ * yani int/iret, kaydedicilerin saklanmasi, c dagitimi ve irq_stat
+ * hesabi dahildir. sonuclar kesme basina tsc cinsindendir, anlamli
+ * olmasi icin kvm altinda calistirin.
+ */
+void __int_bench(void){
+
+	int_handler_t old = isr_handlers[INT_BENCH_VECTOR];
+	uint64_t start,total,cycles,best = ~0ULL;
+	uint32_t flags = irq_save();
+
+	isr_handlers[INT_BENCH_VECTOR] = int_bench_handler;
+
+	start = rdtsc();
+	for(uint32_t i = 0; i < INT_BENCH_LOOPS; i++)
+		__asm__ volatile("int3" ::: "memory");
+	total = rdtsc() - start;
+
+	for(uint32_t i = 0; i < 1000; i++){
+		start = rdtsc();
+		__asm__ volatile("int3" ::: "memory");
+		cycles = rdtsc() - start;
+		if(cycles < best)
+			best = cycles;
+	}
+
+	isr_handlers[INT_BENCH_VECTOR] = old;
+	irq_restore(flags);
+
+	debug_print(KERN_DUMP,"int3 round trip: %llu cycles avg, %llu cycles min",
+							div_u64(total,INT_BENCH_LOOPS),best);
+	irq_stat_dump();
+
+}
+
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,554 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  MP & ACPI MADT Parser
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/mpconf.h>
+#include <string.h>
+
+/*
+ * ilk 1 MiB kernel_dir'de birebir eslendigi icin ebda ve bios rom
+ * alanlari dogrudan okunabilir. daha yukaridaki tablolar ioremap ile
+ * eslenir.
+ */
+#define BDA_EBDA_SEGMENT	0x40E		/* ebda segmentinin tutuldugu adres */
+#define BIOS_ROM_START		0xE0000
+#define BIOS_ROM_END		0x100000
+#define BASE_MEM_LAST_KIB	0x9FC00		/* 639 KiB */
+#define LOW_MEM_END		0x100000
+
+#define ACPI_RSDP_SIGNATURE	"RSD PTR "
+#define ACPI_MADT_SIGNATURE	"APIC"
+#define MP_FLOAT_SIGNATURE	"_MP_"
+#define MP_CONFIG_SIGNATURE	"PCMP"
+
+/* madt girdi tipleri */
+#define MADT_LAPIC		0
+#define MADT_IOAPIC		1
+#define MADT_IRQ_OVERRIDE	2
+#define MADT_LAPIC_ENABLED	0x1
+
+/* mp tablosu girdi tipleri */
+#define MP_PROCESSOR		0
+#define MP_BUS			1
+#define MP_IOAPIC		2
+#define MP_IOINTR		3
+#define MP_LINTR		4
+#define MP_CPU_ENABLED		0x1
+#define MP_IOAPIC_ENABLED	0x1
+#define MP_IMCR_PRESENT		0x80
+
+typedef struct{
+	char signature[8];
+	uint8_t checksum;
+	char oem_id[6];
+	uint8_t revision;
+	uint32_t rsdt_addr;
+}__packed acpi_rsdp_t;
+
+typedef struct{
+	char signature[4];
+	uint32_t length;
+	uint8_t revision;
+	uint8_t checksum;
+	char oem_id[6];
+	char oem_table_id[8];
+	uint32_t oem_revision;
+	uint32_t creator_id;
+	uint32_t creator_revision;
+}__packed acpi_header_t;
+
+typedef struct{
+	acpi_header_t header;
+	uint32_t lapic_addr;
+	uint32_t flags;
+}__packed acpi_madt_t;
+
+typedef struct{
+	uint8_t type;
+	uint8_t length;
+}__packed madt_entry_t;
+
+typedef struct{
+	madt_entry_t entry;
+	uint8_t acpi_id;
+	uint8_t apic_id;
+	uint32_t flags;
+}__packed madt_lapic_t;
+
+typedef struct{
+	madt_entry_t entry;
+	uint8_t id;
+	uint8_t reserved;
+	uint32_t addr;
+	uint32_t gsi_base;
+}__packed madt_ioapic_t;
+
+typedef struct{
+	madt_entry_t entry;
+	uint8_t bus;
+	uint8_t source;
+	uint32_t gsi;
+	uint16_t flags;
+}__packed madt_override_t;
+
+typedef struct{
+	char signature[4];
+	uint32_t config_addr;
+	uint8_t length;			/* 16 bayt cinsinden */
+	uint8_t spec_rev;
+	uint8_t checksum;
+	uint8_t feature1;		/* 0 degilse varsayilan yapilandirma */
+	uint8_t feature2;
+	uint8_t reserved[3];
+}__packed mp_float_t;
+
+typedef struct{
+	char signature[4];
+	uint16_t length;
+	uint8_t spec_rev;
+	uint8_t checksum;
+	char oem_id[8];
+	char product_id[12];
+	uint32_t oem_table;
+	uint16_t oem_size;
+	uint16_t entry_count;
+	uint32_t lapic_addr;
+	uint16_t ext_length;
+	uint8_t ext_checksum;
+	uint8_t reserved;
+}__packed mp_config_t;
+
+typedef struct{
+	uint8_t type;
+	uint8_t apic_id;
+	uint8_t apic_ver;
+	uint8_t flags;
+	uint32_t signature;
+	uint32_t features;
+	uint32_t reserved[2];
+}__packed mp_processor_t;
+
+typedef struct{
+	uint8_t type;
+	uint8_t bus_id;
+	char bus_type[6];
+}__packed mp_bus_t;
+
+typedef struct{
+	uint8_t type;
+	uint8_t id;
+	uint8_t version;
+	uint8_t flags;
+	uint32_t addr;
+}__packed mp_ioapic_t;
+
+typedef struct{
+	uint8_t type;
+	uint8_t irq_type;
+	uint16_t flags;
+	uint8_t src_bus;
+	uint8_t src_irq;
+	uint8_t dst_ioapic;
+	uint8_t dst_intin;
+}__packed mp_intr_t;
+
+mpconf_t mpconf;
+
+/*
+ * checksum_ok, tablonun baytlari toplami 0 mi?
+ *
+ * @param addr : tablo adresi
+ * @param len : uzunluk
+ */
+static bool checksum_ok(const void *addr,uint32_t len){
+
+	const uint8_t *p = (const uint8_t*)addr;
+	uint8_t sum = 0;
+
+	for(uint32_t i = 0; i < len; i++)
+		sum += p[i];
+
+	return sum == 0;
+
+}
+
+/*
+ * scan_signature, verilen alanda 16 bayt hizali imzayi arar.
+ *
+ * @param start : baslangic adresi
+ * @param len : alan uzunlugu
+ * @param sig : imza
+ * @param sig_len : imza uzunlugu
+ * @param table_len : bulunan tablonun checksum'i icin uzunluk
+ */
+static void *scan_signature(uint32_t start,uint32_t len,const char *sig,uint32_t sig_len,uint32_t table_len){
+
+	for(uint32_t addr = start; addr + table_len <= start + len; addr += 16){
+		if(!memcmp((void*)addr,sig,sig_len) && checksum_ok((void*)addr,table_len))
+			return (void*)addr;
+	}
+
+	return NULL;
+
+}
+
+/*
+ * ebda_addr, bios veri alanindan ebda adresini dondurur.
+ */
+static uint32_t ebda_addr(void){
+
+	return (uint32_t)(*(uint16_t*)BDA_EBDA_SEGMENT) << 4;
+
+}
+
+/*
+ * phys_map, ilk 1 MiB'daki adresi oldugu gibi dondurur, daha yukaridaki
+ * adresleri ioremap ile esler.
+ *
+ * @param addr : fiziksel adres
+ * @param len : uzunluk
+ */
+static void *phys_map(uint32_t addr,uint32_t len){
+
+	if(addr + len <= LOW_MEM_END)
+		return (void*)addr;
+
+	return ioremap(addr,len);
+
+}
+
+/*
+ * mpconf_add_cpu, etkin bir cpu ekler. bsp'nin hangisi oldugu
+ * smp_init'te local apic id'ye bakilarak bulunur.
+ *
+ * @param apic_id : apic id
+ */
+static void mpconf_add_cpu(uint8_t apic_id){
+
+	if(mpconf.ncpus >= MAX_CPUS){
+		debug_print(KERN_WARNING,"Too many cpus, ignoring apic id %u",apic_id);
+		return;
+	}
+
+	mpconf.apic_ids[mpconf.ncpus++] = apic_id;
+
+}
+
+/*
+ * mpconf_add_ioapic, io apic ekler.
+ *
+ * @param id : io apic id
+ * @param addr : mmio adresi
+ * @param gsi_base : ilk global sistem kesmesi
+ */
+static void mpconf_add_ioapic(uint8_t id,uint32_t addr,uint32_t gsi_base){
+
+	if(mpconf.nioapics >= MAX_IOAPICS)
+		return;
+
+	mpconf.ioapics[mpconf.nioapics].id = id;
+	mpconf.ioapics[mpconf.nioapics].addr = addr;
+	mpconf.ioapics[mpconf.nioapics].gsi_base = gsi_base;
+	mpconf.nioapics++;
+
+}
+
+/*
+ * mpconf_add_override, isa irq'sunun farkli bir gsi'ya ya da farkli
+ * polarite/tetiklemeyle baglandigini kaydeder.
+ *
+ * @param irq : isa irq
+ * @param gsi : global sistem kesmesi
+ * @param flags : polarite ve tetikleme
+ */
+static void mpconf_add_override(uint8_t irq,uint32_t gsi,uint16_t flags){
+
+	if(mpconf.noverrides >= MAX_IRQ_OVERRIDES)
+		return;
+
+	mpconf.overrides[mpconf.noverrides].irq = irq;
+	mpconf.overrides[mpconf.noverrides].gsi = gsi;
+	mpconf.overrides[mpconf.noverrides].flags = flags;
+	mpconf.noverrides++;
+
+}
+
+/*
+ * acpi_find_rsdp, rsdp'yi once ebda'nin ilk 1 KiB'inda, sonra bios
+ * rom alaninda arar.
+ */
+static acpi_rsdp_t *acpi_find_rsdp(void){
+
+	acpi_rsdp_t *rsdp = NULL;
+	uint32_t ebda = ebda_addr();
+
+	if(ebda)
+		rsdp = scan_signature(ebda,1024,ACPI_RSDP_SIGNATURE,8,sizeof(acpi_rsdp_t));
+
+	if(!rsdp)
+		rsdp = scan_signature(BIOS_ROM_START,BIOS_ROM_END - BIOS_ROM_START,
+				      ACPI_RSDP_SIGNATURE,8,sizeof(acpi_rsdp_t));
+
+	return rsdp;
+
+}
+
+/*
+ * acpi_map_table, acpi tablosunu once basligi, sonra tam uzunluguyla
+ * esler ve checksum'ini kontrol eder.
+ *
+ * @param addr : fiziksel adres
+ */
+static acpi_header_t *acpi_map_table(uint32_t addr){
+
+	acpi_header_t *header = phys_map(addr,sizeof(acpi_header_t));
+
+	if(!header)
+		return NULL;
+
+	header = phys_map(addr,header->length);
+	if(!header || !checksum_ok(header,header->length))
+		return NULL;
+
+	return header;
+
+}
+
+/*
+ * acpi_parse_madt, madt girdilerini okur.
+ *
+ * @param madt : madt
+ */
+static void acpi_parse_madt(acpi_madt_t *madt){
+
+	uint8_t *ptr = (uint8_t*)madt + sizeof(acpi_madt_t);
+	uint8_t *end = (uint8_t*)madt + madt->header.length;
+
+	mpconf.lapic_addr = madt->lapic_addr;
+
+	for(; ptr + sizeof(madt_entry_t) <= end; ptr += ((madt_entry_t*)ptr)->length){
+
+		madt_entry_t *entry = (madt_entry_t*)ptr;
+
+		if(entry->length < sizeof(madt_entry_t))
+			break;
+
+		switch(entry->type){
+			case MADT_LAPIC:{
+				madt_lapic_t *lapic = (madt_lapic_t*)entry;
+
+				if(lapic->flags & MADT_LAPIC_ENABLED)
+					mpconf_add_cpu(lapic->apic_id);
+				break;
+			}
+			case MADT_IOAPIC:{
+				madt_ioapic_t *ioapic = (madt_ioapic_t*)entry;
+
+				mpconf_add_ioapic(ioapic->id,ioapic->addr,ioapic->gsi_base);
+				break;
+			}
+			case MADT_IRQ_OVERRIDE:{
+				madt_override_t *over = (madt_override_t*)entry;
+
+				mpconf_add_override(over->source,over->gsi,over->flags);
+				break;
+			}
+		}
+
+	}
+
+}
+
+/*
+ * acpi_detect, rsdt'de madt'yi bulup okur.
+ */
+static bool acpi_detect(void){
+
+	acpi_rsdp_t *rsdp = acpi_find_rsdp();
+	acpi_header_t *rsdt;
+	uint32_t nentries;
+
+	if(!rsdp)
+		return false;
+
+	rsdt = acpi_map_table(rsdp->rsdt_addr);
+	if(!rsdt)
+		return false;
+
+	nentries = (rsdt->length - sizeof(acpi_header_t)) / sizeof(uint32_t);
+
+	for(uint32_t i = 0; i < nentries; i++){
+
+		uint32_t addr = ((uint32_t*)((uint8_t*)rsdt + sizeof(acpi_header_t)))[i];
+		acpi_header_t *table = acpi_map_table(addr);
+
+		if(!table || memcmp(table->signature,ACPI_MADT_SIGNATURE,4))
+			continue;
+
+		acpi_parse_madt((acpi_madt_t*)table);
+		mpconf.source = "acpi";
+
+		return mpconf.ncpus > 0;
+
+	}
+
+	return false;
+
+}
+
+/*
+ * mp_find_float, mp floating pointer yapisini intel mp spec'teki
+ * sirayla arar: ebda'nin ilk 1 KiB'i, temel bellegin son 1 KiB'i,
+ * bios rom alani.
+ */
+static mp_float_t *mp_find_float(void){
+
+	mp_float_t *mpf = NULL;
+	uint32_t ebda = ebda_addr();
+
+	if(ebda)
+		mpf = scan_signature(ebda,1024,MP_FLOAT_SIGNATURE,4,sizeof(mp_float_t));
+
+	if(!mpf)
+		mpf = scan_signature(BASE_MEM_LAST_KIB,1024,MP_FLOAT_SIGNATURE,4,sizeof(mp_float_t));
+
+	if(!mpf)
+		mpf = scan_signature(BIOS_ROM_START,BIOS_ROM_END - BIOS_ROM_START,
+				     MP_FLOAT_SIGNATURE,4,sizeof(mp_float_t));
+
+	return mpf;
+
+}
+
+/*
+ * mp_detect, mp yapilandirma tablosunu okur. varsayilan yapilandirmalar
+ * (feature1 != 0) desteklenmez.
+ */
+static bool mp_detect(void){
+
+	mp_float_t *mpf = mp_find_float();
+	mp_config_t *conf;
+	uint8_t *ptr;
+	int32_t isa_bus = -1;
+
+	if(!mpf || !mpf->config_addr || mpf->feature1)
+		return false;
+
+	conf = phys_map(mpf->config_addr,sizeof(mp_config_t));
+	if(!conf || memcmp(conf->signature,MP_CONFIG_SIGNATURE,4))
+		return false;
+
+	conf = phys_map(mpf->config_addr,conf->length);
+	if(!conf || !checksum_ok(conf,conf->length))
+		return false;
+
+	mpconf.lapic_addr = conf->lapic_addr;
+	mpconf.imcr = !!(mpf->feature2 & MP_IMCR_PRESENT);
+
+	ptr = (uint8_t*)conf + sizeof(mp_config_t);
+	for(uint32_t i = 0; i < conf->entry_count; i++){
+
+		switch(*ptr){
+			case MP_PROCESSOR:{
+				mp_processor_t *cpu = (mp_processor_t*)ptr;
+
+				if(cpu->flags & MP_CPU_ENABLED)
+					mpconf_add_cpu(cpu->apic_id);
+				ptr += sizeof(mp_processor_t);
+				break;
+			}
+			case MP_BUS:{
+				mp_bus_t *bus = (mp_bus_t*)ptr;
+
+				if(!memcmp(bus->bus_type,"ISA",3))
+					isa_bus = bus->bus_id;
+				ptr += sizeof(mp_bus_t);
+				break;
+			}
+			case MP_IOAPIC:{
+				mp_ioapic_t *ioapic = (mp_ioapic_t*)ptr;
+
+				/*
+				 * mp tablosu gsi tabani vermez, io apic'ler
+				 * 24'er girisli kabul edilir.
+				 */
+				if(ioapic->flags & MP_IOAPIC_ENABLED)
+					mpconf_add_ioapic(ioapic->id,ioapic->addr,mpconf.nioapics * 24);
+				ptr += sizeof(mp_ioapic_t);
+				break;
+			}
+			case MP_IOINTR:{
+				mp_intr_t *intr = (mp_intr_t*)ptr;
+
+				/* isa irq'su farkli bir pine bagliysa kaydet */
+				if(intr->src_bus == isa_bus && (intr->src_irq != intr->dst_intin || intr->flags))
+					mpconf_add_override(intr->src_irq,intr->dst_intin,intr->flags);
+				ptr += sizeof(mp_intr_t);
+				break;
+			}
+			case MP_LINTR:
+				ptr += sizeof(mp_intr_t);
+				break;
+			default:
+				/* bilinmeyen girdi, uzunlugu bilinmedigi icin dur */
+				i = conf->entry_count;
+				break;
+		}
+
+	}
+
+	mpconf.source = "mp";
+
+	return mpconf.ncpus > 0;
+
+}
+
+/*
+ * mpconf_detect, islemcileri ve kesme denetleyicilerini once acpi
+ * madt'den, bulunamazsa mp tablosundan okur. ikisi de yoksa false
+ * doner ve sistem tek cpu'lu kabul edilir.
+ */
+bool mpconf_detect(void){
+
+	memset(&mpconf,0,sizeof(mpconf_t));
+
+	if(!acpi_detect()){
+		memset(&mpconf,0,sizeof(mpconf_t));
+		if(!mp_detect()){
+			memset(&mpconf,0,sizeof(mpconf_t));
+			debug_print(KERN_INFO,"No MP or ACPI MADT table, uniprocessor mode.");
+			return false;
+		}
+	}
+
+	debug_print(KERN_INFO,"SMP config from %s: %u cpu(s), %u io apic(s), local apic at 0x%08X",
+							mpconf.source,
+							mpconf.ncpus,
+							mpconf.nioapics,
+							mpconf.lapic_addr);
+
+	return true;
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,160 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  SMP
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/smp.h>
+#include <uniq/mpconf.h>
+#include <uniq/apic.h>
+#include <uniq/clocksource.h>
+#include <uniq/cpuid.h>
+#include <string.h>
+
+#define TRAMPOLINE_ADDR		0x8000		/* trampoline.s ile ayni olmali */
+#define AP_BOOT_TIMEOUT_MS	100
+
+/*
+ * trampoline.s sembolleri. parametreler kopyadaki yerlerine yazilir.
+ */
+extern uint8_t trampoline_start[];
+extern uint8_t trampoline_end[];
+extern uint8_t trampoline_cr3[];
+extern uint8_t trampoline_stack[];
+extern uint8_t trampoline_cpu[];
+extern uint8_t trampoline_entry[];
+
+#define trampoline_param(sym) \
+	(*(volatile uint32_t*)(TRAMPOLINE_ADDR + ((uint32_t)(sym) - (uint32_t)trampoline_start)))
+
+extern page_dir_t *kernel_dir;
+
+cpu_t cpus[MAX_CPUS];
+uint32_t cpu_count = 1;
+volatile uint32_t cpu_online = 1;
+
+/*
+ * ap_main, ap'ler trampoline'dan sonra buraya gelir. zamanlayici henuz
+ * tek cpu icin yazildigi icin ap'ler surec calistirmaz, kesme gelene
+ * kadar uyurlar.
+ *
+ * @param cpu : cpu
+ */
+static __noreturn void ap_main(cpu_t *cpu){
+
+	gdt_init_cpu(cpu);
+	idt_load_cpu();
+	lapic_enable();
+	cpu_enable_sse();
+
+	cpu->online = 1;
+	__sync_fetch_and_add(&cpu_online,1);
+
+	for(;;)
+		safe_halt();
+
+}
+
+/*
+ * smp_boot_ap, ap'yi INIT-SIPI-SIPI dizisiyle baslatir ve calismaya
+ * baslamasini bekler.
+ *
+ * @param cpu : cpu
+ */
+static bool smp_boot_ap(cpu_t *cpu){
+
+	trampoline_param(trampoline_stack) = cpu->stack;
+	trampoline_param(trampoline_cpu) = (uint32_t)cpu;
+
+	lapic_send_ipi(cpu->apic_id,ICR_INIT | ICR_ASSERT | ICR_LEVEL);
+	udelay(10000);
+
+	for(uint32_t i = 0; i < 2 && !cpu->online; i++){
+		lapic_send_ipi(cpu->apic_id,ICR_STARTUP | (TRAMPOLINE_ADDR >> 12));
+		udelay(200);
+	}
+
+	for(uint32_t ms = 0; ms < AP_BOOT_TIMEOUT_MS && !cpu->online; ms++)
+		udelay(1000);
+
+	return cpu->online;
+
+}
+
+/*
+ * smp_init, firmware tablolarindaki ap'leri baslatir. tablolar ya da
+ * local apic yoksa tek cpu ile devam edilir.
+ */
+void smp_init(void){
+
+	uint32_t bsp_apic_id;
+
+	if(!mpconf_detect() || !lapic_init())
+		return;
+
+	lapic_enable();
+	bsp_apic_id = lapic_id();
+	cpus[0].apic_id = bsp_apic_id;
+
+	if(mpconf.ncpus < 2)
+		return;
+
+	memcpy((void*)TRAMPOLINE_ADDR,trampoline_start,trampoline_end - trampoline_start);
+	trampoline_param(trampoline_cr3) = kernel_dir->physical_addr;
+	trampoline_param(trampoline_entry) = (uint32_t)ap_main;
+
+	for(uint32_t i = 0; i < mpconf.ncpus && cpu_count < MAX_CPUS; i++){
+
+		cpu_t *cpu = &cpus[cpu_count];
+		void *stack;
+
+		if(mpconf.apic_ids[i] == bsp_apic_id)
+			continue;
+
+		stack = malloc(CPU_STACK_SIZE);
+		if(!stack)
+			break;
+
+		memset(cpu,0,sizeof(cpu_t));
+		cpu->self = cpu;
+		cpu->id = cpu_count;
+		cpu->apic_id = mpconf.apic_ids[i];
+		cpu->stack = (uint32_t)stack + CPU_STACK_SIZE;
+
+		/*
+		 * gec kalkan bir ap trampoline parametrelerini ve stack'i
+		 * kullanmaya devam edebilir, bu yuzden stack serbest
+		 * birakilmaz ve diger ap'ler baslatilmaz.
+		 */
+		if(!smp_boot_ap(cpu)){
+			debug_print(KERN_WARNING,"CPU with apic id %u did not start.",cpu->apic_id);
+			break;
+		}
+
+		cpu_count++;
+
+	}
+
+	debug_print(KERN_INFO,"SMP: %u cpu(s) online.",cpu_online);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,94 @@
+;
+;  Copyright(C) 2014 Codnect Team
+;  Copyright(C) 2014 Burak Köken
+;
+;  This file is part of Uniq.
+;  
+;  Uniq is free software: you can redistribute it and/or modify it under the
+;  terms of the GNU General Public License as published by the Free Software
+;  Foundation, version 2 of the License.
+;
+;  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+;  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+;  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+;  details.
+;
+;  You should have received a copy of the GNU General Public License along
+;  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+BITS 16
+
+; ap baslatma kodu. bsp bu kodu TRAMPOLINE_ADDR'e kopyalar ve INIT-SIPI
+; ile ap'leri buradan gercek modda baslatir. kod kernel'e bagli adreste
+; degil kopyalandigi adreste calistigi icin tum adresler TRAMP ile
+; cevrilir. parametreler (cr3, stack, cpu, entry) kopyaya yazilir.
+
+TRAMPOLINE_ADDR		equ	0x8000
+%define TRAMP(x)	((x) - trampoline_start + TRAMPOLINE_ADDR)
+
+global trampoline_start
+global trampoline_end
+global trampoline_cr3
+global trampoline_stack
+global trampoline_cpu
+global trampoline_entry
+
+SECTION .text
+
+trampoline_start:
+	cli
+	cld
+	xor ax, ax
+	mov ds, ax
+
+	; gecici gdt ile korumali moda gec
+	lgdt [TRAMP(trampoline_gdt_ptr)]
+	mov eax, cr0
+	or eax, 0x1
+	mov cr0, eax
+	jmp dword 0x08:TRAMP(trampoline_pmode)
+
+BITS 32
+
+trampoline_pmode:
+	mov ax, 0x10
+	mov ds, ax
+	mov es, ax
+	mov fs, ax
+	mov gs, ax
+	mov ss, ax
+
+	; kernel sayfa dizini ile sayfalamayi ac
+	mov eax, [TRAMP(trampoline_cr3)]
+	mov cr3, eax
+	mov eax, cr0
+	or eax, 0x80000000
+	mov cr0, eax
+
+	; ap'nin kendi stack'i, ap_main(cpu)
+	mov esp, [TRAMP(trampoline_stack)]
+	push dword [TRAMP(trampoline_cpu)]
+	mov eax, [TRAMP(trampoline_entry)]
+	call eax
+
+.hang:
+	cli
+	hlt
+	jmp .hang
+
+align 8
+trampoline_gdt:
+	dq 0x0000000000000000		; null
+	dq 0x00CF9A000000FFFF		; kod segmenti
+	dq 0x00CF92000000FFFF		; veri segmenti
+trampoline_gdt_ptr:
+	dw 23
+	dd TRAMP(trampoline_gdt)
+
+trampoline_cr3:		dd 0
+trampoline_stack:	dd 0
+trampoline_cpu:		dd 0
+trampoline_entry:	dd 0
+
+trampoline_end:
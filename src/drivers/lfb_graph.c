@@ -15,33 +15,515 @@
  *
  *  You should have received a copy of the GNU General Public License along
  *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Linear Framebuffer
  */
- 
+
 #include <uniq/module.h>
 #include <uniq/types.h>
 #include <uniq/multiboot.h>
+#include <uniq/kernel.h>
+#include <uniq/klog.h>
+#include <uniq/timer.h>
+#include <uniq/clocksource.h>
+#include <uniq/div64.h>
+#include <drivers/lfb_graph.h>
+#include <mm/heap.h>
+#include <string.h>
+
+#define VBE_MODE_LINEAR		0x80		/* mod dogrusal lfb destekliyor */
+#define VBE_MODEL_DIRECT	6		/* direct color */
+#define LFB_BENCH_FRAMES	64
 
 /*
- * dump_vbe_info,
+ * cizimler once ram'deki arka tampona (back) yapilir, degisen bolge
+ * dirty dikdortgeninde biriktirilir. lfb_flush yalnizca bu bolgeyi
+ * satir satir vram'e kopyalar. vram'den hic okunmaz, vram okumasi
+ * cogu kartta cok yavastir.
+ */
+static struct{
+	vbe_info_t vbe;			/* onyukleyiciden kopyalanan mod bilgisi */
+	bool found;			/* onyukleyici vbe bilgisi verdi */
+	bool ready;
+	uint32_t *vram;			/* eslenmis lfb */
+	uint32_t *back;			/* arka tampon, width * height piksel */
+	uint32_t width,height;
+	uint32_t pitch;			/* vram satir uzunlugu (piksel) */
+	lfb_rect_t dirty;		/* vram'e yazilmamis bolge, bossa x1 = 0 */
+
+	/* konsol */
+	uint32_t cols,rows;		/* karakter cinsinden boyut */
+	uint32_t col;
+	int32_t row;
+	bool deferred;			/* flush tick'e ertelenir */
+	ktimer_t flush_timer;
+}lfb;
+
+static void lfb_klog_write(const klog_record_t *record);
+
+static klog_sink_t lfb_sink = {
+	.name = "lfb",
+	.write = lfb_klog_write,
+	.panic = lfb_panic,
+#ifdef KDEBUG_DEFAULT
+	.level = KERN_INFO,
+#else  /* KDEBUG_OOPS */
+	.level = KERN_NOTICE,
+#endif
+};
+
+/*
+ * dump_vbe_info, vbe mod bilgisini basar.
  *
- * @param vbe_info : 
+ * @param vbe_info : vbe mod bilgisi
  */
 void dump_vbe_info(vbe_info_t *vbe_info){
- 
 
- 
+	debug_print(KERN_DUMP,"vbe mode : %ux%ux%u, pitch : %u byte, lfb : 0x%08X",vbe_info->Xres,vbe_info->Yres,
+										    vbe_info->bpp,vbe_info->pitch,
+										    vbe_info->physbase);
+	debug_print(KERN_DUMP,"attributes : 0x%04X, memory model : %u, rgb : %u:%u %u:%u %u:%u",vbe_info->attributes,
+				vbe_info->memory_model,vbe_info->red_mask,vbe_info->red_position,
+				vbe_info->green_mask,vbe_info->green_position,
+				vbe_info->blue_mask,vbe_info->blue_position);
+
+}
+
+/*
+ * lfb_graph_probe, onyukleyicinin verdigi vbe mod bilgisini saklar.
+ * bilgi dusuk bellekte durdugu icin sayfalamadan once cagrilmalidir.
+ *
+ * @param mboot_info : multiboot bilgisi
+ */
+void lfb_graph_probe(mboot_info_t *mboot_info){
+
+	if(!(mboot_info->flags & MULTIBOOT_FLAG_VBE) || !mboot_info->vbe_mode_info)
+		return;
+
+	memcpy(&lfb.vbe,(void*)mboot_info->vbe_mode_info,sizeof(vbe_info_t));
+	lfb.found = true;
+
+}
+
+/*
+ * lfb_fill32, n pikseli ayni renkle doldurur (rep stosl).
+ */
+static inline void lfb_fill32(uint32_t *dst,uint32_t color,uint32_t n){
+
+	__asm__ volatile("rep stosl" : "+D"(dst), "+c"(n) : "a"(color) : "memory");
+
+}
+
+/*
+ * lfb_mark, bolgeyi vram'e yazilacaklara ekler.
+ */
+static void lfb_mark(uint32_t x0,uint32_t y0,uint32_t x1,uint32_t y1){
+
+	uint32_t flags = irq_save();
+
+	if(!lfb.dirty.x1){
+		lfb.dirty.x0 = x0;
+		lfb.dirty.y0 = y0;
+		lfb.dirty.x1 = x1;
+		lfb.dirty.y1 = y1;
+	}
+	else{
+		if(x0 < lfb.dirty.x0)
+			lfb.dirty.x0 = x0;
+		if(y0 < lfb.dirty.y0)
+			lfb.dirty.y0 = y0;
+		if(x1 > lfb.dirty.x1)
+			lfb.dirty.x1 = x1;
+		if(y1 > lfb.dirty.y1)
+			lfb.dirty.y1 = y1;
+	}
+
+	irq_restore(flags);
+
+}
+
+/*
+ * lfb_clip, dikdortgeni ekrana sigacak sekilde kirpar. ekranin
+ * tamamen disindaysa 0 dondurur.
+ */
+static bool lfb_clip(uint32_t x,uint32_t y,uint32_t *w,uint32_t *h){
+
+	if(!lfb.ready || x >= lfb.width || y >= lfb.height || !*w || !*h)
+		return false;
+
+	if(*w > lfb.width - x)
+		*w = lfb.width - x;
+	if(*h > lfb.height - y)
+		*h = lfb.height - y;
+
+	return true;
+
+}
+
+/*
+ * lfb_fill_rect, dikdortgeni verilen renkle doldurur.
+ *
+ * @param x : sol ust kose x
+ * @param y : sol ust kose y
+ * @param w : genislik
+ * @param h : yukseklik
+ * @param color : 0x00RRGGBB
+ */
+void lfb_fill_rect(uint32_t x,uint32_t y,uint32_t w,uint32_t h,uint32_t color){
+
+	if(!lfb_clip(x,y,&w,&h))
+		return;
+
+	uint32_t *dst = lfb.back + y * lfb.width + x;
+
+	/* tam satirlar arka tamponda bitisiktir, tek seferde doldurulur */
+	if(w == lfb.width)
+		lfb_fill32(dst,color,w * h);
+	else
+		for(uint32_t i = 0; i < h; i++, dst += lfb.width)
+			lfb_fill32(dst,color,w);
+
+	lfb_mark(x,y,x + w,y + h);
+
+}
+
+/*
+ * lfb_blit, piksel dizisini arka tampona kopyalar. satirlar memcpy
+ * ile kopyalanir, buyuk satirlarda sse2 kullanilir.
+ *
+ * @param x : hedef x
+ * @param y : hedef y
+ * @param w : genislik
+ * @param h : yukseklik
+ * @param src : kaynak pikseller
+ * @param src_pitch : kaynak satir uzunlugu (piksel)
+ */
+void lfb_blit(uint32_t x,uint32_t y,uint32_t w,uint32_t h,const uint32_t *src,uint32_t src_pitch){
+
+	if(!src || !lfb_clip(x,y,&w,&h))
+		return;
+
+	uint32_t *dst = lfb.back + y * lfb.width + x;
+
+	for(uint32_t i = 0; i < h; i++, dst += lfb.width, src += src_pitch)
+		memcpy(dst,src,w * sizeof(uint32_t));
+
+	lfb_mark(x,y,x + w,y + h);
+
+}
+
+/*
+ * lfb_draw_char, karakteri 8x8 font ile arka tampona cizer.
+ *
+ * @param x : sol ust kose x
+ * @param y : sol ust kose y
+ * @param c : karakter
+ * @param fg : yazi rengi
+ * @param bg : arkaplan rengi
+ */
+void lfb_draw_char(uint32_t x,uint32_t y,char c,uint32_t fg,uint32_t bg){
+
+	if(!lfb.ready || x + LFB_FONT_WIDTH > lfb.width || y + LFB_FONT_HEIGHT > lfb.height)
+		return;
+
+	uint8_t index = (uint8_t)c - LFB_FONT_FIRST;
+	const uint8_t *glyph = font8x8[index < LFB_FONT_GLYPHS ? index : '?' - LFB_FONT_FIRST];
+	uint32_t *dst = lfb.back + y * lfb.width + x;
+
+	for(uint32_t row = 0; row < LFB_FONT_HEIGHT; row++, dst += lfb.width){
+		uint8_t bits = glyph[row];
+
+		for(uint32_t i = 0; i < LFB_FONT_WIDTH; i++)
+			dst[i] = (bits & (1 << i)) ? fg : bg;
+	}
+
+	lfb_mark(x,y,x + LFB_FONT_WIDTH,y + LFB_FONT_HEIGHT);
+
+}
+
+/*
+ * lfb_flush, arka tampondaki degisen bolgeyi vram'e yazar. bolge
+ * kesmeler kapaliyken alinip sifirlanir, kopyalama kesmeler acikken
+ * yapilir. bu sirada yapilan cizimler bir sonraki flush'a kalir.
+ */
+void lfb_flush(void){
+
+	uint32_t flags = irq_save();
+	lfb_rect_t r = lfb.dirty;
+
+	lfb.dirty.x1 = 0;
+	irq_restore(flags);
+
+	if(!lfb.ready || !r.x1)
+		return;
+
+	uint32_t w = r.x1 - r.x0;
+	uint32_t *src = lfb.back + r.y0 * lfb.width + r.x0;
+	uint32_t *dst = lfb.vram + r.y0 * lfb.pitch + r.x0;
+
+	if(w == lfb.width && lfb.pitch == lfb.width)
+		memcpy(dst,src,w * (r.y1 - r.y0) * sizeof(uint32_t));
+	else
+		for(uint32_t y = r.y0; y < r.y1; y++, src += lfb.width, dst += lfb.pitch)
+			memcpy(dst,src,w * sizeof(uint32_t));
+
+}
+
+static void lfb_flush_timer_func(void *data){
+
+	lfb_flush();
+
+}
+
+/*
+ * lfb_commit, konsol degisikliklerini ekrana yansitir. vga konsolu
+ * gibi bir tick icindeki tum ciktilar tek seferde basilir.
+ */
+static void lfb_commit(void){
+
+	if(!lfb.deferred)
+		lfb_flush();
+	else if(!ktimer_pending(&lfb.flush_timer))
+		ktimer_add(&lfb.flush_timer,timer_ticks + 1);
+
+}
+
+/*
+ * lfb_console_step, karakterin imleci nasil ilerlettigini hesaplar.
+ * cizim ve kaydirma hesabi ayni fonksiyonu kullanir.
+ */
+static inline void lfb_console_step(char c,uint32_t *col,int32_t *row){
+
+	switch(c){
+		case '\n':
+			*col = 0;
+			(*row)++;
+			return;
+		case '\r':
+			*col = 0;
+			return;
+		case '\t':
+			*col = (*col + 8) & ~7;
+			break;
+		case '\b':
+			if(*col)
+				(*col)--;
+			return;
+		default:
+			(*col)++;
+			break;
+	}
+
+	if(*col >= lfb.cols){
+		*col = 0;
+		(*row)++;
+	}
+
 }
 
 /*
- * lfb_graph_init,
+ * lfb_console_scroll, konsolu n satir yukari kaydirir.
+ */
+static void lfb_console_scroll(uint32_t n){
+
+	uint32_t line = LFB_FONT_HEIGHT * lfb.width;	/* bir yazi satiri (piksel) */
+
+	if(n > lfb.rows)
+		n = lfb.rows;
+
+	memmove(lfb.back,lfb.back + n * line,(lfb.rows - n) * line * sizeof(uint32_t));
+	lfb_fill32(lfb.back + (lfb.rows - n) * line,LFB_COLOR_BG,n * line);
+	lfb_mark(0,0,lfb.width,lfb.rows * LFB_FONT_HEIGHT);
+
+}
+
+/*
+ * lfb_console_write, diziyi konsola yazar. once dizinin kac satir
+ * kaydirma gerektirdigi hesaplanir ve arka tampon bir kere kaydirilir,
+ * ekrandan tasacak satirlar hic cizilmez.
  *
- * @param width :
- * @param height :
+ * @param s : karakter dizisi
+ * @param len : uzunluk
+ */
+void lfb_console_write(const char *s,uint32_t len){
+
+	if(!lfb.ready)
+		return;
+
+	uint32_t flags = irq_save();
+	uint32_t col = lfb.col;
+	int32_t row = lfb.row;
+
+	for(uint32_t i = 0; i < len; i++)
+		lfb_console_step(s[i],&col,&row);
+
+	if(row >= (int32_t)lfb.rows){
+		uint32_t n = row - lfb.rows + 1;
+
+		lfb_console_scroll(n);
+		lfb.row -= n;
+	}
+
+	for(uint32_t i = 0; i < len; i++){
+		char c = s[i];
+
+		if(lfb.row >= 0 && (uint8_t)c >= LFB_FONT_FIRST)
+			lfb_draw_char(lfb.col * LFB_FONT_WIDTH,lfb.row * LFB_FONT_HEIGHT,c,LFB_COLOR_FG,LFB_COLOR_BG);
+
+		lfb_console_step(c,&lfb.col,&lfb.row);
+	}
+
+	lfb_commit();
+	irq_restore(flags);
+
+}
+
+static void lfb_klog_write(const klog_record_t *record){
+
+	char line[KLOG_LINE_SIZE];
+
+	lfb_console_write(line,klog_format(record,line,sizeof(line)));
+
+}
+
+/*
+ * lfb_panic, sistem durmadan once cagrilir. bekleyen cizimler hemen
+ * basilir, sonraki ciktilar beklemeden vram'e yazilir.
+ */
+void lfb_panic(void){
+
+	lfb.deferred = false;
+	lfb_flush();
+
+}
+
+/*
+ * lfb_graph_init, onyukleyicinin kurdugu grafik modunu kullanima
+ * hazirlar: lfb'yi esler, arka tamponu ayirir ve konsolu log cikisi
+ * olarak ekler. yalnizca 32 bit direct color modlar desteklenir.
+ * sayfalama ve heap hazir olduktan sonra cagrilmalidir.
  */
-void lfb_graph_init(uint16_t width,uint16_t height){
- 
+bool lfb_graph_init(void){
+
+	vbe_info_t *vbe = &lfb.vbe;
+
+	if(!lfb.found || lfb.ready)
+		return lfb.ready;
+
+	dump_vbe_info(vbe);
+
+	if(!(vbe->attributes & VBE_MODE_LINEAR) || vbe->memory_model != VBE_MODEL_DIRECT ||
+	   vbe->bpp != LFB_BPP || !vbe->physbase || vbe->pitch % sizeof(uint32_t) ||
+	   !vbe->Xres || vbe->Xres > LFB_MAX_WIDTH || !vbe->Yres || vbe->Yres > LFB_MAX_HEIGHT){
+		debug_print(KERN_WARNING,"lfb: unsupported vbe mode %ux%ux%u",vbe->Xres,vbe->Yres,vbe->bpp);
+		return false;
+	}
+
+	lfb.width = vbe->Xres;
+	lfb.height = vbe->Yres;
+	lfb.pitch = vbe->pitch / sizeof(uint32_t);
+
+	lfb.vram = ioremap(vbe->physbase,vbe->pitch * lfb.height);
+	if(!lfb.vram){
+		debug_print(KERN_WARNING,"lfb: can't map the framebuffer at 0x%08X",vbe->physbase);
+		return false;
+	}
+
+	lfb.back = (uint32_t*)kmalloc(lfb.width * lfb.height * sizeof(uint32_t));
+	if(!lfb.back){
+		debug_print(KERN_WARNING,"lfb: can't allocate the %ux%u back buffer",lfb.width,lfb.height);
+		return false;
+	}
+
+	lfb.cols = lfb.width / LFB_FONT_WIDTH;
+	lfb.rows = lfb.height / LFB_FONT_HEIGHT;
+	lfb.col = lfb.row = 0;
+	lfb.ready = true;
+
+	lfb_fill_rect(0,0,lfb.width,lfb.height,LFB_COLOR_BG);
+	lfb_flush();
+
+	ktimer_setup(&lfb.flush_timer,lfb_flush_timer_func,NULL);
+	lfb.deferred = true;
+
+	klog_register_sink(&lfb_sink);
+
+	debug_print(KERN_INFO,"lfb: %ux%u at 0x%08X, %ux%u console",lfb.width,lfb.height,vbe->physbase,
+									lfb.cols,lfb.rows);
+
+	return true;
+
+}
+
+bool lfb_graph_ready(void){
+
+	return lfb.ready;
+
+}
+
+uint32_t lfb_width(void){
+
+	return lfb.width;
+
+}
+
+uint32_t lfb_height(void){
+
+	return lfb.height;
+
+}
+
+/*
+ * lfb_bench_fps, baslangictan bu yana gecen sureye gore saniyedeki
+ * kare sayisini dondurur.
+ */
+static uint32_t lfb_bench_fps(uint64_t start_ns,uint32_t frames){
+
+	uint32_t usec = (uint32_t)div_u64(clocksource_read_ns() - start_ns,1000);
+
+	return usec ? (uint32_t)div_u64((uint64_t)frames * 1000000,usec) : 0;
+
+}
+
+/*
+ * __lfb_bench, tam ekran doldurma, tam ekran yazi ve konsol kaydirma
+ * icin saniyedeki kare sayisini olcer. her kare vram'e basilir.
+ */
+void __lfb_bench(void){
+
+	uint64_t start;
+	uint32_t fill_fps,text_fps,scroll_fps;
+
+	if(!lfb.ready)
+		return;
+
+	start = clocksource_read_ns();
+	for(uint32_t i = 0; i < LFB_BENCH_FRAMES; i++){
+		lfb_fill_rect(0,0,lfb.width,lfb.height,i * 0x00040404);
+		lfb_flush();
+	}
+	fill_fps = lfb_bench_fps(start,LFB_BENCH_FRAMES);
+
+	start = clocksource_read_ns();
+	for(uint32_t i = 0; i < LFB_BENCH_FRAMES; i++){
+		for(uint32_t y = 0; y < lfb.rows; y++)
+			for(uint32_t x = 0; x < lfb.cols; x++)
+				lfb_draw_char(x * LFB_FONT_WIDTH,y * LFB_FONT_HEIGHT,LFB_FONT_FIRST + (x + y + i) % LFB_FONT_GLYPHS,
+					      LFB_COLOR_FG,LFB_COLOR_BG);
+		lfb_flush();
+	}
+	text_fps = lfb_bench_fps(start,LFB_BENCH_FRAMES);
+
+	start = clocksource_read_ns();
+	for(uint32_t i = 0; i < LFB_BENCH_FRAMES; i++){
+		lfb_console_write("lfb scroll bench\n",17);
+		lfb_flush();
+	}
+	scroll_fps = lfb_bench_fps(start,LFB_BENCH_FRAMES);
+
+	debug_print(KERN_DUMP,"lfb %ux%u : fill %u fps, text %u fps, scroll %u fps",lfb.width,lfb.height,
+									     fill_fps,text_fps,scroll_fps);
 
- 
 }
 
 MODULE_AUTHOR("Burak Köken");
@@ -21,16 +21,13 @@
  
 #include <uniq/module.h>
 #include <uniq/kernel.h>
+#include <uniq/timer.h>
 
 #define TIMER_IRQ_NUM	0
 #define PIT_CHANNEL0_DATA	0x40	/* veri portu - timer icin */
 #define PIT_CHANNEL1_DATA 	0x41	/* veri portu - dinamik ram yenileme icin*/
 #define PIT_CHANNEL2_DATA	0x42	/* veri portu - speaker icin*/
 #define PIT_CNTRL		0x43
-#define PIT_HZ			100	/* bizim icin ideal hz */
-#define PIT_CLOCK		1193180	/* PIT calisma frekansi 1193180 Hz'dir. buna gore
-					 * kendi frekansimizi ayarlariz.
-				 	 */
 
 
 /*
@@ -75,18 +72,64 @@
 #define PIT_16BITBIN		0x00	/* 16 bitlik sayi seklinde verimizi gonderecegiz */
 #define PIT_BCD			0x01
 #define PIT_SET_BYTE		PIT_CHANNEL0 | PIT_RW_HIGHLOW | PIT_MODE3 | PIT_16BITBIN			
+#define PIT_ONESHOT_BYTE	PIT_CHANNEL0 | PIT_RW_HIGHLOW | PIT_MODE0 | PIT_16BITBIN
+#define PIT_LATCH_BYTE		PIT_CHANNEL0	/* rw = 0 0, sayaci kilitle (latch) */
 #define GET_LOW_BYTE(x)		(x & 0xFF)
 #define GET_HIGH_BYTE(x)	((x >> 8) & 0xFF)
 
+#define PIT_SPEAKER_PORT	0x61	/* bit 0 = kanal 2 gate, bit 1 = hoparlor, bit 5 = OUT2 */
+#define PIT_SPEAKER_GATE	0x01
+#define PIT_SPEAKER_DATA	0x02
+#define PIT_SPEAKER_OUT2	0x20
+#define PIT_CALIBRATE_TIMEOUT	0x1000000
+
+#define PIT_TICK_COUNT		(PIT_CLOCK / PIT_HZ)	/* bir tick'teki sayac degeri */
+#define PIT_MAX_COUNT		0xFFFF			/* 16 bit sayac */
+#define PIT_MAX_NOHZ_TICKS	(PIT_MAX_COUNT / PIT_TICK_COUNT)
+
 uint32_t timer_ticks = 0;
+
+static bool tick_oneshot = false;		/* tick kaynagi one-shot modda mi? */
+static uint32_t tick_oneshot_ticks = 0;		/* one-shot icin kurulan tick sayisi */
+static uint32_t tick_residual = 0;		/* tick'e tamamlanmamis sayac artigi */
+
+static void pit_set_periodic(void);
+static void pit_set_oneshot(uint32_t count);
+static uint32_t timer_read_count(void);
+
+static tick_device_t pit_tick_device = {
+	.name = "pit",
+	.tick_count = PIT_TICK_COUNT,
+	.max_oneshot_ticks = PIT_MAX_NOHZ_TICKS,
+	.set_periodic = pit_set_periodic,
+	.set_oneshot = pit_set_oneshot,
+	.read_count = timer_read_count,
+};
+
+static tick_device_t *tick_device = &pit_tick_device;
+static irq_action_t timer_irq;
+
 /*
- * timer_handler, timer isleyicisi
+ * timer_handler, timer isleyicisi. surec degistirmeden once eoi'yi
+ * kendisi gonderir, irq_handler ikinci kez gondermez.
  *
  * @param regs : kaydediciler.
+ * @param dev : kullanilmiyor
  */
-void timer_handler(registers_t *regs){
+irq_return_t timer_handler(registers_t *regs,void *dev){
  
-	timer_ticks++;
+	if(tick_oneshot){
+		/*
+		 * one-shot suresi doldu. uyudugumuz tick kadar jiffies'i
+		 * ilerletip tick kaynagini tekrar periyodik moda aliyoruz.
+		 */
+		timer_ticks += tick_oneshot_ticks;
+		tick_oneshot = false;
+		tick_device->set_periodic();
+	}
+	else
+		timer_ticks++;
+
 	irq_eoi(TIMER_IRQ_NUM);	/* kesme sonu sinyali gondererek kesmenin sona
 				 * erdigini bildiriyoruz, disable_irq ile karistirmayin.
 				 * disable_irq irq kesmelerini durdururken, irq_eoi ise timer
@@ -94,6 +137,10 @@ void timer_handler(registers_t *regs){
 				 * bildiriyor fakat hala irqlar aktif oldugu icin timer
 				 * isleyicisi tekrar tekrar cagrilir.
 				 */
+	ktimer_run();
+	switch_task();		/* zaman dilimi doldu, siradaki surece gec */
+
+	return IRQ_HANDLED;
  
 }
 
@@ -115,6 +162,169 @@ static void timer_set_freq(uint32_t hertz){
  
 }
 
+/*
+ * pit_set_periodic, pit'i PIT_HZ ile periyodik calistirir.
+ */
+static void pit_set_periodic(void){
+
+	timer_set_freq(PIT_HZ);
+
+}
+
+/*
+ * pit_set_oneshot, pit'i count sonra tek kesme uretecek sekilde
+ * (mode 0) kurar.
+ *
+ * @param count : sayac degeri
+ */
+static void pit_set_oneshot(uint32_t count){
+
+	outbyte(PIT_CNTRL,PIT_ONESHOT_BYTE);
+	outbyte(PIT_CHANNEL0_DATA,GET_LOW_BYTE(count));
+	outbyte(PIT_CHANNEL0_DATA,GET_HIGH_BYTE(count));
+
+}
+
+/*
+ * timer_read_count, kanal 0'in o anki sayac degerini okur.
+ */
+static uint32_t timer_read_count(void){
+
+	uint8_t low,high;
+
+	outbyte(PIT_CNTRL,PIT_LATCH_BYTE);
+	low = inbyte(PIT_CHANNEL0_DATA);
+	high = inbyte(PIT_CHANNEL0_DATA);
+
+	return (high << 8) | low;
+
+}
+
+/*
+ * timer_nohz_enter, bos donguden kesmeler kapaliyken cagrilir. en
+ * yakin zamanlayiciya kadar periyodik tick'i durdurup tick kaynagini
+ * one-shot olarak kurar. pit'te 16 bitlik sayac yuzunden tek seferde
+ * en fazla PIT_MAX_NOHZ_TICKS kadar uyunabilir, sonrasi icin tekrar
+ * kurulur. one-shot kuruldu ise 1 dondurur.
+ */
+bool timer_nohz_enter(void){
+
+	uint32_t delta = ktimer_next_expiry() - timer_ticks;
+	uint32_t count;
+
+	/* bir sonraki tick zaten yeterince yakin */
+	if(delta <= 1)
+		return false;
+
+	if(delta > tick_device->max_oneshot_ticks)
+		delta = tick_device->max_oneshot_ticks;
+
+	count = delta * tick_device->tick_count - tick_residual;
+	tick_oneshot_ticks = delta;
+	tick_residual = 0;
+	tick_oneshot = true;
+
+	tick_device->set_oneshot(count);
+
+	return true;
+
+}
+
+/*
+ * timer_nohz_exit, bos dongu uyandiginda kesmeler kapaliyken cagrilir.
+ * baska bir kesme ile one-shot dolmadan uyandiysak gecen sureyi sayactan
+ * okuyup jiffies'i duzeltir, tick kaynagini tekrar periyodik moda alir.
+ * tam tick'e tamamlanmayan artik bir sonraki hesaba aktarilir.
+ */
+void timer_nohz_exit(void){
+
+	uint32_t programmed,remaining,elapsed;
+
+	/* one-shot kesmesi geldi, timer_handler jiffies'i guncelledi */
+	if(!tick_oneshot)
+		return;
+
+	programmed = tick_oneshot_ticks * tick_device->tick_count;
+	remaining = tick_device->read_count();
+
+	/*
+	 * pit mode 0'da sayac sifira ulastiktan sonra 0xFFFF'ten saymaya
+	 * devam eder. kesme henuz islenmeden sayac dolmus demektir.
+	 */
+	if(remaining > programmed)
+		remaining = 0;
+
+	elapsed = programmed - remaining;
+	timer_ticks += elapsed / tick_device->tick_count;
+	tick_residual = elapsed % tick_device->tick_count;
+	tick_oneshot = false;
+
+	tick_device->set_periodic();
+	ktimer_run();
+
+}
+
+/*
+ * timer_calibrate_tsc, pit kanal 2'yi (hoparlor kapali) verilen
+ * milisaniye icin one-shot kurup sayac dolana kadar gecen tsc
+ * dongusunu olcer. kesme kullanmadigi icin irq'lar kurulmadan da
+ * cagrilabilir. ms en fazla 54 olabilir (16 bitlik sayac). sayac
+ * dolmazsa 0 dondurur.
+ *
+ * @param ms : olcum suresi (milisaniye)
+ * @param pit_count : kurulan pit sayac degeri
+ */
+uint64_t timer_calibrate_tsc(uint32_t ms,uint32_t *pit_count){
+
+	uint32_t count = PIT_CLOCK * ms / 1000;
+	uint8_t speaker = inbyte(PIT_SPEAKER_PORT);
+	uint32_t timeout = PIT_CALIBRATE_TIMEOUT;
+	uint64_t start,end;
+
+	outbyte(PIT_SPEAKER_PORT,(speaker & ~PIT_SPEAKER_DATA) | PIT_SPEAKER_GATE);
+
+	outbyte(PIT_CNTRL,PIT_CHANNEL2 | PIT_RW_HIGHLOW | PIT_MODE0 | PIT_16BITBIN);
+	outbyte(PIT_CHANNEL2_DATA,GET_LOW_BYTE(count));
+	outbyte(PIT_CHANNEL2_DATA,GET_HIGH_BYTE(count));
+
+	start = rdtsc();
+	while(!(inbyte(PIT_SPEAKER_PORT) & PIT_SPEAKER_OUT2) && --timeout)
+		;
+	end = rdtsc();
+
+	outbyte(PIT_SPEAKER_PORT,speaker);
+	*pit_count = count;
+
+	/* OUT2 hic degismedi, kanal 2 yok ya da calismiyor */
+	if(!timeout)
+		return 0;
+
+	return end - start;
+
+}
+
+/*
+ * timer_set_tick_device, jiffies'i ilerleten tick kaynagini degistirir
+ * ve periyodik olarak baslatir. eski kaynagi durdurmak cagiranin
+ * isidir.
+ *
+ * @param device : tick kaynagi
+ */
+void timer_set_tick_device(tick_device_t *device){
+
+	uint32_t flags = irq_save();
+
+	tick_device = device;
+	tick_oneshot = false;
+	tick_residual = 0;
+	device->set_periodic();
+
+	irq_restore(flags);
+
+	debug_print(KERN_INFO,"Tick device is \033[1;37m%s",device->name);
+
+}
+
 /*
  * init_timer, timer'i irq isleyici listesine ekler ve ayarlayip
  * baslatir.
@@ -122,7 +332,8 @@ static void timer_set_freq(uint32_t hertz){
 void timer_init(void){
  
 	debug_print(KERN_INFO,"Initializing the timer. Timer frequency is \033[1;37m%u Hz",PIT_HZ);
-	irq_add_handler(TIMER_IRQ_NUM,timer_handler);
+	ktimer_wheel_init();
+	irq_request(TIMER_IRQ_NUM,&timer_irq,timer_handler,0,"timer",NULL);
 	/*
 	 * 100 hz'e ayarla
 	 * saniyede 100 cevrim
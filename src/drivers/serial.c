@@ -0,0 +1,300 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  16550 UART Serial Console
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/spin_lock.h>
+#include <uniq/klog.h>
+#include <drivers/serial.h>
+
+/*
+ * 16550 kaydedicileri (port tabanina gore)
+ */
+#define UART_DATA		0	/* alma/gonderme, dlab = 1 ise bolen (low) */
+#define UART_IER		1	/* kesme etkinlestirme, dlab = 1 ise bolen (high) */
+#define UART_IIR		2	/* kesme kimligi (okuma) */
+#define UART_FCR		2	/* fifo kontrol (yazma) */
+#define UART_LCR		3	/* hat kontrol */
+#define UART_MCR		4	/* modem kontrol */
+#define UART_LSR		5	/* hat durumu */
+
+#define UART_IER_THRI		0x02	/* gonderme tutucusu bos kesmesi */
+#define UART_IIR_NO_INT		0x01	/* bekleyen kesme yok */
+#define UART_IIR_FIFO		0xC0	/* fifo etkin (16550a) */
+#define UART_FCR_ENABLE		0xC7	/* fifo ac, temizle, 14 bayt esigi */
+#define UART_LCR_8N1		0x03	/* 8 bit, paritesiz, 1 stop */
+#define UART_LCR_DLAB		0x80	/* bolen kaydedicilerine erisim */
+#define UART_MCR_LOOP		0x10	/* geri dongu (test) */
+#define UART_MCR_NORMAL		0x0B	/* dtr, rts, out2 (out2 kesme hattini acar) */
+#define UART_LSR_THRE		0x20	/* gonderme tutucusu bos */
+
+#define UART_CLOCK		115200	/* bolen 1 iken baud */
+#define UART_FIFO_SIZE		16
+#define UART_TEST_BYTE		0xAE
+
+#define SERIAL_TX_MASK		(SERIAL_TX_SIZE - 1)
+
+/*
+ * gonderilecek baytlar halkada tutulur. thre kesmesi geldiginde fifo
+ * bir seferde (16 bayt) doldurulur, halka bosalinca kesme kapatilir.
+ * panik sirasinda kesmeler gelmeyecegi icin polling'e gecilir.
+ */
+static struct{
+	port_t port;
+	bool present;
+	bool polled;				/* panik, kesmesiz gonderim */
+	bool tx_busy;				/* thre kesmesi acik */
+	uint8_t ier;
+	uint32_t head;				/* halkaya yazilan (serbest sayac) */
+	uint32_t tail;				/* fifo'ya aktarilan (serbest sayac) */
+	uint8_t buf[SERIAL_TX_SIZE];
+	serial_stat_t stat;
+}serial = { .port = SERIAL_COM1, .stat.fifo_size = 1 };
+
+static spinlock_t serial_lock = SPIN_LOCK_UNLOCKED("serial");
+static irq_action_t serial_irq;
+
+static void serial_klog_write(const klog_record_t *record);
+
+static klog_sink_t serial_sink = {
+	.name = "serial",
+	.write = serial_klog_write,
+	.panic = serial_panic,
+	.level = KERN_INFO,
+};
+
+/*
+ * serial_tx_fill, gonderme tutucusu bossa fifo'yu halkadan doldurur.
+ * serial_lock tutulurken cagrilir. halkada bayt kaldiysa true doner.
+ */
+static bool serial_tx_fill(void){
+
+	uint32_t count;
+
+	if(!(inbyte(serial.port + UART_LSR) & UART_LSR_THRE))
+		return serial.head != serial.tail;
+
+	for(count = 0; count < serial.stat.fifo_size && serial.tail != serial.head; count++)
+		outbyte(serial.port + UART_DATA,serial.buf[serial.tail++ & SERIAL_TX_MASK]);
+
+	serial.stat.bytes += count;
+
+	return serial.head != serial.tail;
+
+}
+
+/*
+ * serial_tx_wait, fifo bosalana kadar bekleyip tekrar doldurur.
+ */
+static void serial_tx_wait(void){
+
+	while(!(inbyte(serial.port + UART_LSR) & UART_LSR_THRE))
+		relax_cpu();
+
+	serial_tx_fill();
+
+}
+
+/*
+ * serial_set_thri, thre kesmesini acar ya da kapatir.
+ *
+ * @param on : acik mi?
+ */
+static void serial_set_thri(bool on){
+
+	serial.tx_busy = on;
+	serial.ier = on ? (serial.ier | UART_IER_THRI) : (serial.ier & ~UART_IER_THRI);
+	outbyte(serial.port + UART_IER,serial.ier);
+
+}
+
+/*
+ * serial_handler, com1 kesme isleyicisi. fifo'yu bir seferde doldurur.
+ * hat com3 ile paylasilabilir, iir'de bekleyen kesme yoksa kesme
+ * bizim degildir.
+ *
+ * @param regs : kaydediciler
+ * @param dev : kullanilmiyor
+ */
+static irq_return_t serial_handler(registers_t *regs,void *dev){
+
+	bool pending;
+
+	spin_lock(&serial_lock);
+
+	/* iir'i okumak thre kesmesini temizler */
+	pending = !(inbyte(serial.port + UART_IIR) & UART_IIR_NO_INT);
+	if(pending)
+		serial.stat.irqs++;
+
+	if(serial.tx_busy && !serial.polled && !serial_tx_fill())
+		serial_set_thri(false);
+
+	spin_unlock(&serial_lock);
+
+	return pending ? IRQ_HANDLED : IRQ_NONE;
+
+}
+
+/*
+ * serial_put, bir bayti halkaya ekler, halka doluysa fifo'nun bosalmasini
+ * bekler. serial_lock tutulurken cagrilir.
+ *
+ * @param c : bayt
+ */
+static inline void serial_put(uint8_t c){
+
+	if(serial.head - serial.tail == SERIAL_TX_SIZE){
+		serial.stat.tx_waits++;
+		serial_tx_wait();
+	}
+
+	serial.buf[serial.head++ & SERIAL_TX_MASK] = c;
+
+}
+
+/*
+ * serial_write, verilen baytlari gonderir. '\n' terminaller icin
+ * "\r\n" olarak gonderilir. gonderim kesme ile devam eder, panik
+ * modunda tum baytlar gonderilene kadar beklenir.
+ *
+ * @param s : karakter dizisi
+ * @param len : uzunluk
+ */
+void serial_write(const char *s,uint32_t len){
+
+	uint32_t flags;
+
+	if(!serial.present)
+		return;
+
+	flags = spin_lock_irqsave(&serial_lock);
+
+	for(uint32_t i = 0; i < len; i++){
+		if(s[i] == '\n')
+			serial_put('\r');
+		serial_put(s[i]);
+	}
+
+	if(serial.polled){
+		while(serial_tx_fill())
+			serial_tx_wait();
+	}
+	else if(!serial.tx_busy && serial_tx_fill())
+		serial_set_thri(true);
+
+	spin_unlock_irqrestore(&serial_lock,flags);
+
+}
+
+/*
+ * serial_klog_write, log kaydini duz metin olarak gonderir.
+ *
+ * @param record : kayit
+ */
+static void serial_klog_write(const klog_record_t *record){
+
+	char line[KLOG_LINE_SIZE];
+
+	serial_write(line,klog_format(record,line,sizeof(line)));
+
+}
+
+/*
+ * serial_panic, kesmesiz gonderime gecer ve halkada kalanlari
+ * bekleyerek gonderir. kilit zorla acilir.
+ */
+void serial_panic(void){
+
+	if(!serial.present)
+		return;
+
+	spin_lock_break(&serial_lock);
+
+	serial.polled = true;
+	serial_set_thri(false);
+
+	while(serial_tx_fill())
+		serial_tx_wait();
+
+}
+
+/*
+ * serial_stat, istatistiklerin kopyasini dondurur.
+ *
+ * @param stat : istatistiklerin kopyalanacagi alan
+ */
+void serial_stat(serial_stat_t *stat){
+
+	*stat = serial.stat;
+
+}
+
+/*
+ * serial_probe, geri dongu modunda yazilan bayt geri okunabiliyorsa
+ * uart vardir.
+ */
+static bool serial_probe(void){
+
+	outbyte(serial.port + UART_MCR,UART_MCR_LOOP | UART_MCR_NORMAL);
+	outbyte(serial.port + UART_DATA,UART_TEST_BYTE);
+
+	return inbyte(serial.port + UART_DATA) == UART_TEST_BYTE;
+
+}
+
+/*
+ * serial_init, com1'i 115200 8n1 olarak kurar, kesmeyi baglar ve
+ * log cikisi olarak kaydeder.
+ */
+void serial_init(void){
+
+	uint16_t divisor = UART_CLOCK / SERIAL_BAUD;
+
+	outbyte(serial.port + UART_IER,0);
+	outbyte(serial.port + UART_LCR,UART_LCR_DLAB);
+	outbyte(serial.port + UART_DATA,divisor & 0xFF);
+	outbyte(serial.port + UART_IER,divisor >> 8);
+	outbyte(serial.port + UART_LCR,UART_LCR_8N1);
+	outbyte(serial.port + UART_FCR,UART_FCR_ENABLE);
+
+	if(!serial_probe()){
+		debug_print(KERN_WARNING,"serial: no uart at 0x%08X",serial.port);
+		return;
+	}
+
+	outbyte(serial.port + UART_MCR,UART_MCR_NORMAL);
+
+	if((inbyte(serial.port + UART_IIR) & UART_IIR_FIFO) == UART_IIR_FIFO)
+		serial.stat.fifo_size = UART_FIFO_SIZE;
+
+	serial.ier = 0;
+	serial.present = true;
+	irq_request(SERIAL_COM1_IRQ,&serial_irq,serial_handler,IRQF_SHARED,"serial",NULL);
+
+	klog_register_sink(&serial_sink);
+
+	debug_print(KERN_INFO,"serial: com1 at 0x%08X, %u baud, %u byte fifo",serial.port,SERIAL_BAUD,serial.stat.fifo_size);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
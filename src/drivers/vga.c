@@ -22,6 +22,7 @@
 #include <uniq/types.h>
 #include <uniq/module.h>
 #include <uniq/kernel.h>
+#include <uniq/timer.h>
 #include <string.h>
 
 /*
@@ -49,6 +50,7 @@
 
 #define TAB_SIZE		8				/* tab buyuklugu */
 #define BLANK			0x20				/* bosluk karakteri */
+#define VGA_DIRTY_ALL		((1U << VGA_CHEIGHT) - 1)	/* tum satirlar */
 
 
 
@@ -57,8 +59,141 @@ static uint8_t csr_x,csr_y;		/* imlec x ve y */
 static uint16_t csr_loc;		/* imlec toplam konum (y*80 + x)*/
 static uint8_t save_x,save_y;
 
+/*
+ * konsol once ram'deki golge tampona yazilir. golge tampon satirlardan
+ * olusan bir halkadir, ekranin ilk satiri vga_top'taki satirdir. boylece
+ * kaydirma tum ekrani tasimak yerine vga_top'u bir arttirmaktan ibarettir.
+ * degisen satirlar vga_dirty'de isaretlenir ve vga_flush ile toplu halde
+ * vram'e kopyalanir, donanim imleci de yalnizca orada guncellenir.
+ */
+static uint16_t vga_shadow[VGA_CSIZE];
+static uint32_t vga_top = 0;		/* ekranin ilk satirinin golgedeki yeri */
+static uint32_t vga_dirty = 0;		/* bit y, ekranin y. satiri kirli */
+static uint16_t vga_hw_csr = 0xFFFF;	/* donanima en son yazilan imlec */
+
+/*
+ * zamanlayici calismaya basladiktan sonra vram'e yazma bir sonraki
+ * tick'e ertelenir, bir tick icindeki tum ciktilar tek seferde basilir.
+ */
+static bool vga_deferred = false;
+static ktimer_t vga_flush_timer;
+
 void goto_xy(uint8_t new_x,uint8_t new_y);
 
+/*
+ * vga_line, ekranin y. satirinin golge tampondaki adresini dondurur.
+ *
+ * @param y : ekran satiri
+ */
+static inline uint16_t *vga_line(uint32_t y){
+
+	y += vga_top;
+	if(y >= VGA_CHEIGHT)
+		y -= VGA_CHEIGHT;
+
+	return vga_shadow + y * VGA_CWIDTH;
+
+}
+
+/*
+ * vga_set, imlecin bulundugu yere karakteri yazar ve imleci ilerletir.
+ */
+static inline void vga_set(uint16_t entry){
+
+	uint32_t y = csr_loc / VGA_CWIDTH;
+
+	vga_line(y)[csr_loc % VGA_CWIDTH] = entry;
+	vga_dirty |= 1 << y;
+	csr_loc++;
+
+}
+
+/*
+ * vga_copy_lines, ekranin y. satirindan itibaren n satiri vram'e
+ * kopyalar. halka sona sarabildigi icin en fazla iki parca olur.
+ */
+static void vga_copy_lines(uint32_t y,uint32_t n){
+
+	while(n){
+		uint32_t top = y + vga_top;
+		uint32_t chunk;
+
+		if(top >= VGA_CHEIGHT)
+			top -= VGA_CHEIGHT;
+
+		chunk = VGA_CHEIGHT - top;
+		if(chunk > n)
+			chunk = n;
+
+		memcpy(vga_vram + y * VGA_CWIDTH,vga_shadow + top * VGA_CWIDTH,chunk * VGA_CWIDTH * 2);
+		y += chunk;
+		n -= chunk;
+	}
+
+}
+
+/*
+ * vga_flush, kirli satirlari ardisik gruplar halinde vram'e yazar ve
+ * imlec degistiyse donanim imlecini tasir.
+ */
+void vga_flush(void){
+
+	uint32_t flags = irq_save();
+	uint32_t dirty = vga_dirty;
+
+	if(!vga_vram){
+		irq_restore(flags);
+		return;
+	}
+
+	vga_dirty = 0;
+
+	for(uint32_t y = 0; dirty >> y; ){
+		uint32_t end;
+
+		if(!(dirty & (1 << y))){
+			y++;
+			continue;
+		}
+
+		for(end = y; end < VGA_CHEIGHT && (dirty & (1 << end)); end++);
+
+		vga_copy_lines(y,end - y);
+		y = end;
+	}
+
+	if(vga_hw_csr != csr_loc){
+		outbyte(VGA_IPORT,VGA_CLHIGH);
+		outbyte(VGA_DPORT,csr_loc >> 8);
+
+		outbyte(VGA_IPORT,VGA_CLLOW);
+		outbyte(VGA_DPORT,(csr_loc & 0xFF));
+		vga_hw_csr = csr_loc;
+	}
+
+	irq_restore(flags);
+
+}
+
+static void vga_flush_timer_func(void *data){
+
+	vga_flush();
+
+}
+
+/*
+ * vga_commit, yapilan degisiklikleri ekrana yansitir. zamanlayici
+ * devredeyse bir sonraki tick'e bir kere yazma kurulur.
+ */
+static void vga_commit(void){
+
+	if(!vga_deferred)
+		vga_flush();
+	else if(!ktimer_pending(&vga_flush_timer))
+		ktimer_add(&vga_flush_timer,timer_ticks + 1);
+
+}
+
 /*
  * refresh_csr, imlec degerlerlerini yeniler, imleci
  * konumuna(csr_loc) gore csr_x ve csr_y degerlerini ayarlar.
@@ -103,19 +238,21 @@ static void scrollup(void){
 
 	if(csr_loc < VGA_CSIZE)
 		return;
-	
-	/*
-	 *for(int i=0;i<=VGA_CSIZE;i++)
-	 *	vga_vram[i] = vga_vram[i+VGA_CWIDTH];
-	 */
-	 
+
 	/*
-	 * string.c'ye memcpy'yi ekledikten sonra onu kullanmak
-	 * daha iyi gibi ;)
+	 * en ustteki satir halkada yeni en alt satir olur, temizleyip
+	 * vga_top'u ilerletmek yeterli. ekrandaki tum satirlar yer
+	 * degistirdigi icin hepsi kirlidir.
 	 */
-	for(int i=0;i<=VGA_CHEIGHT;i++)
-		memcpy(vga_vram+i*VGA_CWIDTH,vga_vram+(i+1)*VGA_CWIDTH,(VGA_CWIDTH)*2);
+	uint16_t *line = vga_line(0);
 
+	for(uint32_t i = 0; i < VGA_CWIDTH; i++)
+		line[i] = make_vga_entry(BLANK,DEFAULT_ATTR);
+
+	if(++vga_top == VGA_CHEIGHT)
+		vga_top = 0;
+
+	vga_dirty = VGA_DIRTY_ALL;
 	csr_loc -= VGA_CWIDTH;
 	
 }
@@ -133,17 +270,23 @@ void delete_line(uint8_t line_no){
 	if(line_no > (VGA_CHEIGHT-1))
 		return;
 
+	uint32_t flags = irq_save();
 	uint8_t new_x = 0;
 	uint8_t new_y = line_no;
 	goto_xy(new_x,new_y);
 
+	uint16_t *line = vga_line(line_no);
+
 	for(uint8_t i=new_x;i<VGA_CWIDTH;i++)
-		vga_vram[csr_loc+i] = make_vga_entry(BLANK,DEFAULT_ATTR);
+		line[i] = make_vga_entry(BLANK,DEFAULT_ATTR);
+	vga_dirty |= 1 << line_no;
 	
 	if(line_no == save_y)
 		save_x = 0;
 	
 	restore_csr();
+	vga_commit();
+	irq_restore(flags);
  	
 }
 
@@ -183,16 +326,10 @@ void change_line(uint8_t line_no,const char *s){
  
 /*
  * move_csr, imleci degisen csr_loc'a gore ayarlar.kisacasi imlec
- * konumunu ayarlar.
+ * konumunu ayarlar. donanim imleci vga_flush'ta tasinir.
  */
 static void move_csr(void){
 
-	outbyte(VGA_IPORT,VGA_CLHIGH);
-	outbyte(VGA_DPORT,csr_loc >> 8);
-
-	outbyte(VGA_IPORT,VGA_CLLOW);
-	outbyte(VGA_DPORT,(csr_loc & 0xFF));
-	
 	refresh_csr();
 	
 }
@@ -212,6 +349,9 @@ void goto_xy(uint8_t new_x,uint8_t new_y){
 	csr_loc = new_y * VGA_CWIDTH + new_x;
 	move_csr();
 
+	if(vga_vram)
+		vga_commit();
+
 }
 
 
@@ -248,18 +388,14 @@ uint32_t putstr_goto_xy(uint8_t new_x,uint8_t new_y,char *s,uint8_t attr){
 }
 
 /*
- * putchar, verilen karakteri ekrana basar.
+ * vga_putc, karakteri golge tampona yazar fakat donanim imlecini
+ * guncellemez. imlec port g/c ile tasindigi icin putstr once tum
+ * diziyi yazar, imleci bir kere tasir.
  *
  * @param c: karakter
  * @param attr: karakter ozelligi(rengi)
  */
-void putchar(const char c, uint8_t attr){
-
-	if(!vga_vram || !c)
-		return;
-		
-	if(!attr)
-		attr = DEFAULT_ATTR;
+static void vga_putc(const char c, uint8_t attr){
 
 	switch(c){
 		/* bir alt satir */
@@ -268,47 +404,96 @@ void putchar(const char c, uint8_t attr){
 				csr_loc++;
 
 			while(csr_loc % VGA_CWIDTH)
-				vga_vram[csr_loc++] = make_vga_entry(BLANK,DEFAULT_ATTR);
+				vga_set(make_vga_entry(BLANK,DEFAULT_ATTR));
 			break;
 		/* imleci sola kaydir(backspace) */
 		case '\b':
-			vga_vram[csr_loc--] = make_vga_entry(BLANK,DEFAULT_ATTR);
+			vga_set(make_vga_entry(BLANK,DEFAULT_ATTR));
+			csr_loc -= csr_loc > 1 ? 2 : csr_loc;
 			break;
 		/* satir basi */
 		case '\r':
-			goto_xy(0,csr_y);
+			csr_loc -= csr_loc % VGA_CWIDTH;
 			break;
 		/* yatay tab */
 		case '\t':
-			for(int i=0;i<TAB_SIZE;i++)
-				vga_vram[csr_loc++] = make_vga_entry(BLANK,DEFAULT_ATTR);
+			for(int i=0;i<TAB_SIZE;i++){
+				scrollup();
+				vga_set(make_vga_entry(BLANK,DEFAULT_ATTR));
+			}
 			break;
 		/* dikey tab */
 		case '\v':
-			putstr("\n\t",DEFAULT_ATTR);
-			break;
-		/* cift tirnak */
-		case '\"':
-			vga_vram[csr_loc++] = make_vga_entry(0x22,attr);
-			break;
-		/* tek tirnak */
-		case '\'':
-			vga_vram[csr_loc++] = make_vga_entry(0x27,attr);
-			break;
-		case '\\':
-			vga_vram[csr_loc++] = make_vga_entry(0x5C,attr);
+			vga_putc('\n',attr);
+			vga_putc('\t',attr);
 			break;
 		default:
-			vga_vram[csr_loc++] = make_vga_entry(c,attr);
+			vga_set(make_vga_entry(c,attr));
 			break;
 			
 	}
 
 	scrollup();
-	move_csr();
 	
 }
 
+/*
+ * vga_puts, diziyi golge tampona yazar. kontrol karakteri olmayan
+ * parcalar satir sonuna kadar tek dongude yazilir.
+ *
+ * @param s : karakter dizisi
+ * @param attr : karakter ozelligi
+ */
+static uint32_t vga_puts(const char *s,uint8_t attr){
+
+	const char *start = s;
+
+	while(*s){
+		uint32_t y = csr_loc / VGA_CWIDTH;
+		uint32_t x = csr_loc % VGA_CWIDTH;
+		uint16_t *line = vga_line(y);
+
+		if((uint8_t)*s < BLANK){
+			vga_putc(*s++,attr);
+			continue;
+		}
+
+		while(x < VGA_CWIDTH && (uint8_t)*s >= BLANK)
+			line[x++] = make_vga_entry(*s++,attr);
+
+		vga_dirty |= 1 << y;
+		csr_loc = y * VGA_CWIDTH + x;
+		scrollup();
+	}
+
+	return s - start;
+
+}
+
+/*
+ * putchar, verilen karakteri ekrana basar.
+ *
+ * @param c: karakter
+ * @param attr: karakter ozelligi(rengi)
+ */
+void putchar(const char c, uint8_t attr){
+
+	if(!vga_vram || !c)
+		return;
+		
+	if(!attr)
+		attr = DEFAULT_ATTR;
+
+	uint32_t flags = irq_save();
+
+	vga_putc(c,attr);
+	move_csr();
+	vga_commit();
+
+	irq_restore(flags);
+
+}
+
 /*
  * putstr, verilen karakter dizisini ekrana basar.
  *
@@ -323,9 +508,13 @@ uint32_t putstr(const char *string,uint8_t attr){
 	if(!attr)
 		attr = DEFAULT_ATTR;
 		
-	uint32_t i = 0;
-	while(string[i])
-		putchar(string[i++],attr);
+	uint32_t flags = irq_save();
+	uint32_t i = vga_puts(string,attr);
+
+	move_csr();
+	vga_commit();
+
+	irq_restore(flags);
 
 	return i;
 }
@@ -338,14 +527,42 @@ void reset_console(void){
 	if(!vga_vram)
 		return;
 	
+	uint32_t flags = irq_save();
+
 	csr_x = csr_y = csr_loc = 0;
+	vga_top = 0;
 
 	for(uint8_t i=0;i<VGA_CHEIGHT;i++)
 		delete_line(i);
 	move_csr();
+	vga_commit();
+
+	irq_restore(flags);
 	
 }
 
+/*
+ * vga_defer_flush, zamanlayici calismaya basladiginda cagrilir. bundan
+ * sonra vram'e yazma ve imlec tasima tick basina bir kere yapilir.
+ */
+void vga_defer_flush(void){
+
+	ktimer_setup(&vga_flush_timer,vga_flush_timer_func,NULL);
+	vga_deferred = true;
+
+}
+
+/*
+ * vga_panic, sistem durmadan once cagrilir. bekleyen satirlar hemen
+ * basilir, bundan sonraki ciktilar beklemeden vram'e yazilir.
+ */
+void vga_panic(void){
+
+	vga_deferred = false;
+	vga_flush();
+
+}
+
 /*
  * exit_vga_console, vga konsolunu kapatir.kapattiktan 
  * sonra tum ekrani temizleyecek ve ekrana bundan sonra
@@ -367,6 +584,9 @@ void exit_vga_console(void){
 	#endif
 	
 	debug_print(KERN_INFO,"Shutting down the vga console.");
+	vga_flush();
+	if(vga_deferred)
+		ktimer_del(&vga_flush_timer);
 	vga_vram = NULL;
 	
 }
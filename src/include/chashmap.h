@@ -0,0 +1,68 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_CHASHMAP_H__
+#define __UNIQ_CHASHMAP_H__
+
+#include <uniq/types.h>
+#include <uniq/spin_lock.h>
+#include <uniq/epoch.h>
+
+#define CHASHMAP_SIGNATURE		0x4C8AE7D2
+#define CHASHMAP_STRIPES		16		/* kilit sayisi, 2'nin kuvveti */
+
+typedef enum{
+	CHASHMAP_INT,			/* anahtar adresin kendisi */
+	CHASHMAP_STR			/* anahtar karakter dizisi (kopyalanir) */
+}chashmap_type_t;
+
+/*
+ * kova zincirindeki eleman. okuyucular zinciri kilitsiz dolastigi icin
+ * cikarilan eleman hemen bosa cikarilmaz, epoch ile ertelenir.
+ */
+typedef struct chashmap_entry{
+	struct chashmap_entry *volatile next;
+	uint32_t hash;
+	void *hash_key;
+	void *volatile item;
+	epoch_head_t epoch;		/* ertelenmis geri kazanim */
+}chashmap_entry_t;
+
+/*
+ * eszamanli hashmap. her kova, indisinin alt bitlerine gore bir kilide
+ * (stripe) aittir, yazarlar sadece o kilidi alir. okuyucular kilit
+ * almaz, epoch okuma bolumunde zinciri dolasir. kova sayisi sabittir.
+ */
+typedef struct{
+	uint32_t signature;
+	chashmap_type_t type;
+	uint32_t mask;				/* kova sayisi - 1 */
+	volatile uint32_t count;		/* anahtar sayisi */
+	chashmap_entry_t *volatile *buckets;
+	spinlock_t locks[CHASHMAP_STRIPES];
+}chashmap_t;
+
+chashmap_t *chashmap_int_create(uint32_t size);
+chashmap_t *chashmap_str_create(uint32_t size);
+void chashmap_destroy(chashmap_t *map);
+void *chashmap_get(chashmap_t *map,void *hash_key);
+void *chashmap_set(chashmap_t *map,void *item,void *hash_key);
+void *chashmap_remove(chashmap_t *map,void *hash_key);
+
+#endif /* __UNIQ_CHASHMAP_H__ */
@@ -30,6 +30,8 @@
 #define __noreturn	__attribute__ ((noreturn))
 #define __packed	__attribute__ ((packed))
 #define __malloc	__attribute__ ((malloc))
+#define __returns_twice	__attribute__ ((returns_twice))
+#define __printf(a,b)	__attribute__ ((format(printf,a,b)))
 
 
 #endif	/* __UNIQ_COMPILER_GCC_H__ */
@@ -0,0 +1,59 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_LFB_GRAPH_H__
+#define __UNIQ_LFB_GRAPH_H__
+
+#include <uniq/types.h>
+#include <uniq/multiboot.h>
+
+#define LFB_BPP			32		/* desteklenen tek piksel derinligi */
+#define LFB_MAX_WIDTH		4096
+#define LFB_MAX_HEIGHT		4096
+
+#define LFB_FONT_WIDTH		8
+#define LFB_FONT_HEIGHT		8
+#define LFB_FONT_FIRST		0x20		/* fonttaki ilk karakter */
+#define LFB_FONT_GLYPHS		95		/* 0x20 - 0x7E */
+
+#define LFB_COLOR_FG		0x00AAAAAA	/* konsol yazi rengi (acik gri) */
+#define LFB_COLOR_BG		0x00000000	/* konsol arkaplan rengi */
+
+typedef struct{
+	uint32_t x0,y0;				/* sol ust kose */
+	uint32_t x1,y1;				/* sag alt kose (dahil degil) */
+}lfb_rect_t;
+
+extern const uint8_t font8x8[LFB_FONT_GLYPHS][LFB_FONT_HEIGHT];
+
+void dump_vbe_info(vbe_info_t *vbe_info);
+void lfb_graph_probe(mboot_info_t *mboot_info);
+bool lfb_graph_init(void);
+bool lfb_graph_ready(void);
+uint32_t lfb_width(void);
+uint32_t lfb_height(void);
+void lfb_fill_rect(uint32_t x,uint32_t y,uint32_t w,uint32_t h,uint32_t color);
+void lfb_blit(uint32_t x,uint32_t y,uint32_t w,uint32_t h,const uint32_t *src,uint32_t src_pitch);
+void lfb_draw_char(uint32_t x,uint32_t y,char c,uint32_t fg,uint32_t bg);
+void lfb_flush(void);
+void lfb_console_write(const char *s,uint32_t len);
+void lfb_panic(void);
+void __lfb_bench(void);
+
+#endif /* __UNIQ_LFB_GRAPH_H__ */
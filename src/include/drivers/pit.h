@@ -20,6 +20,37 @@
 #ifndef __UNIQ_PIT_H__
 #define __UNIQ_PIT_H__
 
+#include <uniq/types.h>
+
+#define PIT_HZ			100	/* bizim icin ideal hz */
+#define PIT_CLOCK		1193180	/* PIT calisma frekansi 1193180 Hz'dir. buna gore
+					 * kendi frekansimizi ayarlariz.
+				 	 */
+
+/*
+ * bos dongude periyodik tick'i durdurup pit'i bir sonraki zamanlayiciya
+ * gore one-shot kurar. kapatmak icin asagidaki tanimi kaldirin.
+ */
+#define PIT_TICKLESS_IDLE
+
+/*
+ * jiffies'i ilerleten tick kaynagi. varsayilan pit'tir, local apic
+ * varsa apic_init onun zamanlayicisini kurar. sayac degerleri cihazin
+ * kendi birimindedir.
+ */
+typedef struct{
+	char *name;				/* tick kaynagi ismi */
+	uint32_t tick_count;			/* bir tick'teki sayac degeri */
+	uint32_t max_oneshot_ticks;		/* tek seferde en fazla uyunabilecek tick */
+	void (*set_periodic)(void);		/* PIT_HZ ile periyodik */
+	void (*set_oneshot)(uint32_t count);	/* count sonra tek kesme */
+	uint32_t (*read_count)(void);		/* one-shot'ta kalan sayac */
+}tick_device_t;
+
 void timer_init(void);
+void timer_set_tick_device(tick_device_t *device);
+bool timer_nohz_enter(void);
+void timer_nohz_exit(void);
+uint64_t timer_calibrate_tsc(uint32_t ms,uint32_t *pit_count);
 
 #endif /* __UNIQ_PIT_H__ */
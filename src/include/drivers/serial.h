@@ -0,0 +1,42 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_SERIAL_H__
+#define __UNIQ_SERIAL_H__
+
+#include <uniq/types.h>
+
+#define SERIAL_COM1		0x3F8
+#define SERIAL_COM1_IRQ		4
+#define SERIAL_BAUD		115200
+#define SERIAL_TX_SIZE		4096		/* gonderim halkasi (2'nin kuvveti) */
+
+typedef struct{
+	uint32_t irqs;				/* thre kesmesi */
+	uint32_t bytes;				/* gonderilen bayt */
+	uint32_t tx_waits;			/* halka dolu, fifo beklendi */
+	uint32_t fifo_size;			/* 16550a icin 16, yoksa 1 */
+}serial_stat_t;
+
+void serial_init(void);
+void serial_write(const char *s,uint32_t len);
+void serial_panic(void);
+void serial_stat(serial_stat_t *stat);
+
+#endif /* __UNIQ_SERIAL_H__ */
@@ -76,6 +76,9 @@ uint32_t putstr(const char *string,uint8_t attr);
 void putchar(const char c, uint8_t attr);
 void delete_line(uint8_t line_no);
 void change_line(uint8_t line_no,const char *s);
+void vga_flush(void);
+void vga_defer_flush(void);
+void vga_panic(void);
 
 
 #endif /* __UNIQ_VGA_H__ */
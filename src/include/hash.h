@@ -0,0 +1,59 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_HASH_H__
+#define __UNIQ_HASH_H__
+
+#include <uniq/types.h>
+
+#define HASH_SEED		0x9E3779B9		/* varsayilan tohum */
+
+#define FNV1A_OFFSET		0x811C9DC5
+#define FNV1A_PRIME		0x01000193
+
+/*
+ * hash_fmix32, murmur3 son karistirma adimi. girdinin her biti
+ * ciktinin her bitini yaklasik yariya yakin olasilikla degistirir,
+ * ardisik tamsayilar (pid, inode) birbirinden uzak hash degerleri alir.
+ *
+ * @param x : deger
+ */
+static inline uint32_t hash_fmix32(uint32_t x){
+
+	x ^= x >> 16;
+	x *= 0x85EBCA6B;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35;
+	x ^= x >> 16;
+
+	return x;
+
+}
+
+static inline uint32_t hash_rotl32(uint32_t x,uint32_t r){
+
+	return (x << r) | (x >> (32 - r));
+
+}
+
+uint32_t hash_fnv1a(const void *data,size_t len);
+uint32_t hash_xxh32(const void *data,size_t len,uint32_t seed);
+uint32_t hash_str(const char *s);
+
+#endif /* __UNIQ_HASH_H__ */
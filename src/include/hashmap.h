@@ -21,31 +21,65 @@
 #define __UNIQ_HASHMAP_H__
 
 #include <uniq/types.h>
+#include <list.h>
 
 #define HASHMAP_SIGNATURE			0x79FFC571
+#define HASHMAP_MIN_SIZE			8
+#define HASHMAP_REHASH_STEP			16	/* her yazmada tasinan eski yuva */
+
+/*
+ * doluluk orani bu degeri (yuzde) gecince tablo iki katina buyutulur.
+ * robin hood yoklamasi %80 civarina kadar kisa yoklama mesafeleri verir.
+ */
+#define HASHMAP_MAX_LOAD			80
 
 typedef void (*hashmap_free_t)(void *x);
 typedef void *(*hashmap_dup_t)(void *x);
-typedef int32_t (*hashmap_cmp_t)(void *x,void *y);
 typedef uint32_t (*hashmap_hash_code_t)(void *key);
 
-typedef struct _hashmap_entry_t{
-	struct _hash_map_entry_t *next;
-	char *hash_key;
+typedef enum{
+	HASHMAP_INT,			/* anahtar adresin kendisi */
+	HASHMAP_STR			/* anahtar karakter dizisi */
+}hashmap_type_t;
+
+/*
+ * acik adresli (robin hood) tablo yuvasi. hash degeri yuvada saklanir,
+ * bu sayede yoklama mesafesi ve anahtar karsilastirmasindan once hash
+ * esitligi anahtara dokunmadan kontrol edilir. hash 0 ise yuva bostur,
+ * hash_key NULL ise yuva silinmistir (sadece tasinan eski tabloda).
+ */
+typedef struct{
+	uint32_t hash;
+	void *hash_key;
 	void *item;
-}hashmap_entry_t;
+}hashmap_slot_t;
+
+typedef struct{
+	hashmap_slot_t *slots;
+	uint32_t mask;			/* yuva sayisi - 1 */
+}hashmap_table_t;
 
 typedef struct{
 	hashmap_hash_code_t hash_code;
-	uint32_t size;
+	hashmap_type_t type;
 	uint32_t signature;
-	hashmap_entry_t **entries;
-	hashmap_cmp_t  hash_cmp;
+	uint32_t count;			/* iki tablodaki toplam anahtar */
+	hashmap_table_t table;		/* yeni eklemelerin yapildigi tablo */
+	hashmap_table_t old;		/* buyutme sirasinda tasinan tablo */
+	uint32_t rehash_index;		/* eski tabloda tasinacak siradaki yuva */
 	hashmap_dup_t hash_dup;
-	hashmap_free_t hash_item_free;
 	hashmap_free_t hash_key_free;
 }hashmap_t;
 
+typedef struct{
+	uint32_t count;			/* anahtar sayisi */
+	uint32_t size;			/* yuva sayisi */
+	uint32_t collisions;		/* ideal yuvasinda olmayan anahtar */
+	uint32_t total_probe;		/* yoklama mesafeleri toplami */
+	uint32_t max_probe;		/* en uzun yoklama mesafesi */
+	bool rehashing;			/* buyutme suruyor mu? */
+}hashmap_stat_t;
+
 void hashmap_destroy(hashmap_t *hashmap);
 int32_t hashmap_check(hashmap_t *hashmap,void *hash_key);
 list_t *hashmap_get_values(hashmap_t *hashmap);
@@ -55,6 +89,10 @@ void *hashmap_set(hashmap_t *hashmap,void *item,void *hash_key);
 hashmap_t *hashmap_int_create(uint32_t size);
 hashmap_t *hashmap_str_create(uint32_t size);
 void *hashmap_remove(hashmap_t *hashmap,void *hash_key);
+int32_t hashmap_set_hash(hashmap_t *hashmap,hashmap_hash_code_t hash_code);
+void hashmap_stat(hashmap_t *hashmap,hashmap_stat_t *stat);
+void hashmap_stat_dump(hashmap_t *hashmap,const char *name);
+void __hashmap_test(void);
 
 
 #endif /* __UNIQ_HASHMAP_H__ */
@@ -0,0 +1,215 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_ILIST_H__
+#define __UNIQ_ILIST_H__
+
+#include <uniq/types.h>
+
+/*
+ * ic ice (intrusive) cift yonlu liste. dugum listeye eklenecek yapinin
+ * icinde durur, ekleme/cikarma bellek ayirmaz ve basarisiz olamaz.
+ * liste dairesel olup basi (head) bir nobetci dugumdur, bu yuzden
+ * hicbir islemde NULL kontrolu gerekmez. yapiya container_of ile
+ * (ilist_entry) ulasilir.
+ */
+typedef struct ilist_node{
+	struct ilist_node *prev;	/* onceki dugum */
+	struct ilist_node *next;	/* sonraki dugum */
+}ilist_node_t;
+
+typedef struct{
+	ilist_node_t head;		/* nobetci dugum */
+	uint32_t size;			/* liste uzunlugu */
+}ilist_t;
+
+#define ILIST_INIT(name)		{ { &(name).head, &(name).head }, 0 }
+
+#define ilist_entry(node,type,member)	container_of(node,type,member)
+
+/*
+ * ilist_init, listeyi bos olarak hazirlar.
+ *
+ * @param list : liste
+ */
+static inline void ilist_init(ilist_t *list){
+
+	list->head.prev = list->head.next = &list->head;
+	list->size = 0;
+
+}
+
+/*
+ * ilist_node_init, dugumu hicbir listeye bagli degil olarak isaretler.
+ *
+ * @param node : dugum
+ */
+static inline void ilist_node_init(ilist_node_t *node){
+
+	node->prev = node->next = NULL;
+
+}
+
+/*
+ * ilist_linked, dugum bir listeye bagli mi? dugum ilist_node_init ile
+ * hazirlanmis olmalidir.
+ *
+ * @param node : dugum
+ */
+static inline bool ilist_linked(ilist_node_t *node){
+
+	return node->next != NULL;
+
+}
+
+/*
+ * ilist_empty, liste bos mu?
+ *
+ * @param list : liste
+ */
+static inline bool ilist_empty(ilist_t *list){
+
+	return list->head.next == &list->head;
+
+}
+
+static inline void __ilist_insert(ilist_node_t *node,ilist_node_t *prev,ilist_node_t *next){
+
+	node->prev = prev;
+	node->next = next;
+	prev->next = node;
+	next->prev = node;
+
+}
+
+/*
+ * ilist_add_tail, dugumu listenin sonuna ekler.
+ *
+ * @param list : liste
+ * @param node : dugum
+ */
+static inline void ilist_add_tail(ilist_t *list,ilist_node_t *node){
+
+	__ilist_insert(node,list->head.prev,&list->head);
+	list->size++;
+
+}
+
+/*
+ * ilist_add_head, dugumu listenin basina ekler.
+ *
+ * @param list : liste
+ * @param node : dugum
+ */
+static inline void ilist_add_head(ilist_t *list,ilist_node_t *node){
+
+	__ilist_insert(node,&list->head,list->head.next);
+	list->size++;
+
+}
+
+/*
+ * ilist_del, dugumu bagli oldugu listeden cikarir.
+ *
+ * @param list : liste
+ * @param node : dugum
+ */
+static inline void ilist_del(ilist_t *list,ilist_node_t *node){
+
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = node->next = NULL;
+	list->size--;
+
+}
+
+/*
+ * ilist_first, listenin ilk dugumunu dondurur, liste bossa NULL doner.
+ *
+ * @param list : liste
+ */
+static inline ilist_node_t *ilist_first(ilist_t *list){
+
+	return ilist_empty(list) ? NULL : list->head.next;
+
+}
+
+/*
+ * ilist_pop_first, listenin ilk dugumunu listeden cikarip dondurur,
+ * liste bossa NULL doner.
+ *
+ * @param list : liste
+ */
+static inline ilist_node_t *ilist_pop_first(ilist_t *list){
+
+	ilist_node_t *node = ilist_first(list);
+
+	if(node)
+		ilist_del(list,node);
+
+	return node;
+
+}
+
+/*
+ * ilist_splice_tail, src listesinin tum dugumlerini dest listesinin
+ * sonuna tasir, src bos kalir.
+ *
+ * @param dest : hedef liste
+ * @param src : kaynak liste
+ */
+static inline void ilist_splice_tail(ilist_t *dest,ilist_t *src){
+
+	if(ilist_empty(src))
+		return;
+
+	src->head.next->prev = dest->head.prev;
+	dest->head.prev->next = src->head.next;
+	src->head.prev->next = &dest->head;
+	dest->head.prev = src->head.prev;
+	dest->size += src->size;
+
+	ilist_init(src);
+
+}
+
+#define ilist_first_entry(list,type,member)					\
+	(ilist_empty(list) ? NULL : ilist_entry((list)->head.next,type,member))
+
+/* dugumler uzerinde dolasir, dongu icinde dugum silinmemelidir */
+#define ilist_for_each(pos,list)						\
+	for(pos = (list)->head.next; pos != &(list)->head; pos = pos->next)
+
+/*
+ * yapilar uzerinde dolasir, pos yapiya isaretcidir. tip pos'tan
+ * alindigi icin yanlis tipe donusum yapilamaz.
+ */
+#define ilist_for_each_entry(pos,list,member)					\
+	for(pos = ilist_entry((list)->head.next,__typeof__(*pos),member);	\
+	    &pos->member != &(list)->head;					\
+	    pos = ilist_entry(pos->member.next,__typeof__(*pos),member))
+
+/* ayni, fakat dongu icinde pos listeden cikarilabilir */
+#define ilist_for_each_entry_safe(pos,tmp,list,member)				\
+	for(pos = ilist_entry((list)->head.next,__typeof__(*pos),member),	\
+	    tmp = ilist_entry(pos->member.next,__typeof__(*pos),member);	\
+	    &pos->member != &(list)->head;					\
+	    pos = tmp, tmp = ilist_entry(tmp->member.next,__typeof__(*pos),member))
+
+#endif /* __UNIQ_ILIST_H__ */
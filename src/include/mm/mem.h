@@ -69,15 +69,35 @@ typedef struct{
 #define FRAME_SIZE_KIB		4		/* 4 KiB */
 #define MAX_LIMIT		0xFFFFFFFF	/* 4 GiB */
 
+/*
+ * fiziksel aygit bellegi (apic, acpi tablolari) bu pencereye eslenir.
+ * pencerenin sayfa tablolari paging_final'da olusturulur, bu sayede
+ * sonradan yapilan eslemeler de klonlanan sayfa dizinlerinde gorunur.
+ */
+#define IOREMAP_BASE		0xF0000000
+#define IOREMAP_SIZE		0x01000000	/* 16 MiB */
+
+/*
+ * kullanici surecleri icin ayrilan sanal adres penceresi. altinda
+ * kernel (identity map) ve kernel heap'i, ustunde surecin kernel
+ * stack'i ve ioremap penceresi vardir. sistem cagrilarina verilen
+ * adresler bu pencerenin icinde olmalidir (user_access_check).
+ */
+#define USER_SPACE_START	0x20000000	/* KHEAP_END */
+#define USER_SPACE_END		0xDFFFC000	/* kernel stack'inin alti */
+
 #define FRAME_INDEX_BIT(x)	(x / 32)
 #define FRAME_OFFSET_BIT(x)	(x % 32)
 
 void free_frame(page_t *page);
 page_t *get_page(uint32_t addr,bool make,page_dir_t *dir);
 void change_page_dir(page_dir_t *new_dir);
+uint32_t virt_to_phys(uint32_t addr);
 void alloc_frame(page_t *page,bool rw,bool user);
 void dma_frame(page_t *page,bool rw,bool user,uintptr_t addr);
 uint32_t use_memory_size(void);
 uint32_t total_memory_size(void);
+void *ioremap(uint32_t phys_addr,uint32_t size);
+int32_t user_access_check(const void *addr,size_t size,bool write);
 
 #endif /* __UNIQ_MEM_H__ */
@@ -0,0 +1,104 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_RBTREE_H__
+#define __UNIQ_RBTREE_H__
+
+#include <uniq/types.h>
+
+#define RB_RED			0
+#define RB_BLACK		1
+
+/*
+ * ic ice (intrusive) kirmizi-siyah agac. dugum siralanacak yapinin
+ * icinde durur, ekleme/silme bellek ayirmaz. yapiya rb_entry ile
+ * ulasilir. en uzun yol en kisanin iki katini gecmez, arama, ekleme
+ * ve silme O(log n)'dir.
+ */
+typedef struct rb_node{
+	struct rb_node *parent;
+	struct rb_node *left;
+	struct rb_node *right;
+	uint32_t color;
+}rb_node_t;
+
+typedef struct{
+	rb_node_t *root;
+	uint32_t count;			/* dugum sayisi */
+}rb_root_t;
+
+#define RB_ROOT_INIT		{ NULL, 0 }
+
+#define rb_entry(node,type,member)	container_of(node,type,member)
+
+/* iki dugumu karsilastirir, a < b ise < 0, esitse 0, buyukse > 0 */
+typedef int32_t (*rb_cmp_t)(const rb_node_t *a,const rb_node_t *b);
+/* anahtari dugumle karsilastirir, anahtar kucukse < 0 */
+typedef int32_t (*rb_key_cmp_t)(const void *key,const rb_node_t *node);
+
+/*
+ * artirilmis (augmented) agac kancalari. dugumler alt agaclari
+ * hakkinda bir bilgi (en buyuk bitis adresi, alt agac boyutu, en kucuk
+ * vruntime...) tutuyorsa bu kancalar agac degistikce bu bilgiyi gunceller.
+ *
+ * propagate : node'dan baslayip stop'a (NULL ise koke) kadar her dugumun
+ *             bilgisini cocuklarindan yeniden hesaplar.
+ * rotate : dondurmede new, old'un yerini alir. new old'un eski bilgisini
+ *          devralir (alt agac ayni kume), old yeniden hesaplanir.
+ */
+typedef struct{
+	void (*propagate)(rb_node_t *node,rb_node_t *stop);
+	void (*rotate)(rb_node_t *old,rb_node_t *new);
+}rb_augment_t;
+
+/* tum dugumler uzerinde sirayla dolasir */
+#define rb_for_each(pos,root)						\
+	for(pos = rb_first(root); pos; pos = rb_next(pos))
+
+/* start dugumunden (ornegin rb_lower_bound) baslayarak sirayla dolasir */
+#define rb_for_each_from(pos,start)					\
+	for(pos = (start); pos; pos = rb_next(pos))
+
+static inline void rb_root_init(rb_root_t *root){
+
+	root->root = NULL;
+	root->count = 0;
+
+}
+
+static inline bool rb_empty(rb_root_t *root){
+
+	return root->root == NULL;
+
+}
+
+void rb_link_node(rb_node_t *node,rb_node_t *parent,rb_node_t **link);
+void rb_insert_color(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug);
+void rb_insert(rb_root_t *root,rb_node_t *node,rb_cmp_t cmp,const rb_augment_t *aug);
+void rb_erase(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug);
+rb_node_t *rb_first(rb_root_t *root);
+rb_node_t *rb_last(rb_root_t *root);
+rb_node_t *rb_next(rb_node_t *node);
+rb_node_t *rb_prev(rb_node_t *node);
+rb_node_t *rb_find(rb_root_t *root,const void *key,rb_key_cmp_t cmp);
+rb_node_t *rb_lower_bound(rb_root_t *root,const void *key,rb_key_cmp_t cmp);
+rb_node_t *rb_upper_bound(rb_root_t *root,const void *key,rb_key_cmp_t cmp);
+void __rbtree_test(void);
+
+#endif /* __UNIQ_RBTREE_H__ */
@@ -43,7 +43,9 @@ extern char *strrtok(char *s,const char *delim);
 extern int memcmp(const void *m1, const void *m2, size_t c);
 extern void *memcpy(void *dest, const void *src, size_t c);
 extern void *memset(void *s, int v, size_t c);
+extern void *memmove(void *dest, const void *src, size_t c);
 extern void *memscan(void *s, int v, size_t c);
+extern void *memchr(const void *s, int v, size_t c);
 extern char *strstr(const char *s1, const char *s2);
 extern char *strnstr(const char *s1, const char *s2, size_t len);
 extern char *strcasestr(const char *s1, const char *s2);
@@ -51,6 +53,8 @@ extern char *strncasestr(const char *s1, const char *s2, size_t len);
 extern char *strcat(char *dest, const char *src);
 extern char *strncat(char *dest, const char *src, size_t count);
 extern char * strdup(const char *string);
+extern void string_init(void);
+extern void __string_bench(void);
 
 #define strlchr(s,c)		strchr(s,c)
 #define strltok(s,delim)	strtok(s,delim)
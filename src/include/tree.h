@@ -21,14 +21,23 @@
 #define __UNIQ_TREE_H__
 
 #include <uniq/types.h>
-#include <list.h>
 
 #define TREE_SIGNATURE			0xCCD499AA
 
+/*
+ * ilk cocuk / sonraki kardes duzeni. dugum cocuklarini ayri bir listede
+ * tutmaz, her dugum kardeslerine ve ebeveynine dogrudan baglidir. dugum
+ * sahibi yapinin icine gomulebilir (tree_node_init), bu durumda agaca
+ * ekleme bellek ayirmaz. ebeveyn bulmak ve dugumu ayirmak O(1)'dir.
+ */
 typedef struct _tree_node_t{
 	struct _tree_node_t *parent;
-	list_t *child;
-	void *item;	
+	struct _tree_node_t *first_child;
+	struct _tree_node_t *last_child;	/* sona ekleme icin */
+	struct _tree_node_t *prev_sibling;
+	struct _tree_node_t *next_sibling;
+	uint32_t child_count;			/* dogrudan cocuk sayisi */
+	void *item;
 }tree_node_t;
 
 typedef struct{
@@ -37,20 +46,36 @@ typedef struct{
 	uint32_t node_count;
 }tree_t;
 
+/* dugumun dogrudan cocuklari uzerinde dolasir */
+#define tree_for_each_child(child,node)						\
+	for(child = (node)->first_child; child; child = child->next_sibling)
+
+/*
+ * root ve altindaki tum dugumler uzerinde ozyinelemesiz, on sirali
+ * (preorder) dolasir. dongu icinde agac degistirilmemelidir.
+ */
+#define tree_for_each(pos,root)							\
+	for(pos = (root); pos; pos = tree_node_next(pos,root))
+
 tree_t *tree_create(void);
+void tree_node_init(tree_node_t *node,void *item);
+tree_node_t *tree_node_next(tree_node_t *node,tree_node_t *root);
 void tree_node_free(tree_node_t *node);
 void tree_node_destroy(tree_node_t *node);
 void tree_free(tree_t *tree);
 void tree_destroy(tree_t *tree);
 uint32_t tree_total_node(tree_t *tree);
 uint32_t tree_child_count(tree_node_t *node);
+bool tree_node_is_ancestor(tree_node_t *ancestor,tree_node_t *node);
 tree_node_t *tree_node_search_parent(tree_node_t *start_node,tree_node_t *search);
 tree_node_t *tree_search_parent(tree_t *tree, tree_node_t *search);
 tree_node_t *tree_node_create(void *item);
+void tree_set_root(tree_t *tree,tree_node_t *root);
 tree_node_t *tree_set_root_node(tree_t *tree,void *item);
 void tree_push_child_node(tree_t *tree,tree_node_t *child,tree_node_t *parent);
 tree_node_t *tree_push_child(tree_t *tree,void *item,tree_node_t *parent);
 void tree_node_unlink(tree_node_t *node);
+void tree_node_reparent_children(tree_node_t *node,tree_node_t *new_parent);
 void tree_node_parent_merge(tree_t *tree,tree_node_t *node);
 void tree_parent_root(tree_t *tree,tree_node_t *node);
 void tree_node_parent_remove(tree_t *tree,tree_node_t *node,tree_node_t *parent);
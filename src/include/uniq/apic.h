@@ -0,0 +1,116 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_APIC_H__
+#define __UNIQ_APIC_H__
+
+#include <uniq/types.h>
+
+/* local apic yazmaclari (mmio tabanina gore) */
+#define LAPIC_ID		0x020
+#define LAPIC_VERSION		0x030
+#define LAPIC_TPR		0x080
+#define LAPIC_EOI		0x0B0
+#define LAPIC_SVR		0x0F0
+#define LAPIC_ESR		0x280
+#define LAPIC_ICR_LOW		0x300
+#define LAPIC_ICR_HIGH		0x310
+#define LAPIC_LVT_TIMER		0x320
+#define LAPIC_LVT_LINT0		0x350
+#define LAPIC_LVT_LINT1		0x360
+#define LAPIC_LVT_ERROR		0x370
+#define LAPIC_TIMER_INITIAL	0x380
+#define LAPIC_TIMER_CURRENT	0x390
+#define LAPIC_TIMER_DIVIDE	0x3E0
+
+#define LAPIC_TIMER_PERIODIC	0x20000
+#define LAPIC_TIMER_DIV16	0x3
+
+#define LAPIC_SVR_ENABLE	0x100
+#define LAPIC_SPURIOUS_VECTOR	0xFF
+#define LAPIC_LVT_MASKED	0x10000
+
+/* icr */
+#define ICR_FIXED		0x000
+#define ICR_INIT		0x500
+#define ICR_STARTUP		0x600
+#define ICR_DELIVERY_PENDING	0x1000
+#define ICR_ASSERT		0x4000
+#define ICR_LEVEL		0x8000
+
+/* io apic */
+#define IOAPIC_REGSEL		0x00
+#define IOAPIC_WINDOW		0x10
+#define IOAPIC_REG_ID		0x00
+#define IOAPIC_REG_VERSION	0x01
+#define IOAPIC_REG_REDTBL	0x10		/* her giris icin 2 yazmac */
+
+#define IOAPIC_POLARITY_LOW	0x2000
+#define IOAPIC_TRIGGER_LEVEL	0x8000
+#define IOAPIC_MASKED		0x10000
+
+#define IRQ_VECTOR_BASE		32		/* isa irq 0'in vektoru */
+
+extern volatile uint32_t *lapic_base;
+extern bool apic_enabled;
+extern volatile uint32_t lapic_spurious_count;	/* int.s, sahte kesme sayisi */
+
+/*
+ * lapic_read, local apic yazmacini okur.
+ *
+ * @param reg : yazmac
+ */
+static inline uint32_t lapic_read(uint32_t reg){
+
+	return lapic_base[reg / 4];
+
+}
+
+/*
+ * lapic_write, local apic yazmacina yazar.
+ *
+ * @param reg : yazmac
+ * @param val : deger
+ */
+static inline void lapic_write(uint32_t reg,uint32_t val){
+
+	lapic_base[reg / 4] = val;
+
+}
+
+bool lapic_init(void);
+void lapic_enable(void);
+uint32_t lapic_id(void);
+void lapic_send_ipi(uint32_t apic_id,uint32_t icr);
+
+/*
+ * lapic_eoi, local apic'e kesme sonu bildirir.
+ */
+static inline void lapic_eoi(void){
+
+	lapic_write(LAPIC_EOI,0);
+
+}
+
+void ioapic_mask_irq(uint8_t irq);
+void ioapic_unmask_irq(uint8_t irq);
+bool ioapic_set_affinity(uint8_t irq,uint32_t apic_id);
+void apic_init(void);
+
+#endif /* __UNIQ_APIC_H__ */
@@ -20,6 +20,7 @@
 #ifndef __UNIQ_INLINE_ASM_H__
 #define __UNIQ_INLINE_ASM_H__
 
+#include <uniq/types.h>
 #include <uniq/kern_debug.h>
 
 /* kesmeleri devre disi birak */
@@ -42,6 +43,48 @@ static inline void relax_cpu(void){
 	__asm__ volatile("rep; nop");
 }
 
+/* derleyicinin bellek erisimlerini bariyerin ustunden tasimasini engeller */
+static inline void barrier(void){
+	__asm__ volatile("" : : : "memory");
+}
+
+/*
+ * tam bellek bariyeri. x86'da sadece store->load sirasi bozulabilir,
+ * lock onekli bir komut bunu da engeller (mfence sse2 ister, i386'da
+ * olmayabilir). yazma/yazma ve okuma/okuma icin barrier() yeterlidir.
+ */
+static inline void mb(void){
+	__asm__ volatile("lock; addl $0,(%%esp)" : : : "memory");
+}
+
+/*
+ * kesmeleri ac ve bir sonraki kesmeye kadar bekle. sti'den sonraki
+ * komut kesmeye kapali oldugundan, kontrol ile hlt arasinda gelen
+ * bir kesme kaybolmaz.
+ */
+static inline void safe_halt(void){
+	__asm__ volatile("sti; hlt");
+}
+
+/* eflags'i kaydet ve kesmeleri devre disi birak */
+static inline uint32_t irq_save(void){
+	uint32_t flags;
+	__asm__ volatile("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+	return flags;
+}
+
+/* kaydedilen eflags'i geri yukle */
+static inline void irq_restore(uint32_t flags){
+	__asm__ volatile("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+}
+
+/* time stamp counter */
+static inline uint64_t rdtsc(void){
+	uint64_t tsc;
+	__asm__ volatile("rdtsc" : "=A"(tsc));
+	return tsc;
+}
+
 #define disable_irq()			cli()
 #define enable_irq()			sti()
 #define halt_system()			hlt()
@@ -0,0 +1,39 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_CLOCKSOURCE_H__
+#define __UNIQ_CLOCKSOURCE_H__
+
+#include <uniq/types.h>
+
+typedef struct{
+	char *name;			/* saat kaynagi ismi */
+	uint64_t (*read)(void);		/* sayaci okur */
+	uint32_t mult;			/* ns = (sayac * mult) >> shift */
+	uint32_t shift;
+	uint64_t base;			/* acilistaki sayac degeri */
+	uint32_t khz;			/* sayac frekansi (khz) */
+}clocksource_t;
+
+void clocksource_init(void);
+clocksource_t *clocksource_get(void);
+uint64_t clocksource_read_ns(void);
+void udelay(uint32_t usec);
+
+#endif /* __UNIQ_CLOCKSOURCE_H__ */
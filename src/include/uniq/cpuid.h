@@ -53,6 +53,20 @@ typedef struct{
 #define INTEL_SIGNATURE_ECX		0x6c65746e
 #define INTEL_SIGNATURE_EDX		0x49656e69
 
+/*
+ * islemci ozellikleri (cpuid 1). 0-31 arasi ecx, 32-63 arasi edx
+ * bitlerini gosterir.
+ */
+#define CPU_FEATURE_ECX(bit)		(bit)
+#define CPU_FEATURE_EDX(bit)		(32 + (bit))
+#define CPU_FEATURE_TSC			CPU_FEATURE_EDX(4)	/* time stamp counter */
+#define CPU_FEATURE_APIC		CPU_FEATURE_EDX(9)	/* local apic */
+#define CPU_FEATURE_FXSR		CPU_FEATURE_EDX(24)	/* fxsave/fxrstor */
+#define CPU_FEATURE_SSE			CPU_FEATURE_EDX(25)
+#define CPU_FEATURE_SSE2		CPU_FEATURE_EDX(26)
+
+bool cpu_has_feature(uint32_t feature);
+bool cpu_enable_sse(void);
 bool get_cpuid_info(cpuid_info_t *cpuid_info);
 void dump_cpuid_info(cpuid_info_t *cpuid_info);
 
@@ -0,0 +1,91 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_DIV64_H__
+#define __UNIQ_DIV64_H__
+
+#include <uniq/types.h>
+
+/*
+ * libgcc ile link etmedigimiz icin 64 bitlik bolme (__udivdi3) yoktur.
+ * 64 bitlik carpma ve kaydirma ise gcc tarafindan dogrudan uretilir.
+ */
+
+/*
+ * div_u64_rem, 64 bitlik sayiyi 32 bitlik sayiya boler. once ust 32
+ * bit bolunur, kalani ile alt 32 bit tek bir divl ile bolunur.
+ *
+ * @param dividend : bolunen
+ * @param divisor : bolen
+ * @param remainder : kalan (NULL olabilir)
+ */
+static inline uint64_t div_u64_rem(uint64_t dividend,uint32_t divisor,uint32_t *remainder){
+
+	uint32_t high = dividend >> 32;
+	uint32_t low = (uint32_t)dividend;
+	uint32_t quot_high = 0,upper = high,rem;
+
+	if(high){
+		upper = high % divisor;
+		quot_high = high / divisor;
+	}
+
+	__asm__("divl %2"
+		: "=a"(low), "=d"(rem)
+		: "rm"(divisor), "0"(low), "1"(upper));
+
+	if(remainder)
+		*remainder = rem;
+
+	return ((uint64_t)quot_high << 32) | low;
+
+}
+
+/*
+ * div_u64, kalansiz 64 bitlik bolme.
+ */
+static inline uint64_t div_u64(uint64_t dividend,uint32_t divisor){
+
+	return div_u64_rem(dividend,divisor,NULL);
+
+}
+
+/*
+ * mul_u64_u32_shr, (a * mul) >> shift islemini 64 bit tasmadan yapar.
+ * a ust ve alt 32 bite ayrilip ayri ayri carpilir. shift <= 32 olmalidir.
+ *
+ * @param a : 64 bitlik sayi
+ * @param mul : carpan
+ * @param shift : kaydirma
+ */
+static inline uint64_t mul_u64_u32_shr(uint64_t a,uint32_t mul,uint32_t shift){
+
+	uint32_t high = a >> 32;
+	uint32_t low = (uint32_t)a;
+	uint64_t ret;
+
+	ret = ((uint64_t)low * mul) >> shift;
+	if(high)
+		ret += ((uint64_t)high * mul) << (32 - shift);
+
+	return ret;
+
+}
+
+#endif /* __UNIQ_DIV64_H__ */
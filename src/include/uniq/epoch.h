@@ -0,0 +1,55 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_EPOCH_H__
+#define __UNIQ_EPOCH_H__
+
+#include <uniq/types.h>
+#include <uniq/smp.h>
+
+#define EPOCH_COUNT		3		/* gecerli, onceki ve bosaltilacak */
+#define EPOCH_POLL_THRESHOLD	32		/* bu kadar ertelemede bir ilerletmeyi dene */
+
+/*
+ * epoch tabanli geri kazanim (ebr). okuyucular kilit almadan veri
+ * yapisinda dolasir, yazarlar cikardiklari elemani hemen bosa cikarmaz,
+ * epoch_defer ile ertelerler. tum cpu'lar eleman cikarildiktan sonraki
+ * bir epoch'u gordugunde (iki ilerleme sonra) eleman hicbir okuyucu
+ * tarafindan tutulamaz ve fonksiyonu cagrilir.
+ */
+typedef struct epoch_head{
+	struct epoch_head *next;
+	void (*func)(struct epoch_head *head);	/* geri kazanim fonksiyonu */
+}epoch_head_t;
+
+typedef struct{
+	volatile uint32_t active;		/* okuma bolumu derinligi */
+	volatile uint32_t epoch;		/* okumaya girerken gorulen epoch */
+	uint32_t flags;				/* en distaki epoch_enter'in eflags'i */
+	uint32_t reclaimed;			/* en son bosaltilan epoch */
+	uint32_t pending;			/* bekleyen erteleme sayisi */
+	epoch_head_t *limbo[EPOCH_COUNT];	/* epoch'a gore ertelenenler */
+}epoch_cpu_t;
+
+void epoch_enter(void);
+void epoch_exit(void);
+void epoch_defer(epoch_head_t *head,void (*func)(epoch_head_t *head));
+bool epoch_poll(void);
+
+#endif /* __UNIQ_EPOCH_H__ */
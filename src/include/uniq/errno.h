@@ -27,6 +27,6 @@ typedef int32_t errno_t;
 /* 
  * hata tanimlamalari
  */
-#include <uniq/errno_list.>
+#include <uniq/errno_list.h>
 
 #endif /* __UNIQ_ERRNO_H__ */
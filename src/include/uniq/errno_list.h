@@ -20,5 +20,27 @@
 #ifndef __UNIQ_ERRNO_LIST_H__
 #define __UNIQ_ERRNO_LIST_H__
 
+/*
+ * kernel fonksiyonlari ve sistem cagrilari hata durumunda bu
+ * degerlerin negatifini dondurur. (ornegin -EAGAIN)
+ */
+#define EPERM		1	/* izin yok */
+#define ENOENT		2	/* dosya ya da dizin yok */
+#define ESRCH		3	/* surec yok */
+#define EINTR		4	/* sinyal ile kesildi */
+#define EIO		5	/* giris/cikis hatasi */
+#define E2BIG		7	/* arguman listesi cok uzun */
+#define EBADF		9	/* gecersiz dosya tanimlayicisi */
+#define ECHILD		10	/* cocuk surec yok */
+#define EAGAIN		11	/* tekrar deneyin */
+#define ENOMEM		12	/* bellek yetersiz */
+#define EACCES		13	/* erisim reddedildi */
+#define EFAULT		14	/* gecersiz adres */
+#define EBUSY		16	/* kaynak mesgul */
+#define EEXIST		17	/* zaten var */
+#define EINVAL		22	/* gecersiz arguman */
+#define ENOSYS		38	/* sistem cagrisi yok */
+#define ETIMEDOUT	110	/* zaman asimi */
+
 
 #endif /* __UNIQ_ERRNO_LIST_H__ */
@@ -0,0 +1,37 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_FUTEX_H__
+#define __UNIQ_FUTEX_H__
+
+#include <uniq/types.h>
+#include <uniq/time.h>
+
+#define FUTEX_WAIT		0
+#define FUTEX_WAKE		1
+
+#define FUTEX_HASH_BITS		8
+#define FUTEX_HASH_SIZE		(1 << FUTEX_HASH_BITS)	/* kova sayisi */
+
+void futex_init(void);
+int32_t futex_wait(uint32_t *uaddr,uint32_t val,const timespec_t *timeout);
+int32_t futex_wake(uint32_t *uaddr,uint32_t count);
+int32_t futex(uint32_t *uaddr,int32_t op,uint32_t val,const timespec_t *timeout);
+
+#endif /* __UNIQ_FUTEX_H__ */
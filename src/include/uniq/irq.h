@@ -0,0 +1,60 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_IRQ_H__
+#define __UNIQ_IRQ_H__
+
+#include <uniq/types.h>
+#include <uniq/regs.h>
+
+#define MAX_IRQ			16
+
+#define IRQF_SHARED		0x01		/* hat baska isleyicilerle paylasilabilir */
+
+/*
+ * irq isleyicisi kesme kendi aygitindan geldiyse IRQ_HANDLED, degilse
+ * IRQ_NONE dondurur. paylasilan hatta hicbir isleyici kesmeyi
+ * sahiplenmezse kesme sahte sayilir.
+ */
+typedef enum{
+	IRQ_NONE = 0,
+	IRQ_HANDLED
+}irq_return_t;
+
+typedef irq_return_t (*irq_func_t)(registers_t *regs,void *dev);
+
+/*
+ * irq_action, hatta bagli bir isleyicidir. aygit surucusunun kendi
+ * yapisinin icinde durur, kayit sirasinda bellek ayrilmaz. bu sayede
+ * heap'ten once (timer, seri port) de kullanilabilir.
+ */
+typedef struct irq_action{
+	struct irq_action *volatile next;	/* hattaki siradaki isleyici */
+	irq_func_t handler;			/* isleyici fonksiyon */
+	void *dev;				/* isleyiciye gonderilecek aygit verisi */
+	const char *name;			/* aygit adi (irq_stat tablosu) */
+	uint32_t flags;				/* IRQF_* */
+}irq_action_t;
+
+int32_t irq_request(uint8_t irq_num,irq_action_t *action,irq_func_t handler,uint32_t flags,
+									const char *name,void *dev);
+void irq_free(uint8_t irq_num,irq_action_t *action);
+size_t irq_action_names(uint8_t irq_num,char *buf,size_t size);
+
+#endif /* __UNIQ_IRQ_H__ */
@@ -0,0 +1,84 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_IRQ_STAT_H__
+#define __UNIQ_IRQ_STAT_H__
+
+#include <uniq/types.h>
+#include <uniq/asm.h>
+#include <uniq/smp.h>
+
+#define IRQ_STAT_VECTORS	256		/* idt vektor sayisi */
+
+/*
+ * kesme istatistikleri her cpu icin vektor basina tutulur. sayaclari
+ * sadece o cpu'nun kesme isleyicileri artirdigi icin kilit gerekmez.
+ * sureler tsc cinsindendir.
+ */
+typedef struct{
+	uint32_t count;			/* kesme sayisi */
+	uint32_t spurious;		/* sahte kesme sayisi */
+	uint64_t cycles;		/* isleyicide gecen toplam sure */
+	uint64_t max_cycles;		/* en uzun isleyici suresi */
+}irq_stat_t;
+
+/*
+ * isleyici suresini olcmek icin kesme girisinde stack'ta olusturulur.
+ * timer kesmesi gibi isleyici icinden surec degistirilirse sure
+ * switch_task'ta kapatilir, bu sayede diger sureclerin calistigi
+ * zaman isleyiciye yazilmaz.
+ */
+typedef struct irq_frame{
+	struct irq_frame *prev;		/* ic ice kesmede bir onceki cerceve */
+	uint64_t start;			/* giris zamani */
+	uint64_t end;			/* surec degistiyse cikis zamani, yoksa 0 */
+	uint32_t cpu;			/* kesmenin geldigi cpu */
+	bool eoi;			/* isleyici eoi'yi kendisi gonderdi mi? */
+}irq_frame_t;
+
+extern irq_stat_t irq_stats[MAX_CPUS][IRQ_STAT_VECTORS];
+
+/*
+ * irq_stat_enter, isleyici cagrilmadan once cerceveyi baslatir.
+ *
+ * @param frame : kesme cercevesi
+ * @param vector : kesme vektoru
+ */
+static inline void irq_stat_enter(irq_frame_t *frame,uint32_t vector){
+
+	cpu_t *cpu = this_cpu();
+
+	frame->prev = cpu->irq_frame;
+	frame->cpu = cpu->id;
+	frame->end = 0;
+	frame->eoi = false;
+	cpu->irq_frame = frame;
+	irq_stats[cpu->id][vector].count++;
+	frame->start = rdtsc();
+
+}
+
+void irq_stat_exit(irq_frame_t *frame,uint32_t vector);
+void irq_stat_switch(void);
+void irq_stat_spurious(uint32_t vector);
+void irq_stat_reset(void);
+size_t irq_stat_read(char *buf,size_t size);
+void irq_stat_dump(void);
+
+#endif /* __UNIQ_IRQ_STAT_H__ */
@@ -20,6 +20,7 @@
 #ifndef __UNIQ_KERN_DEBUG_H__
 #define __UNIQ_KERN_DEBUG_H__
 
+#include <compiler.h>
 #include <uniq/kern_lvls.h>
 #include <uniq/kernel.h>
 
@@ -28,7 +29,7 @@ typedef enum{
 	KERN_DEBUG_OOPS		/* bilgilendirme log durumlari haric. */
 }kern_debug_mode_t;
 
-void _debug_print(char *file,uint32_t line,kern_levels_t level,const char *fmt,...);
+void _debug_print(char *file,uint32_t line,kern_levels_t level,const char *fmt,...) __printf(4,5);
 
 /* modul ismi */
 #ifndef MODULE_NAME
@@ -44,7 +45,8 @@ void _debug_print(char *file,uint32_t line,kern_levels_t level,const char *fmt,.
 	#define DEBUG_MODE
 	#define debug_print(level,...)		_debug_print(MODULE_NAME,MODULE_LINE,level,__VA_ARGS__)
 #else
-	#define debug_print(level,...)
+	/* kod uretmez fakat format yine de derleyici tarafindan denetlenir */
+	#define debug_print(level,...)		do{ if(0) _debug_print(MODULE_NAME,MODULE_LINE,level,__VA_ARGS__); }while(0)
 #endif
 
 #endif /* __UNIQ_KERN_DEBUG_H__ */
@@ -38,21 +38,23 @@
  */
 #include <drivers/vga.h>
 #include <drivers/pit.h>
+#include <drivers/serial.h>
+#include <drivers/lfb_graph.h>
 
 /* 
  * kprintf.c 
  */
-extern int vsnprintf(char *strbuf, size_t n , const char *fmt, va_list args);
-extern int vsprintf(char *strbuf, const char *fmt, va_list args);
-extern int sprintf(char *buf, const char *fmt, ...);
-extern int snprintf(char *buf, size_t n, const char *fmt, ...);
-extern int printf(const char *fmt, ...);
+extern int vsnprintf(char *strbuf, size_t n , const char *fmt, va_list args) __printf(3,0);
+extern int vsprintf(char *strbuf, const char *fmt, va_list args) __printf(2,0);
+extern int sprintf(char *buf, const char *fmt, ...) __printf(2,3);
+extern int snprintf(char *buf, size_t n, const char *fmt, ...) __printf(3,4);
+extern int printf(const char *fmt, ...) __printf(1,2);
 
 /*
  * panic.c & debug
  */
 #include <uniq/kern_debug.h>
-void die(const char *fmt, ...);
+void die(const char *fmt, ...) __printf(1,2);
 void _assert(const char *err,const char *file,uint32_t line_no);
 #define assert(statement) 	(statement) ? ((void)0) : _assert(#statement,__FILE__,__LINE__)
 
@@ -60,18 +62,21 @@ void _assert(const char *err,const char *file,uint32_t line_no);
  * arch/i386
  */
 #include <uniq/regs.h>
+#include <uniq/irq.h>
 extern void gdt_init(void);
-extern void gdt_set_gate(size_t num,uint32_t base,uint32_t limit,uint8_t access,uint8_t gran);
+extern void gdt_set_gate(uint32_t cpu,size_t num,uint32_t base,uint32_t limit,uint8_t access,uint8_t gran);
 extern void idt_init(void);
+extern void idt_load_cpu(void);
 extern void idt_set_gate(uint8_t num,void (*base)(void),uint16_t sel,uint8_t flags);
 extern void isr_init(void);
 extern void isr_add_handler(uint8_t isr_num, int_handler_t handler);
 extern void isr_remove_handler(uint8_t isr_num);
 extern void __int_test(void);
+extern void __int_bench(void);
 extern void irq_init(void);
 extern void irq_eoi(uint8_t irq_num);
-extern void irq_add_handler(uint8_t irq_num, int_handler_t handler);
-extern void irq_remove_handler(uint8_t irq_num);
+extern void irq_enable_apic(bool imcr);
+extern bool irq_set_affinity(uint8_t irq_num,uint32_t cpu);
 
 /*
  * mm
@@ -95,6 +100,8 @@ void free(void *ptr);
 /*
  * task
  */
-void multitasking_init(void);
+void multitasking_init(uint32_t stack_ptr);
+void switch_task(void);
+void syscall_init(void);
 
 #endif /* __UNIQ_KERNEL_H__ */
@@ -0,0 +1,84 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_KLOG_H__
+#define __UNIQ_KLOG_H__
+
+#include <uniq/types.h>
+#include <uniq/kern_lvls.h>
+#include <va_list.h>
+#include <compiler.h>
+
+#define KLOG_RECORDS		256			/* halka kayit sayisi (2'nin kuvveti) */
+#define KLOG_MASK		(KLOG_RECORDS - 1)
+#define KLOG_MSG_SIZE		160			/* kayit basina en fazla mesaj uzunlugu */
+#define KLOG_LINE_SIZE		(KLOG_MSG_SIZE + 96)	/* bicimlendirilmis kayit (baslik + mesaj) */
+
+/*
+ * syslog sistem cagrisi islemleri (linux ile ayni numaralar)
+ */
+#define SYSLOG_ACTION_READ_ALL		3
+#define SYSLOG_ACTION_SIZE_UNREAD	9
+#define SYSLOG_ACTION_SIZE_BUFFER	10
+
+typedef struct{
+	volatile uint32_t seq;			/* kayit numarasi + 1, 0 ise yaziliyor */
+	uint8_t level;				/* kern_levels_t */
+	uint16_t len;				/* mesaj uzunlugu */
+	uint32_t line;				/* kaynak satiri */
+	const char *file;			/* kaynak dosya (MODULE_NAME) */
+	uint64_t time_ns;			/* clocksource zamani */
+	char text[KLOG_MSG_SIZE];		/* mesaj */
+}klog_record_t;
+
+/*
+ * log cikisi (vga konsol, seri port). kayitlar klog_flush sirasinda,
+ * konsol kilidi tutulurken ve kesmeler kapaliyken sirayla tum
+ * cikislara gonderilir.
+ */
+typedef struct{
+	const char *name;			/* cikis ismi */
+	void (*write)(const klog_record_t *record);	/* kaydi basar */
+	void (*panic)(void);			/* kesmesiz (polling) moda gecer, NULL olabilir */
+	kern_levels_t level;			/* basilacak en dusuk seviye */
+}klog_sink_t;
+
+#define KLOG_MAX_SINKS		4
+
+typedef struct{
+	uint32_t written;			/* yazilan kayit */
+	uint32_t overwritten;			/* konsola basilmadan ezilen kayit */
+	uint32_t batches;			/* konsol bosaltma sayisi */
+	uint32_t rendered;			/* en az bir cikisa basilan kayit */
+}klog_stat_t;
+
+void klog_write(const char *file,uint32_t line,kern_levels_t level,const char *fmt,va_list args) __printf(4,0);
+bool klog_read(uint32_t *seq,klog_record_t *record);
+uint32_t klog_first_seq(void);
+uint32_t klog_next_seq(void);
+uint32_t klog_format(const klog_record_t *record,char *buf,size_t size);
+void klog_flush(void);
+bool klog_register_sink(klog_sink_t *sink);
+void klog_panic(void);
+void klog_set_console_level(kern_levels_t level);
+void klog_stat(klog_stat_t *stat);
+int32_t klog_syslog(int32_t type,char *buf,int32_t len);
+void dmesg(void);
+
+#endif /* __UNIQ_KLOG_H__ */
@@ -0,0 +1,45 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_KPRINTF_H__
+#define __UNIQ_KPRINTF_H__
+
+#include <uniq/types.h>
+#include <va_list.h>
+#include <compiler.h>
+
+/*
+ * bicimlendirme hedefi. kvprintf ciktiyi [base,end) penceresine
+ * dogrudan yazar, pencere doldugunda flush cagrilir. flush
+ * [base,pos) araligini tuketip yeni bir pencere vermelidir. tampon
+ * ve konsol ayni motoru kullanir.
+ */
+typedef struct kprintf_sink{
+	char *pos;				/* siradaki karakterin yeri */
+	char *base;				/* pencerenin basi */
+	char *end;				/* pencerenin sonu */
+	size_t count;				/* onceki pencerelerde uretilen karakter */
+	void (*flush)(struct kprintf_sink *sink);
+}kprintf_sink_t;
+
+int kvprintf(kprintf_sink_t *sink,const char *fmt,va_list args) __printf(2,0);
+int vprintf(const char *fmt,va_list args) __printf(1,0);
+void __kprintf_bench(void);
+
+#endif /* __UNIQ_KPRINTF_H__ */
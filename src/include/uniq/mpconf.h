@@ -0,0 +1,67 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_MPCONF_H__
+#define __UNIQ_MPCONF_H__
+
+#include <uniq/types.h>
+#include <uniq/smp.h>
+
+#define MAX_IOAPICS		4
+#define MAX_IRQ_OVERRIDES	16
+
+/* kesme kaynagi flaglari (acpi madt ve mp tablosunda ayni) */
+#define MP_IRQ_POLARITY_MASK	0x3
+#define MP_IRQ_POLARITY_LOW	0x3
+#define MP_IRQ_TRIGGER_MASK	0xC
+#define MP_IRQ_TRIGGER_LEVEL	0xC
+
+typedef struct{
+	uint8_t id;			/* io apic id */
+	uint32_t addr;			/* fiziksel mmio adresi */
+	uint32_t gsi_base;		/* ilk global sistem kesmesi */
+}ioapic_info_t;
+
+typedef struct{
+	uint8_t irq;			/* isa irq numarasi */
+	uint32_t gsi;			/* baglandigi global sistem kesmesi */
+	uint16_t flags;			/* polarite ve tetikleme */
+}irq_override_t;
+
+/*
+ * firmware'in (acpi madt ya da mp tablosu) bildirdigi islemci ve
+ * kesme denetleyicisi bilgileri.
+ */
+typedef struct{
+	const char *source;			/* "acpi", "mp" ya da NULL */
+	uint32_t lapic_addr;			/* local apic fiziksel adresi */
+	uint32_t ncpus;
+	uint8_t apic_ids[MAX_CPUS];		/* etkin cpu'larin apic id'leri */
+	uint32_t nioapics;
+	ioapic_info_t ioapics[MAX_IOAPICS];
+	uint32_t noverrides;
+	irq_override_t overrides[MAX_IRQ_OVERRIDES];
+	bool imcr;				/* pic modu, imcr ile gecilmeli */
+}mpconf_t;
+
+extern mpconf_t mpconf;
+
+bool mpconf_detect(void);
+
+#endif /* __UNIQ_MPCONF_H__ */
@@ -30,10 +30,11 @@
 #define MULTIBOOT_FLAG_AOUT    		0x010
 #define MULTIBOOT_FLAG_ELF     		0x020
 #define MULTIBOOT_FLAG_MEMMAP    	0x040
-#define MULTIBOOT_FLAG_CONFIG  		0x080
-#define MULTIBOOT_FLAG_LOADER  		0x100
-#define MULTIBOOT_FLAG_APM     		0x200
-#define MULTIBOOT_FLAG_VBE     		0x400
+#define MULTIBOOT_FLAG_DRIVES		0x080
+#define MULTIBOOT_FLAG_CONFIG  		0x100
+#define MULTIBOOT_FLAG_LOADER  		0x200
+#define MULTIBOOT_FLAG_APM     		0x400
+#define MULTIBOOT_FLAG_VBE     		0x800
 
 typedef struct{
 	uint32_t flags;
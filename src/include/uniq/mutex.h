@@ -0,0 +1,52 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_MUTEX_H__
+#define __UNIQ_MUTEX_H__
+
+#include <uniq/types.h>
+#include <uniq/proc.h>
+#include <uniq/wait.h>
+
+/*
+ * semafor ve mutex, spin_lock'tan farkli olarak kilit alinamadiginda
+ * cpu'yu mesgul etmez, surec bekleme kuyrugunda uyutulur.
+ */
+typedef struct{
+	int32_t count;			/* kalan kaynak sayisi */
+	wait_queue_t wait;		/* bekleyen surecler */
+}semaphore_t;
+
+typedef struct{
+	uint32_t locked;		/* 1 ise kilitli */
+	process_t *owner;		/* kilidi tutan surec */
+	wait_queue_t wait;		/* bekleyen surecler */
+}mutex_t;
+
+void sema_init(semaphore_t *sema,int32_t count);
+void sema_down(semaphore_t *sema);
+bool sema_trydown(semaphore_t *sema);
+void sema_up(semaphore_t *sema);
+
+void mutex_init(mutex_t *mutex);
+void mutex_lock(mutex_t *mutex);
+bool mutex_trylock(mutex_t *mutex);
+void mutex_unlock(mutex_t *mutex);
+
+#endif /* __UNIQ_MUTEX_H__ */
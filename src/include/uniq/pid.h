@@ -0,0 +1,34 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_PID_H__
+#define __UNIQ_PID_H__
+
+#include <uniq/types.h>
+
+#define PID_MAX			32768		/* en fazla surec sayisi */
+#define PID_IDLE		0		/* kernel bos sureci */
+#define PID_BITMAP_WORDS	(PID_MAX / 32)
+
+void pid_init(void);
+pid_t pid_alloc(void);
+void pid_free(pid_t pid);
+bool pid_is_used(pid_t pid);
+
+#endif /* __UNIQ_PID_H__ */
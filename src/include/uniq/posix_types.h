@@ -30,5 +30,7 @@ typedef signed int 	ssize_t;
 
 typedef signed int 	pid_t;
 
+typedef signed int 	clockid_t;
+
 
 #endif /* __UNIQ_POSIX_TYPES_H__ */
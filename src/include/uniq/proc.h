@@ -21,18 +21,33 @@
 #define __UNIQ_PROC_H__
 
 #include <uniq/types.h>
+#include <compiler.h>
 #include <mm/mem.h>
+#include <ilist.h>
+#include <tree.h>
 
 #define PROCESS_STARTED			0x1
 #define PROCESS_RUNNING			0x2
 #define PROCESS_FINISHED		0x4
+#define PROCESS_SLEEPING		0x8
 #define PROCESS_PREUMASK		022
+#define PROCESS_MAP_SIZE		1024		/* pid hashmap boyutu */
 
+#define WNOHANG				0x1		/* waitpid, bekleme */
+
+/*
+ * kernel/asm.s thread_save ve thread_restore alanlarin sirasina
+ * gore calisir, sirayi degistirmeyin.
+ */
 typedef struct{
 	uint32_t ebp;			/* base pointer */
 	uint32_t esp;			/* stack pointer */
 	uint32_t eip;			/* instruction pointer */
 	page_dir_t *page_dir;		/* sayfa dizini */
+	uint32_t ebx;			/* callee-saved kaydediciler */
+	uint32_t esi;
+	uint32_t edi;
+	uint32_t kernel_stack;		/* kernel stack'in ustu, tss.esp0 */
 }thread_t;
 
 typedef struct{
@@ -44,7 +59,42 @@ typedef struct{
 	thread_t thread;		/* thread */
 	uint32_t flags;			/* flaglar */
 	uint32_t umask;	
+	uint32_t signal_pending;	/* bekleyen sinyaller (bit maskesi) */
+	int32_t exit_code;		/* cikis kodu */
+	uint32_t last_cpu;		/* en son calistigi cpu (yumusak baglilik) */
+
+	tree_node_t tree_node;		/* process_tree dugumu */
+	ilist_node_t sched_node;	/* runqueue inbox/bekleme kuyrugu dugumu */
+	ilist_node_t list_node;		/* process_list dugumu */
 }process_t;
 
+extern process_t *current_process;
+extern process_t *idle_process;
+extern ilist_t process_list;
+extern ilist_t process_sleep_queue;
+extern tree_t *process_tree;
+extern uint32_t process_orphans_finished;
+
+extern int32_t thread_save(thread_t *thread) __returns_twice;
+extern void thread_restore(thread_t *thread,uint32_t page_dir_phys) __noreturn;
+
+void process_init(void);
+process_t *process_alloc(void);
+void process_attach(process_t *process,process_t *parent);
+void process_reparent_children(process_t *process);
+void process_reap(process_t *process);
+process_t *process_next(void);
+void process_prepare_sleep(void);
+void process_sleep(void);
+void process_wakeup(process_t *process);
+process_t *process_from_pid(pid_t pid);
+int32_t process_register(process_t *process);
+void process_unregister(process_t *process);
+void process_idle(void);
+
+pid_t fork(void);
+void exit(int32_t status) __noreturn;
+pid_t waitpid(pid_t pid,int32_t *status,int32_t options);
+void __fork_bench(void);
 
 #endif /* __UNIQ_PROC_H__ */
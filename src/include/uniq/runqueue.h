@@ -0,0 +1,78 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_RUNQUEUE_H__
+#define __UNIQ_RUNQUEUE_H__
+
+#include <uniq/types.h>
+#include <uniq/spin_lock.h>
+#include <uniq/smp.h>
+#include <uniq/proc.h>
+#include <ilist.h>
+
+#define RQ_DEQUE_SIZE		256		/* 2'nin kuvveti olmali */
+#define RQ_DEQUE_MASK		(RQ_DEQUE_SIZE - 1)
+#define RQ_STEAL_RETRIES	4		/* cas yarisi kaybedilince tekrar */
+
+/*
+ * Chase-Lev is calma kuyrugu. sadece sahibi olan cpu bottom'a ekler,
+ * herkes (sahibi dahil) top'tan cas ile alir. sabit boyutludur, dolunca
+ * surecler cpu'nun gelen kutusuna (inbox) tasar.
+ */
+typedef struct{
+	volatile uint32_t top;			/* bir sonraki alinacak eleman */
+	volatile uint32_t bottom;		/* bir sonraki eklenecek yuva */
+	process_t *volatile slots[RQ_DEQUE_SIZE];
+}wsdeque_t;
+
+/*
+ * dengeleme istatistikleri. her sayaci sadece sahibi olan cpu artirir,
+ * bu yuzden atomik islem gerekmez.
+ */
+typedef struct{
+	uint32_t enqueued;			/* yerel kuyruga eklenen */
+	uint32_t remote;			/* baska cpu'nun inbox'ina gonderilen */
+	uint32_t dequeued;			/* yerel kuyruktan alinan */
+	uint32_t steals;			/* baska cpu'dan calinan */
+	uint32_t steal_aborts;			/* cas yarisi kaybedilen calma */
+	uint32_t migrations;			/* calinip cpu degistiren surec */
+	uint32_t idle;				/* hicbir yerde is bulunamayan secim */
+}rq_stat_t;
+
+typedef struct{
+	wsdeque_t deque;			/* kilitsiz hazir kuyrugu */
+	spinlock_t inbox_lock;
+	ilist_t inbox;				/* uzak uyandirmalar ve tasanlar (sched_node) */
+	volatile uint32_t active;		/* cpu zamanlayiciyi calistiriyor mu? */
+	rq_stat_t stat;
+}runqueue_t;
+
+extern runqueue_t runqueues[MAX_CPUS];
+
+void runqueue_init(void);
+void runqueue_activate(uint32_t cpu);
+void runqueue_enqueue(process_t *process);
+void runqueue_requeue(process_t *process);
+process_t *runqueue_dequeue(void);
+uint32_t runqueue_load(uint32_t cpu);
+bool runqueue_pending(void);
+void runqueue_stat_reset(void);
+void runqueue_stat_dump(void);
+
+#endif /* __UNIQ_RUNQUEUE_H__ */
@@ -20,5 +20,30 @@
 #ifndef __UNIQ_SIGNAL_H__
 #define __UNIQ_SIGNAL_H__
 
+#include <uniq/types.h>
+
+#define SIGHUP		1
+#define SIGINT		2
+#define SIGQUIT		3
+#define SIGILL		4
+#define SIGTRAP		5
+#define SIGABRT		6
+#define SIGBUS		7
+#define SIGFPE		8
+#define SIGKILL		9
+#define SIGUSR1		10
+#define SIGSEGV		11
+#define SIGUSR2		12
+#define SIGPIPE		13
+#define SIGALRM		14
+#define SIGTERM		15
+#define SIGCHLD		17
+#define SIGCONT		18
+#define SIGSTOP		19
+#define NSIG		32
+
+#define signal_mask(sig)	(0x1 << ((sig) - 1))
+
+int32_t kill(pid_t pid,int32_t sig);
 
 #endif /* __UNIQ_SIGNAL_H__ */
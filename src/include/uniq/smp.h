@@ -0,0 +1,74 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_SMP_H__
+#define __UNIQ_SMP_H__
+
+#include <uniq/types.h>
+#include <uniq/tss.h>
+
+#define MAX_CPUS		8
+#define CPU_STACK_SIZE		0x4000		/* ap kernel stack boyutu */
+
+/*
+ * her cpu'nun kendi gdt'si vardir fakat selektorler hepsinde aynidir.
+ * GDT_PERCPU segmentinin tabani cpu'nun cpu_t yapisini gosterir ve
+ * kernelde %gs her zaman bu selektoru tutar.
+ */
+#define GDT_ENTRIES		7
+#define GDT_KERNEL_CODE		0x08
+#define GDT_KERNEL_DATA		0x10
+#define GDT_USER_CODE		0x18
+#define GDT_USER_DATA		0x20
+#define GDT_PERCPU		0x28
+#define GDT_TSS			0x30
+
+typedef struct cpu{
+	struct cpu *self;		/* %gs:0, this_cpu() bunu okur */
+	uint32_t id;			/* mantiksal cpu numarasi, 0 = bsp */
+	uint32_t apic_id;		/* local apic id */
+	volatile uint32_t online;	/* cpu calisiyor mu? */
+	uint32_t stack;			/* kernel stack'inin ust adresi */
+	tss_entry_t tss;		/* cpu'ya ait tss */
+	struct irq_frame *irq_frame;	/* calisan kesme isleyicisi (uniq/irq_stat.h) */
+}cpu_t;
+
+extern cpu_t cpus[MAX_CPUS];
+extern uint32_t cpu_count;		/* bulunan cpu sayisi */
+extern volatile uint32_t cpu_online;	/* calisan cpu sayisi */
+
+/*
+ * this_cpu, calisan cpu'nun cpu_t yapisini dondurur.
+ */
+static inline cpu_t *this_cpu(void){
+
+	cpu_t *cpu;
+
+	__asm__ volatile("movl %%gs:0, %0" : "=r"(cpu));
+
+	return cpu;
+
+}
+
+#define smp_processor_id()	(this_cpu()->id)
+
+void gdt_init_cpu(cpu_t *cpu);
+void smp_init(void);
+
+#endif /* __UNIQ_SMP_H__ */
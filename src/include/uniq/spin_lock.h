@@ -20,7 +20,6 @@
 #ifndef __UNIQ_SPIN_LOCK_H__
 #define __UNIQ_SPIN_LOCK_H__
 
-
 /*
  * spin_lock, ayni anda birden fazla process calistirabilen isletim sistemleri
  * icin onemli. mesela 1. process'imiz disk'e veri yaziyor ve o anda baska bir
@@ -30,55 +29,486 @@
  * (spin_unlock) kaldirir ve diger process isini yapmaya baslar. spin_lock durumda
  * cpu baya yorulur fakat kullanmak zorundayiz.
  *
- * kulladigimiz bu fonksiyonlar(__sync_lock_test_and_set,__sync_lock_release) 
- * yada her ne dersek diyelim buyuk ihtimal makrodur.
+ * kulladigimiz bu fonksiyonlar(__sync_fetch_and_add,__sync_lock_test_and_set)
+ * gcc'nin atomik islemleridir, x86'da lock onekli tek bir komuta donusurler.
  *
  * ornek vermek gerekirse iki process'de ayni fonksiyona cagri yapsin 
  *
  * ------------------------------------------------------------------------------------
- * uint32_t lock = 0; // kilit olacak degisken 
- *
- * // degiskenin adresini veriyoruz,ve spin_lock fonksiyonunu icini inceledigimizde
- * // lock degerini inceliyor eger 0 ise kilit yok , degerini 1 yaparak kilit
- * // olusturuluyor.
- * // diger process'de bu fonksiyonu cagriacak ve spin_lock ile lock'un adresini
- * // gonderiyor ve kontrol ediyor eger adresteki deger 0 degilse yani kilit varsa
- * // 0 olana (kilit kalkana) kadar 2. process beklemek zorunda,ilk process lock degerini 
- * // 0 yaptigi an(kilidi kaldirdiginda) diger process girdigi kontrol dongusunden cikar.
+ * spinlock_t lock = SPIN_LOCK_UNLOCKED("ornek"); // kilit olacak degisken 
+ *
+ * // degiskenin adresini veriyoruz. spin_lock bir bilet (next) alir ve sirasi
+ * // (owner) gelene kadar bekler. diger process'de bu fonksiyonu cagirdiginda
+ * // ondan sonraki bileti alir, ilk process kilidi kaldirdiginda (owner bir
+ * // artirildiginda) sira ona gelir ve girdigi kontrol dongusunden cikar.
+ * // bu sayede kilidi bekleyenler geldikleri sirayla kilidi alirlar.
  * // arastirmalarim sonucu boyle bir aciklama ortaya cikardim ;). yararli bir kaynak
  * // olmasi dilegimle.
  *
  * spin_lock(&lock); 
  * // ...
- * spin_unlock(&lock); // deger 0 yapilarak kilit kalkiyor.
+ * spin_unlock(&lock); // owner bir artirilarak kilit kalkiyor.
  *
  * ------------------------------------------------------------------------------------
  *
  */
- 
+
+
+#include <uniq/types.h>
+#include <uniq/asm.h>
+
+/*
+ * LOCK_STAT tanimlanirsa her spinlock_t, mcs_lock_t ve rwlock_t, kac kez
+ * alindigini, kac kez beklemek zorunda kalindigini, beklerken harcanan ve
+ * kilit tutulurken gecen en uzun sureyi (tsc cinsinden) tutar. sicak kilitleri bulmak
+ * icin lock_stat_dump() kullanilir. kapaliyken ek maliyeti yoktur.
+ */
+/* #define LOCK_STAT */
+
+#ifdef LOCK_STAT
+typedef struct lock_stat{
+	const char *name;		/* kilit ismi */
+	uint32_t registered;		/* listeye eklendi mi? */
+	uint32_t acquired;		/* alinma sayisi */
+	uint32_t contended;		/* beklenerek alinma sayisi */
+	uint64_t spin_cycles;		/* beklemede gecen toplam sure */
+	uint64_t hold_start;		/* son alinma zamani */
+	uint64_t hold_max;		/* en uzun tutulma suresi */
+	struct lock_stat *next;		/* kayitli kilitler listesi */
+}lock_stat_t;
+
+#define LOCK_STAT_INIT(lock_name)	, { .name = lock_name }
+
+void lock_stat_acquired(lock_stat_t *stat,uint64_t spin_start,bool contended);
+void lock_stat_released(lock_stat_t *stat);
+void lock_stat_reset(void);
+void lock_stat_dump(void);
+#else
+#define LOCK_STAT_INIT(lock_name)
+#endif
+
+/*
+ * bilet kilidi (ticket lock). kilidi isteyen next'i atomik olarak
+ * artirarak bir bilet alir ve owner biletine esit olana kadar bekler.
+ * test-and-set'ten farkli olarak kilit geldigi sirayla verilir, bekleyen
+ * biri ac kalmaz.
+ */
+typedef struct{
+	union{
+		volatile uint32_t slock;
+		struct{
+			volatile uint16_t owner;	/* kilidi tutan bilet */
+			volatile uint16_t next;		/* siradaki bos bilet */
+		}tickets;
+	}raw;
+#ifdef LOCK_STAT
+	lock_stat_t stat;
+#endif
+}spinlock_t;
+
+#define SPIN_LOCK_UNLOCKED(lock_name)	{ { 0 } LOCK_STAT_INIT(lock_name) }
+
+/*
+ * spin_lock_init, kilidi acik olarak hazirlar.
+ *
+ * @param lock : kilit
+ */
+static inline void spin_lock_init(spinlock_t *lock){
+
+	lock->raw.slock = 0;
+#ifdef LOCK_STAT
+	lock->stat = (lock_stat_t){ .name = "[unnamed lock]" };
+#endif
+
+}
+
+/*
+ * spin_lock_break, tutuluyor olabilecek kilidi zorla acar. panik
+ * yollarinda, kilidi tutan islemci bir daha donmeyecekken kullanilir.
+ * yalnizca biletler sifirlanir, LOCK_STAT kaydi ve sayaclari korunur.
+ *
+ * @param lock : kilit
+ */
+static inline void spin_lock_break(spinlock_t *lock){
+
+	lock->raw.slock = 0;
+	__asm__ volatile("" : : : "memory");
+
+}
 
 /*
  * spin_lock,kilit olustur
  *
- * @param lock_addr : kilit olusturulacak adres
+ * @param lock : kilit
  */
-static void spin_lock(uint32_t volatile *lock_addr){
-  
-  	while(__sync_lock_test_and_set(lock_addr, 0x1));
-  	
+static inline void spin_lock(spinlock_t *lock){
+
+	uint16_t ticket = __sync_fetch_and_add(&lock->raw.tickets.next,1);
+#ifdef LOCK_STAT
+	uint64_t spin_start = rdtsc();
+	bool contended = lock->raw.tickets.owner != ticket;
+#endif
+
+	while(lock->raw.tickets.owner != ticket)
+		relax_cpu();
+
+	__asm__ volatile("" : : : "memory");
+#ifdef LOCK_STAT
+	lock_stat_acquired(&lock->stat,spin_start,contended);
+#endif
+
 }
-  
+
 /*
- * spin_unlock,kilidi kaldir
+ * spin_trylock, kilit bossa alir ve true dondurur, beklemez.
  *
- * @param lock_addr : kilidi kaldirilacak adres
+ * @param lock : kilit
  */
-static void spin_unlock(uint32_t volatile *lock_addr){
+static inline bool spin_trylock(spinlock_t *lock){
+
+	uint32_t old = lock->raw.slock;
+	uint16_t owner = old & 0xFFFF;
+
+	if(owner != (old >> 16))
+		return false;
+
+	/* next 0xFFFF'ten tasarsa ust 16 bit 0'a doner, owner'a dokunulmaz */
+	if(!__sync_bool_compare_and_swap(&lock->raw.slock,old,(old + 0x10000)))
+		return false;
+
+#ifdef LOCK_STAT
+	lock_stat_acquired(&lock->stat,0,false);
+#endif
+
+	return true;
+
+}
   
-  	__sync_lock_release(lock_addr);
-  	
+/*
+ * spin_unlock,kilidi kaldir. owner'i sadece kilidi tutan degistirdigi
+ * icin 16 bitlik atomik artirma yeterlidir.
+ *
+ * @param lock : kilit
+ */
+static inline void spin_unlock(spinlock_t *lock){
+
+#ifdef LOCK_STAT
+	lock_stat_released(&lock->stat);
+#endif
+	__sync_fetch_and_add(&lock->raw.tickets.owner,1);
+
+}
+
+/*
+ * spin_is_locked, kilit tutuluyor mu?
+ *
+ * @param lock : kilit
+ */
+static inline bool spin_is_locked(spinlock_t *lock){
+
+	uint32_t val = lock->raw.slock;
+
+	return (val & 0xFFFF) != (val >> 16);
+
 }
 
+/*
+ * spin_lock_irqsave, kesmeleri kapatip kilidi alir ve onceki eflags'i
+ * dondurur. kesme isleyicilerinden de alinan kilitlerde kullanilmalidir,
+ * aksi halde kilidi tutan koda gelen kesme ayni kilidi beklerken sonsuza
+ * kadar doner.
+ *
+ * @param lock : kilit
+ */
+static inline uint32_t spin_lock_irqsave(spinlock_t *lock){
+
+	uint32_t flags = irq_save();
+
+	spin_lock(lock);
+
+	return flags;
+
+}
+
+/*
+ * spin_unlock_irqrestore, kilidi birakir ve eflags'i geri yukler.
+ *
+ * @param lock : kilit
+ * @param flags : spin_lock_irqsave'in dondurdugu deger
+ */
+static inline void spin_unlock_irqrestore(spinlock_t *lock,uint32_t flags){
+
+	spin_unlock(lock);
+	irq_restore(flags);
+
+}
+
+/*
+ * mcs kuyruklu kilit. her bekleyen kendi dugumu (genelde stack'inda)
+ * uzerinde doner, bu sayede cok cekirdekli sistemde bekleyenler ayni
+ * cache satirini surekli gecersiz kilmaz. kilidi alan ve birakan ayni
+ * dugumu vermelidir.
+ */
+typedef struct mcs_node{
+	struct mcs_node *volatile next;		/* siradaki bekleyen */
+	volatile uint32_t locked;		/* 1 ise beklemeye devam */
+}mcs_node_t;
+
+typedef struct{
+	mcs_node_t *volatile tail;		/* kuyrugun sonu */
+#ifdef LOCK_STAT
+	lock_stat_t stat;
+#endif
+}mcs_lock_t;
+
+#define MCS_LOCK_UNLOCKED(lock_name)	{ NULL LOCK_STAT_INIT(lock_name) }
+
+/*
+ * mcs_lock_init, kilidi acik olarak hazirlar.
+ *
+ * @param lock : kilit
+ */
+static inline void mcs_lock_init(mcs_lock_t *lock){
+
+	lock->tail = NULL;
+#ifdef LOCK_STAT
+	lock->stat = (lock_stat_t){ .name = "[unnamed lock]" };
+#endif
+
+}
+
+/*
+ * mcs_lock, kilidi alir.
+ *
+ * @param lock : kilit
+ * @param node : bekleyen dugum
+ */
+static inline void mcs_lock(mcs_lock_t *lock,mcs_node_t *node){
+
+	mcs_node_t *prev;
+#ifdef LOCK_STAT
+	uint64_t spin_start = rdtsc();
+#endif
+
+	node->next = NULL;
+	node->locked = 1;
+
+	/* xchg, x86'da tam bariyerdir */
+	prev = __sync_lock_test_and_set(&lock->tail,node);
+	if(prev){
+		prev->next = node;
+		while(node->locked)
+			relax_cpu();
+
+		__asm__ volatile("" : : : "memory");
+	}
 
+#ifdef LOCK_STAT
+	lock_stat_acquired(&lock->stat,spin_start,prev != NULL);
+#endif
+
+}
+
+/*
+ * mcs_unlock, kilidi siradaki bekleyene devreder.
+ *
+ * @param lock : kilit
+ * @param node : mcs_lock'a verilen dugum
+ */
+static inline void mcs_unlock(mcs_lock_t *lock,mcs_node_t *node){
+
+#ifdef LOCK_STAT
+	lock_stat_released(&lock->stat);
+#endif
+
+	if(!node->next){
+
+		/* bekleyen yok, kilidi bosalt */
+		if(__sync_bool_compare_and_swap(&lock->tail,node,NULL))
+			return;
+
+		/* biri kuyruga girdi ama henuz bize baglanmadi */
+		while(!node->next)
+			relax_cpu();
+
+	}
+
+	__asm__ volatile("" : : : "memory");
+	node->next->locked = 0;
+
+}
+
+/*
+ * okuyucu-yazici kilidi. ayni anda birden fazla okuyucu ya da tek bir
+ * yazici girebilir. yazici once RW_WRITER bitini alir, bu sayede yeni
+ * okuyucular girmez ve surekli okunan bir kilitte yazici ac kalmaz.
+ *
+ * LOCK_STAT'ta okuyucu ve yazicilarin alinma ve bekleme sureleri ayni
+ * kayda yazilir. okuyucular ayni anda girebildigi icin sayaclar
+ * yaklasiktir, en uzun tutulma suresi sadece yazicilar icin tutulur.
+ */
+#define RW_WRITER			0x80000000
+
+typedef struct{
+	volatile uint32_t lock;			/* RW_WRITER | okuyucu sayisi */
+#ifdef LOCK_STAT
+	lock_stat_t stat;
+#endif
+}rwlock_t;
+
+#define RW_LOCK_UNLOCKED(lock_name)	{ 0 LOCK_STAT_INIT(lock_name) }
+
+/*
+ * rwlock_init, kilidi acik olarak hazirlar.
+ *
+ * @param rw : kilit
+ */
+static inline void rwlock_init(rwlock_t *rw){
+
+	rw->lock = 0;
+#ifdef LOCK_STAT
+	rw->stat = (lock_stat_t){ .name = "[unnamed lock]" };
+#endif
+
+}
+
+/*
+ * read_lock, okuyucu olarak kilidi alir.
+ *
+ * @param rw : kilit
+ */
+static inline void read_lock(rwlock_t *rw){
+
+#ifdef LOCK_STAT
+	uint64_t spin_start = rdtsc();
+	bool contended = false;
+#endif
+
+	for(;;){
+
+		while(rw->lock & RW_WRITER){
+#ifdef LOCK_STAT
+			contended = true;
+#endif
+			relax_cpu();
+		}
+
+		if(!(__sync_add_and_fetch(&rw->lock,1) & RW_WRITER))
+			break;
+
+		/* arada yazici geldi, geri cekil */
+		__sync_fetch_and_sub(&rw->lock,1);
+
+	}
+
+#ifdef LOCK_STAT
+	lock_stat_acquired(&rw->stat,spin_start,contended);
+#endif
+
+}
+
+/*
+ * read_unlock, okuyucu kilidini birakir.
+ *
+ * @param rw : kilit
+ */
+static inline void read_unlock(rwlock_t *rw){
+
+	__sync_fetch_and_sub(&rw->lock,1);
+
+}
+
+/*
+ * write_lock, yazici olarak kilidi alir. once RW_WRITER biti alinir,
+ * sonra icerdeki okuyucularin cikmasi beklenir.
+ *
+ * @param rw : kilit
+ */
+static inline void write_lock(rwlock_t *rw){
+
+	uint32_t old;
+#ifdef LOCK_STAT
+	uint64_t spin_start = rdtsc();
+	bool contended = false;
+#endif
+
+	for(;;){
+
+		old = rw->lock;
+		if(!(old & RW_WRITER) && __sync_bool_compare_and_swap(&rw->lock,old,old | RW_WRITER))
+			break;
+
+#ifdef LOCK_STAT
+		contended = true;
+#endif
+		relax_cpu();
+
+	}
+
+	while(rw->lock & ~RW_WRITER){
+#ifdef LOCK_STAT
+		contended = true;
+#endif
+		relax_cpu();
+	}
+
+	__asm__ volatile("" : : : "memory");
+#ifdef LOCK_STAT
+	lock_stat_acquired(&rw->stat,spin_start,contended);
+#endif
+
+}
+
+/*
+ * write_unlock, yazici kilidini birakir.
+ *
+ * @param rw : kilit
+ */
+static inline void write_unlock(rwlock_t *rw){
+
+#ifdef LOCK_STAT
+	lock_stat_released(&rw->stat);
+#endif
+	__sync_fetch_and_and(&rw->lock,~RW_WRITER);
+
+}
+
+/*
+ * read_lock_irqsave, write_lock_irqsave ve birakma karsiliklari,
+ * spin_lock_irqsave ile ayni sekilde kullanilir.
+ */
+static inline uint32_t read_lock_irqsave(rwlock_t *rw){
+
+	uint32_t flags = irq_save();
+
+	read_lock(rw);
+
+	return flags;
+
+}
+
+static inline void read_unlock_irqrestore(rwlock_t *rw,uint32_t flags){
+
+	read_unlock(rw);
+	irq_restore(flags);
+
+}
+
+static inline uint32_t write_lock_irqsave(rwlock_t *rw){
+
+	uint32_t flags = irq_save();
+
+	write_lock(rw);
+
+	return flags;
+
+}
+
+static inline void write_unlock_irqrestore(rwlock_t *rw,uint32_t flags){
+
+	write_unlock(rw);
+	irq_restore(flags);
+
+}
 
 #endif /* __UNIQ_SPIN_LOCK_H__ */
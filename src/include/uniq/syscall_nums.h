@@ -20,5 +20,19 @@
 #ifndef __UNIQ_SYSCALL_NUMS_H__
 #define __UNIQ_SYSCALL_NUMS_H__
 
+/*
+ * sistem cagrisi numaralari, int 0x80 ile eax'te gonderilir. numaralar
+ * linux i386 ile aynidir.
+ */
+#define SYS_EXIT		1
+#define SYS_FORK		2
+#define SYS_WAITPID		7
+#define SYS_GETPID		20
+#define SYS_KILL		37
+#define SYS_SYSLOG		103
+#define SYS_FUTEX		240
+#define SYS_CLOCK_GETTIME	265
+
+#define NR_SYSCALLS		288
 
 #endif /* __UNIQ_SYSCALL_NUMS_H__ */
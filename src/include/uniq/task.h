@@ -24,5 +24,7 @@
 
 extern page_dir_t *page_directory_clone(page_dir_t *src_directory);
 extern page_table_t *page_table_clone(page_table_t *src_table,uint32_t *physical_addr);
+void page_directory_free(page_dir_t *directory);
+uint32_t get_pid(void);
 
 #endif /* __UNIQ_TASK_H__ */
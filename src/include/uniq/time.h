@@ -30,6 +30,16 @@
 #define TIME_DAY	TIME_HOUR * 24
 #define TIME_YEAR	TIME_DAY * 365
 
+#define NSEC_PER_USEC	1000
+#define NSEC_PER_MSEC	1000000
+#define NSEC_PER_SEC	1000000000
+
+/*
+ * clock_gettime saat tipleri
+ */
+#define CLOCK_REALTIME	0	/* 1970'ten bu yana gecen sure */
+#define CLOCK_MONOTONIC	1	/* acilistan bu yana gecen sure, geri gitmez */
+
 typedef struct tm{
 	time_t tm_sec;		/* saniye (0-61) */
 	time_t tm_min;		/* dakika (0-59) */
@@ -47,7 +57,14 @@ typedef struct timeval{
 	time_t tv_usec;		/* mikrosaniye */
 }timeval_t;
 
+typedef struct timespec{
+	time_t tv_sec;		/* saniye */
+	int32_t tv_nsec;	/* nanosaniye */
+}timespec_t;
+
 void __dump_time_test(void);
+void time_init(void);
 int32_t gettimeofday(timeval_t *timeval,void *tz);
+int32_t clock_gettime(clockid_t clk_id,timespec_t *tp);
 
 #endif /* __UNIQ_TIME_H__ */
@@ -0,0 +1,60 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_TIMER_H__
+#define __UNIQ_TIMER_H__
+
+#include <uniq/types.h>
+#include <ilist.h>
+
+#define TIMER_WHEEL_BITS	8
+#define TIMER_WHEEL_SIZE	(1 << TIMER_WHEEL_BITS)		/* cark yuva sayisi */
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SIZE - 1)
+#define TIMER_NO_EXPIRY		0x7FFFFFFF			/* bekleyen zamanlayici yok */
+
+/*
+ * jiffies karsilastirmalari, sayacin tasmasina karsi
+ * isaretli fark uzerinden yapilir.
+ */
+#define time_after(a,b)		((int32_t)((b) - (a)) < 0)
+#define time_after_eq(a,b)	((int32_t)((a) - (b)) >= 0)
+#define time_before(a,b)	time_after(b,a)
+#define time_before_eq(a,b)	time_after_eq(b,a)
+
+typedef void (*ktimer_func_t)(void *data);
+
+typedef struct{
+	ilist_node_t node;		/* cark yuvasi dugumu (ktimer icinde, malloc yok) */
+	ilist_t *slot;			/* bagli oldugu yuva */
+	uint32_t expires;		/* jiffies cinsinden bitis zamani */
+	ktimer_func_t function;		/* sure doldugunda cagrilacak fonksiyon */
+	void *data;			/* fonksiyona gonderilecek veri */
+}ktimer_t;
+
+extern uint32_t timer_ticks;		/* pit.c, jiffies */
+
+void ktimer_wheel_init(void);
+void ktimer_setup(ktimer_t *timer,ktimer_func_t function,void *data);
+void ktimer_add(ktimer_t *timer,uint32_t expires);
+void ktimer_del(ktimer_t *timer);
+bool ktimer_pending(ktimer_t *timer);
+uint32_t ktimer_next_expiry(void);
+void ktimer_run(void);
+
+#endif /* __UNIQ_TIMER_H__ */
@@ -20,6 +20,8 @@
 #ifndef __UNIQ_TSS_H__
 #define __UNIQ_TSS_H__
 
+#include <uniq/types.h>
+
 typedef struct tss_entry{
 	uint32_t	prev_tss;
 	uint32_t	esp0;
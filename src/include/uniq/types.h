@@ -66,6 +66,8 @@ typedef char boolean;
 #define null	NULL
 
 #define offsetof(type,member) 	((size_t) &((type*)0)->member)
+/* yapinin icindeki uyenin adresinden yapinin adresini bulur */
+#define container_of(ptr,type,member)	((type*)((char*)(ptr) - offsetof(type,member)))
 #define array_size(x)		(sizeof(x) / sizeof((x)[0]))
 
 /*
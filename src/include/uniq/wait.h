@@ -0,0 +1,52 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_WAIT_H__
+#define __UNIQ_WAIT_H__
+
+#include <uniq/types.h>
+#include <uniq/proc.h>
+#include <uniq/spin_lock.h>
+#include <ilist.h>
+
+/*
+ * bekleme kuyrugu. bekleyen her surec icin bir girdi (wait_entry_t)
+ * bekleyenin kendi stack'inda tutulur, kuyruga eklerken bellek
+ * ayrilmaz. uyandirma baska bir islemcideki kesme isleyicisinden
+ * gelebilecegi icin kuyruk, futex kovalari gibi kilitle korunur.
+ */
+typedef struct{
+	spinlock_t lock;		/* kuyruk kilidi */
+	ilist_t waiters;		/* bekleyen girdiler */
+}wait_queue_t;
+
+typedef struct{
+	ilist_node_t node;		/* kuyruk dugumu */
+	process_t *process;		/* bekleyen surec */
+	bool woken;			/* uyandirildi mi? */
+}wait_entry_t;
+
+void wait_queue_init(wait_queue_t *wait);
+void sleep_on(wait_queue_t *wait);
+uint32_t wake_up(wait_queue_t *wait,uint32_t count);
+
+#define wake_up_one(wait)	wake_up(wait,1)
+#define wake_up_all(wait)	wake_up(wait,0xFFFFFFFF)
+
+#endif /* __UNIQ_WAIT_H__ */
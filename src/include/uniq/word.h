@@ -0,0 +1,53 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNIQ_WORD_H__
+#define __UNIQ_WORD_H__
+
+#include <uniq/types.h>
+#include <compiler.h>
+
+/*
+ * kelime kelime (4 bayt) tarama yardimcilari. string ve hash
+ * fonksiyonlari tarafindan ortak kullanilir.
+ */
+
+/* hizasiz 32 bit okuma, x86'da tek bir mov'a derlenir */
+typedef struct{
+	uint32_t v;
+}__packed unaligned32_t;
+
+static inline uint32_t read_unaligned32(const void *p){
+
+	return ((const unaligned32_t*)p)->v;
+
+}
+
+#define WORD_ONES		0x01010101
+#define WORD_HIGHS		0x80808080
+
+/*
+ * word_haszero, kelimedeki baytlardan biri sifirsa sifirdan farkli
+ * bir deger dondurur. word_hasbyte ayni islemi belirtilen bayt icin
+ * yapar, pattern baytin 4 kere tekrarlanmis halidir (c * WORD_ONES).
+ */
+#define word_haszero(w)		(((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+#define word_hasbyte(w,pattern)	word_haszero((w) ^ (pattern))
+
+#endif /* __UNIQ_WORD_H__ */
@@ -21,22 +21,29 @@
 #include <uniq/kernel.h>
 #include <uniq/multiboot.h>
 #include <uniq/module.h>
-
-extern void time_init(void);
+#include <uniq/proc.h>
+#include <uniq/time.h>
+#include <uniq/smp.h>
+#include <uniq/apic.h>
+#include <rbtree.h>
+#include <hashmap.h>
+#include <string.h>
+#include <uniq/kprintf.h>
 
 void kmain(mboot_info_t *mboot_info,uint32_t mboot_magic,uint32_t stack_ptr){
 
 	
 	/* vga konsol */
 	init_vga_console();
+	lfb_graph_probe(mboot_info);	/* vbe bilgisi dusuk bellekte, sayfalamadan once */
 	time_init();
 
-	debug_print(KERN_INFO,"Stack pointer : \033[1;7m%P",stack_ptr);
+	debug_print(KERN_INFO,"Stack pointer : \033[1;7m0x%08X",stack_ptr);
 
 	if(mboot_magic != MULTIBOOT_LOADER_MAGIC)
-		debug_print(KERN_WARNING,"Invalid the magic number. The magic number is \033[1;31m%P",mboot_magic);
+		debug_print(KERN_WARNING,"Invalid the magic number. The magic number is \033[1;31m0x%08X",mboot_magic);
 	else
-		debug_print(KERN_INFO,"Valid the magic number.The magic number is \033[1;37m%P",mboot_magic);
+		debug_print(KERN_INFO,"Valid the magic number.The magic number is \033[1;37m0x%08X",mboot_magic);
 		
 	/*
 	 * gdt,idt,isr ve irq
@@ -45,10 +52,13 @@ void kmain(mboot_info_t *mboot_info,uint32_t mboot_magic,uint32_t stack_ptr){
 	idt_init();	/* kesme tanimlayici tablosu */
 	isr_init();	/* kesme servis istekleri */
 	irq_init();	/* donanim kesme istekleri */
+	serial_init();	/* com1, log cikisi */
+	string_init();	/* islemciye gore mem* fonksiyonlari */
 #if 0
 	__int_test();
 #endif
 	timer_init();
+	vga_defer_flush();	/* konsol ciktisi tick basina bir kere basilir */
 
 	/*
 	 * memory
@@ -59,7 +69,35 @@ void kmain(mboot_info_t *mboot_info,uint32_t mboot_magic,uint32_t stack_ptr){
 	 __page_fault_test();
 #endif
 	heap_init();
-	multitasking_init();
+	lfb_graph_init();
+	smp_init();
+	apic_init();
+	multitasking_init(stack_ptr);
+	syscall_init();
+#if 0
+	__fork_bench();
+#endif
+#if 0
+	__rbtree_test();
+#endif
+#if 0
+	__hashmap_test();
+#endif
+#if 0
+	__string_bench();
+#endif
+#if 0
+	__kprintf_bench();
+#endif
+#if 0
+	__lfb_bench();
+#endif
+#if 0
+	__int_bench();
+#endif
+
+	/* yapacak is kalmadi, bos donguye gec */
+	process_idle();
 
 }
 
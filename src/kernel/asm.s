@@ -51,3 +51,41 @@ copy_page_phys:
 		popf
 		pop ebx
 		ret
+
+;
+; thread_save(thread_t *thread), setjmp benzeri. callee-saved kaydedicileri,
+; stack'i ve donus adresini thread yapisina kaydeder ve 0 dondurur. thread_restore
+; ile bu noktaya donuldugunde 1 dondurur.
+;
+global thread_save
+thread_save:
+		mov eax, [esp + 4]
+		mov [eax + 0], ebp
+		lea ecx, [esp + 4]		; ret sonrasi esp
+		mov [eax + 4], ecx
+		mov ecx, [esp]			; donus adresi
+		mov [eax + 8], ecx
+		mov [eax + 16], ebx
+		mov [eax + 20], esi
+		mov [eax + 24], edi
+		xor eax, eax
+		ret
+
+;
+; thread_restore(thread_t *thread, uint32_t page_dir_phys), sayfa dizinini
+; degistirip thread_save ile kaydedilen yere 1 dondurerek atlar. cr3 degistikten
+; sonra stack baska surecin stack'i olur, bu yuzden tum degerler thread'den okunur.
+;
+global thread_restore
+thread_restore:
+		mov eax, [esp + 4]
+		mov ecx, [esp + 8]
+		mov cr3, ecx
+		mov ebp, [eax + 0]
+		mov esp, [eax + 4]
+		mov ebx, [eax + 16]
+		mov esi, [eax + 20]
+		mov edi, [eax + 24]
+		mov ecx, [eax + 8]
+		mov eax, 1
+		jmp ecx
@@ -0,0 +1,179 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Clock Source
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/clocksource.h>
+#include <uniq/cpuid.h>
+#include <uniq/div64.h>
+#include <uniq/time.h>
+#include <uniq/timer.h>
+
+#define TSC_CALIBRATE_MS	20	/* tek olcum suresi */
+#define TSC_CALIBRATE_TRIES	3	/* en kisa olcum alinir */
+
+static uint64_t clocksource_tsc_read(void);
+static uint64_t clocksource_jiffies_read(void);
+
+static clocksource_t clocksource_tsc = {
+	.name = "tsc",
+	.read = clocksource_tsc_read,
+};
+
+/*
+ * tsc yoksa ya da kalibre edilemediyse kullanilir, cozunurlugu
+ * PIT_HZ kadardir.
+ */
+static clocksource_t clocksource_jiffies = {
+	.name = "jiffies",
+	.read = clocksource_jiffies_read,
+	.mult = NSEC_PER_SEC / PIT_HZ,
+	.shift = 0,
+	.khz = 0,
+};
+
+static clocksource_t *clocksource = &clocksource_jiffies;
+
+static uint64_t clocksource_tsc_read(void){
+
+	return rdtsc();
+
+}
+
+static uint64_t clocksource_jiffies_read(void){
+
+	return timer_ticks;
+
+}
+
+/*
+ * clocksource_calc_mult_shift, verilen frekans icin sayaci
+ * nanosaniyeye ceviren mult/shift ciftini hesaplar. en yuksek
+ * hassasiyet icin mult'in 32 bite sigdigi en buyuk shift secilir.
+ *
+ * @param cs : saat kaynagi
+ * @param khz : sayac frekansi
+ */
+static void clocksource_calc_mult_shift(clocksource_t *cs,uint32_t khz){
+
+	uint64_t mult = 0;
+	uint32_t shift;
+
+	for(shift = 32; shift > 0; shift--){
+		mult = div_u64((uint64_t)NSEC_PER_MSEC << shift,khz);
+
+		if(!(mult >> 32))
+			break;
+	}
+
+	cs->mult = (uint32_t)mult;
+	cs->shift = shift;
+	cs->khz = khz;
+
+}
+
+/*
+ * tsc_calibrate, tsc frekansini pit kanal 2'ye gore olcer. sanal
+ * makinelerde olcum sirasinda cpu elimizden alinabildigi icin birkac
+ * olcumun en kisasi kullanilir. frekansi khz olarak dondurur.
+ */
+static uint32_t tsc_calibrate(void){
+
+	uint64_t cycles,best = (uint64_t)-1;
+	uint32_t pit_count = 0;
+
+	for(uint32_t i = 0; i < TSC_CALIBRATE_TRIES; i++){
+		cycles = timer_calibrate_tsc(TSC_CALIBRATE_MS,&pit_count);
+
+		if(cycles < best)
+			best = cycles;
+	}
+
+	if(!best || !pit_count)
+		return 0;
+
+	/* khz = cycles / (pit_count / PIT_CLOCK) / 1000 */
+	return (uint32_t)div_u64(best * PIT_CLOCK,pit_count * 1000);
+
+}
+
+/*
+ * clocksource_init, islemci destekliyorsa tsc'yi kalibre edip saat
+ * kaynagi olarak secer, desteklemiyorsa jiffies kullanilir.
+ */
+void clocksource_init(void){
+
+	uint32_t khz;
+
+	if(cpu_has_feature(CPU_FEATURE_TSC) && (khz = tsc_calibrate())){
+		clocksource_calc_mult_shift(&clocksource_tsc,khz);
+		clocksource = &clocksource_tsc;
+	}
+
+	clocksource->base = clocksource->read();
+
+	debug_print(KERN_INFO,"Clock source is \033[1;37m%s\033[0m, %u khz, mult = %u, shift = %u",
+								clocksource->name,
+								clocksource->khz,
+								clocksource->mult,
+								clocksource->shift);
+
+}
+
+/*
+ * clocksource_get, kullanilan saat kaynagini dondurur.
+ */
+clocksource_t *clocksource_get(void){
+
+	return clocksource;
+
+}
+
+/*
+ * clocksource_read_ns, clocksource_init'ten bu yana gecen sureyi
+ * nanosaniye olarak dondurur.
+ */
+uint64_t clocksource_read_ns(void){
+
+	uint64_t cycles = clocksource->read() - clocksource->base;
+
+	return mul_u64_u32_shr(cycles,clocksource->mult,clocksource->shift);
+
+}
+
+/*
+ * udelay, verilen sure kadar bekler. saat kaynagi jiffies ise
+ * kesmeler acik olmalidir ve cozunurluk bir tick'tir.
+ *
+ * @param usec : mikrosaniye
+ */
+void udelay(uint32_t usec){
+
+	uint64_t start = clocksource_read_ns();
+	uint64_t ns = (uint64_t)usec * NSEC_PER_USEC;
+
+	while(clocksource_read_ns() - start < ns)
+		relax_cpu();
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
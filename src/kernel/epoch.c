@@ -0,0 +1,171 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Epoch Based Reclamation
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/epoch.h>
+#include <uniq/asm.h>
+
+static volatile uint32_t epoch_global = 0;
+static epoch_cpu_t epoch_cpus[MAX_CPUS];
+
+/*
+ * epoch_enter, kilitsiz okuma bolumune girer. bolum boyunca kesmeler
+ * kapalidir, okuyucu baska cpu'ya gecemez ve uyuyamaz. ic ice
+ * kullanilabilir.
+ */
+void epoch_enter(void){
+
+	uint32_t flags = irq_save();
+	epoch_cpu_t *ec = &epoch_cpus[smp_processor_id()];
+
+	if(ec->active++)
+		return;
+
+	ec->flags = flags;
+	ec->epoch = epoch_global;
+	/* girildigi bilgisi yapidan okumadan once diger cpu'lara gorunmeli */
+	mb();
+
+}
+
+/*
+ * epoch_exit, okuma bolumunden cikar. x86'da okumalar sonraki bir
+ * yazmanin arkasina gecemedigi icin derleyici bariyeri yeterlidir.
+ */
+void epoch_exit(void){
+
+	epoch_cpu_t *ec = &epoch_cpus[smp_processor_id()];
+
+	__asm__ volatile("" : : : "memory");
+
+	if(!--ec->active)
+		irq_restore(ec->flags);
+
+}
+
+/*
+ * epoch_reclaim_list, listedeki ertelenmis elemanlarin fonksiyonlarini
+ * cagirir.
+ *
+ * @param ec : cpu kaydi
+ * @param index : limbo listesi
+ */
+static void epoch_reclaim_list(epoch_cpu_t *ec,uint32_t index){
+
+	epoch_head_t *head = ec->limbo[index],*next;
+
+	ec->limbo[index] = NULL;
+
+	for(; head; head = next){
+		next = head->next;
+		head->func(head);
+		ec->pending--;
+	}
+
+}
+
+/*
+ * epoch_reclaim, global epoch en son bosaltmadan bu yana ilerlediyse
+ * guvenli hale gelen listeleri bosaltir. g epoch'unda, g - 2 ve daha
+ * onceki epoch'larda ertelenenler artik hicbir okuyucu tarafindan
+ * tutulamaz. g % 3 listesinde g'den once eklenmis olanlar en az g - 3,
+ * (g + 1) % 3 listesindekiler en az g - 2 epoch'undadir. (g - 1) % 3
+ * listesi bir sonraki ilerlemeyi bekler.
+ *
+ * @param ec : cpu kaydi
+ * @param epoch : global epoch
+ */
+static void epoch_reclaim(epoch_cpu_t *ec,uint32_t epoch){
+
+	if(ec->reclaimed == epoch)
+		return;
+
+	epoch_reclaim_list(ec,epoch % EPOCH_COUNT);
+	epoch_reclaim_list(ec,(epoch + 1) % EPOCH_COUNT);
+	ec->reclaimed = epoch;
+
+}
+
+/*
+ * epoch_poll, okuma bolumundeki tum cpu'lar gecerli epoch'u gorduyse
+ * global epoch'u ilerletir ve bu cpu'nun guvenli listelerini bosaltir.
+ * epoch ilerlediyse true doner.
+ */
+bool epoch_poll(void){
+
+	uint32_t flags = irq_save();
+	epoch_cpu_t *ec = &epoch_cpus[smp_processor_id()];
+	uint32_t epoch = epoch_global;
+	bool advanced = true;
+
+	for(uint32_t i = 0; i < cpu_count; i++){
+
+		epoch_cpu_t *other = &epoch_cpus[i];
+
+		if(other->active && other->epoch != epoch){
+			advanced = false;
+			break;
+		}
+
+	}
+
+	if(advanced)
+		advanced = __sync_bool_compare_and_swap(&epoch_global,epoch,epoch + 1);
+
+	epoch_reclaim(ec,epoch_global);
+	irq_restore(flags);
+
+	return advanced;
+
+}
+
+/*
+ * epoch_defer, veri yapisindan cikarilmis elemanin geri kazanimini
+ * tum okuyucular onu birakana kadar erteler. func, eleman icindeki
+ * head'i alir ve elemani container_of ile bulur. cok sayida erteleme
+ * biriktiginde epoch ilerletilmeye calisilir.
+ *
+ * @param head : elemanin icindeki erteleme dugumu
+ * @param func : geri kazanim fonksiyonu
+ */
+void epoch_defer(epoch_head_t *head,void (*func)(epoch_head_t *head)){
+
+	uint32_t flags = irq_save();
+	epoch_cpu_t *ec = &epoch_cpus[smp_processor_id()];
+	uint32_t epoch = epoch_global;
+
+	/* ayni listede farkli turlarin elemanlari karismasin */
+	epoch_reclaim(ec,epoch);
+
+	head->func = func;
+	head->next = ec->limbo[epoch % EPOCH_COUNT];
+	ec->limbo[epoch % EPOCH_COUNT] = head;
+
+	if(++ec->pending >= EPOCH_POLL_THRESHOLD)
+		epoch_poll();
+
+	irq_restore(flags);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -18,6 +18,134 @@
  */
  
 #include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/proc.h>
+#include <uniq/errno.h>
+
+/*
+ * exit, calisan sureci sonlandirir. surec ebeveyni waitpid ile
+ * toplayana kadar zombie olarak kalir, cocuklari bos surece baglanir.
+ * ebeveyni bos surec olan (yetim) surecler bos donguda toplanir.
+ *
+ * @param status : cikis kodu
+ */
+void exit(int32_t status){
+
+	process_t *process = current_process;
+	process_t *parent;
+
+	disable_irq();
+
+	if(!process || process == idle_process)
+		die("exit: the idle process can't exit!");
+
+	process->exit_code = status;
+	process->flags |= PROCESS_FINISHED;
+	process->flags &= ~PROCESS_RUNNING;
+
+	process_reparent_children(process);
+
+	parent = (process_t*)process->tree_node.parent->item;
+
+	/* bos surec waitpid cagirmaz, sureci process_idle toplar */
+	if(parent == idle_process)
+		process_orphans_finished++;
+	else
+		process_wakeup(parent);
+
+	/* bitmis surec kuyruga eklenmez, bir daha secilmez */
+	switch_task();
+
+	die("exit: finished process was scheduled again!");
+	for(;;)
+		halt_system();
+
+}
+
+/*
+ * waitpid_find, ebeveynin bitmis cocugunu arar. pid -1 ise herhangi
+ * bir cocuk, degilse pid hashmap'inden bulunan cocuk kontrol edilir.
+ *
+ * @param parent : ebeveyn surec
+ * @param pid : cocuk pid ya da -1
+ * @param has_child : beklenecek cocuk var mi?
+ */
+static process_t *waitpid_find(process_t *parent,pid_t pid,bool *has_child){
+
+	process_t *child;
+	tree_node_t *node;
+
+	*has_child = false;
+
+	if(pid > 0){
+
+		child = process_from_pid(pid);
+		if(!child || child->tree_node.parent != &parent->tree_node)
+			return NULL;
+
+		*has_child = true;
+
+		return (child->flags & PROCESS_FINISHED) ? child : NULL;
+
+	}
+
+	tree_for_each_child(node,&parent->tree_node){
+
+		child = (process_t*)node->item;
+		*has_child = true;
+
+		if(child->flags & PROCESS_FINISHED)
+			return child;
+
+	}
+
+	return NULL;
+
+}
+
+/*
+ * waitpid, cocuk surecin bitmesini bekler ve kaynaklarini bosa
+ * cikarir. cocugun pid'ini, WNOHANG verilmisse ve cocuk bitmemisse 0,
+ * beklenecek cocuk yoksa -ECHILD dondurur.
+ *
+ * @param pid : cocuk pid ya da herhangi biri icin -1
+ * @param status : cikis kodunun yazilacagi adres (NULL olabilir)
+ * @param options : WNOHANG
+ */
+pid_t waitpid(pid_t pid,int32_t *status,int32_t options){
+
+	process_t *process = current_process,*child;
+	bool has_child;
+	uint32_t flags;
+
+	if(!process)
+		return -ECHILD;
+
+	flags = irq_save();
+
+	while(!(child = waitpid_find(process,pid,&has_child))){
+
+		if(!has_child || (options & WNOHANG)){
+			irq_restore(flags);
+			return has_child ? 0 : -ECHILD;
+		}
+
+		process_prepare_sleep();
+		process_sleep();
+
+	}
+
+	pid = child->id;
+
+	if(status)
+		*status = child->exit_code;
+
+	process_reap(child);
+	irq_restore(flags);
+
+	return pid;
+
+}
  
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
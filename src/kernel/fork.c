@@ -19,17 +19,112 @@
  
 #include <uniq/module.h>
 #include <uniq/types.h>
+#include <uniq/kernel.h>
+#include <uniq/proc.h>
+#include <uniq/task.h>
+#include <uniq/time.h>
+#include <uniq/div64.h>
 
+#define FORK_BENCH_COUNT	1000
+
+extern page_dir_t *current_dir;
 
 /*
- * fork
+ * fork, calisan surecin kopyasini olusturur. adres alani (kernel
+ * disindaki tablolar ve stack) page_directory_clone ile kopyalanir.
+ * ebeveyne cocugun pid'i, cocuga 0 doner. hata olursa -1 doner.
  */
-uint32_t fork(void){
+pid_t fork(void){
  
+	process_t *parent = current_process,*child;
+	uint32_t flags;
+
+	if(!parent)
+		return -1;
+
+	flags = irq_save();
+
+	child = process_alloc();
+	if(!child){
+		irq_restore(flags);
+		return -1;
+	}
+
+	if(process_register(child) < 0){
+		free(child);
+		irq_restore(flags);
+		return -1;
+	}
+
+	child->name = parent->name;
+	child->description = parent->description;
+	child->cmdline = parent->cmdline;
+	child->umask = parent->umask;
+
+	/*
+	 * cocugun kaydedicileri burada kaydediliyor ve stack hemen
+	 * ardindan kopyalaniyor. cocuk ilk kez secildiginde thread_save
+	 * 1 dondurur ve buradan devam eder.
+	 */
+	if(thread_save(&child->thread)){
+		irq_restore(flags);
+		return 0;
+	}
 
-  return 0;
+	child->thread.page_dir = page_directory_clone(current_dir);
+	/* stack ayni sanal adreste kopyalandi */
+	child->thread.kernel_stack = parent->thread.kernel_stack;
+	process_attach(child,parent);
+
+	irq_restore(flags);
+
+	return child->id;
   
 }
 
+/*
+ * __fork_bench, fork/exit/waitpid dongusunu olcer ve saniyedeki
+ * fork sayisini yazdirir. klonlama yolundaki yavaslamalari gormek
+ * icin kullanilir.
+ */
+void __fork_bench(void){
+
+	timespec_t start,end;
+	uint64_t elapsed;
+	uint32_t elapsed_us,done = 0;
+	int32_t status;
+
+	debug_print(KERN_INFO,"fork bench, %u fork/exit/wait...",FORK_BENCH_COUNT);
+	clock_gettime(CLOCK_MONOTONIC,&start);
+
+	for(uint32_t i = 0; i < FORK_BENCH_COUNT; i++){
+
+		pid_t pid = fork();
+
+		if(!pid)
+			exit(0);
+
+		if(pid < 0){
+			debug_print(KERN_WARNING,"fork failed after %u forks",done);
+			break;
+		}
+
+		waitpid(pid,&status,0);
+		done++;
+
+	}
+
+	clock_gettime(CLOCK_MONOTONIC,&end);
+	elapsed = (uint64_t)(end.tv_sec - start.tv_sec) * NSEC_PER_SEC + end.tv_nsec - start.tv_nsec;
+	elapsed_us = (uint32_t)div_u64(elapsed,NSEC_PER_USEC);
+
+	if(!elapsed_us)
+		elapsed_us = 1;
+
+	debug_print(KERN_DUMP,"%u forks in %u us, %u forks/sec",done,elapsed_us,
+					(uint32_t)div_u64((uint64_t)done * 1000000,elapsed_us));
+
+}
+
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
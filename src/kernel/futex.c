@@ -0,0 +1,262 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Futex
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/spin_lock.h>
+#include <uniq/proc.h>
+#include <uniq/timer.h>
+#include <uniq/errno.h>
+#include <uniq/div64.h>
+#include <uniq/futex.h>
+#include <ilist.h>
+#include <drivers/pit.h>
+
+/*
+ * futex bekleyenleri (sayfa dizini, adres) ciftine gore kovalara
+ * dagitilir. her bekleyenin girdisi kendi stack'inda durur, sadece
+ * kesme kapaliyken ve kova kilidi alinmisken kuyruga baglanir.
+ */
+typedef struct{
+	spinlock_t lock;		/* kova kilidi */
+	ilist_t waiters;		/* futex_q_t listesi */
+}futex_bucket_t;
+
+typedef struct{
+	ilist_node_t node;		/* kova dugumu */
+	page_dir_t *page_dir;		/* anahtar: adres alani */
+	uint32_t *uaddr;		/* anahtar: adres */
+	process_t *process;		/* bekleyen surec */
+	bool woken;			/* uyandirildi mi? */
+	bool timed_out;			/* zaman asimi mi? */
+}futex_q_t;
+
+static futex_bucket_t futex_queues[FUTEX_HASH_SIZE];
+
+/*
+ * futex_init, futex kovalarini hazirlar.
+ */
+void futex_init(void){
+
+	for(uint32_t i = 0; i < FUTEX_HASH_SIZE; i++){
+		spin_lock_init(&futex_queues[i].lock);
+		ilist_init(&futex_queues[i].waiters);
+	}
+
+}
+
+/*
+ * futex_hash, anahtara ait kovayi dondurur. adresin alt 2 biti
+ * hizalamadan dolayi hep 0'dir, onlari atiyoruz.
+ *
+ * @param page_dir : sayfa dizini
+ * @param uaddr : adres
+ */
+static futex_bucket_t *futex_hash(page_dir_t *page_dir,uint32_t *uaddr){
+
+	uint32_t key = ((uint32_t)uaddr >> 2) ^ ((uint32_t)page_dir >> 12);
+
+	/* knuth carpimsal hash */
+	key *= 0x9E3779B1;
+
+	return &futex_queues[key >> (32 - FUTEX_HASH_BITS)];
+
+}
+
+/*
+ * futex_timeout, bekleme suresi dolan sureci uyandirir.
+ *
+ * @param data : futex_q_t
+ */
+static void futex_timeout(void *data){
+
+	futex_q_t *q = (futex_q_t*)data;
+
+	q->timed_out = true;
+	process_wakeup(q->process);
+
+}
+
+/*
+ * timespec_to_ticks, sureyi yukari yuvarlanmis jiffies'e cevirir.
+ *
+ * @param ts : sure
+ */
+static uint32_t timespec_to_ticks(const timespec_t *ts){
+
+	uint64_t ns = (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+	uint64_t ticks = div_u64(ns + (NSEC_PER_SEC / PIT_HZ) - 1,NSEC_PER_SEC / PIT_HZ);
+
+	if(ticks > TIMER_NO_EXPIRY)
+		return TIMER_NO_EXPIRY;
+
+	return (uint32_t)ticks;
+
+}
+
+/*
+ * futex_wait, *uaddr hala val degerindeyse sureci futex_wake cagrilana
+ * ya da sure dolana kadar uyutur. deger kontrolu kova kilidi altinda
+ * yapildigi icin kontrol ile uyuma arasinda gelen futex_wake kaybolmaz.
+ *
+ * basarili olursa 0, deger degismisse -EAGAIN, sure dolmussa -ETIMEDOUT
+ * dondurur.
+ *
+ * @param uaddr : futex adresi
+ * @param val : beklenen deger
+ * @param timeout : en fazla bekleme suresi, NULL ise suresiz
+ */
+int32_t futex_wait(uint32_t *uaddr,uint32_t val,const timespec_t *timeout){
+
+	futex_bucket_t *bucket;
+	futex_q_t q;
+	ktimer_t timer;
+	uint32_t flags;
+
+	if(!uaddr || ((uint32_t)uaddr & 0x3))
+		return -EINVAL;
+
+	if(timeout && (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+		       timeout->tv_nsec >= NSEC_PER_SEC))
+		return -EINVAL;
+
+	q.page_dir = current_process->thread.page_dir;
+	q.uaddr = uaddr;
+	q.process = current_process;
+	q.woken = false;
+	q.timed_out = false;
+
+	bucket = futex_hash(q.page_dir,uaddr);
+
+	flags = irq_save();
+	spin_lock(&bucket->lock);
+
+	if(*(volatile uint32_t*)uaddr != val){
+		spin_unlock(&bucket->lock);
+		irq_restore(flags);
+		return -EAGAIN;
+	}
+
+	ilist_add_tail(&bucket->waiters,&q.node);
+
+	if(timeout){
+		ktimer_setup(&timer,futex_timeout,&q);
+		ktimer_add(&timer,timer_ticks + timespec_to_ticks(timeout));
+	}
+
+	while(!q.woken && !q.timed_out){
+
+		/* kova kilidi altinda isaretlenir, futex_wake arada gelirse kaybolmaz */
+		process_prepare_sleep();
+		spin_unlock(&bucket->lock);
+		process_sleep();
+		spin_lock(&bucket->lock);
+
+		/* bos surec uyandirilmadan donmus olabilir */
+		if(current_process == idle_process)
+			break;
+
+	}
+
+	if(timeout)
+		ktimer_del(&timer);
+
+	if(!q.woken)
+		ilist_del(&bucket->waiters,&q.node);
+	spin_unlock(&bucket->lock);
+
+	irq_restore(flags);
+
+	if(q.woken)
+		return 0;
+
+	return q.timed_out ? -ETIMEDOUT : -EINTR;
+
+}
+
+/*
+ * futex_wake, uaddr uzerinde bekleyen en fazla count kadar sureci
+ * uyandirir ve uyandirilan surec sayisini dondurur.
+ *
+ * @param uaddr : futex adresi
+ * @param count : en fazla uyandirilacak surec sayisi
+ */
+int32_t futex_wake(uint32_t *uaddr,uint32_t count){
+
+	page_dir_t *page_dir = current_process->thread.page_dir;
+	futex_bucket_t *bucket;
+	futex_q_t *q,*next;
+	uint32_t flags;
+	int32_t woken = 0;
+
+	if(!uaddr || ((uint32_t)uaddr & 0x3))
+		return -EINVAL;
+
+	bucket = futex_hash(page_dir,uaddr);
+
+	flags = irq_save();
+	spin_lock(&bucket->lock);
+
+	ilist_for_each_entry_safe(q,next,&bucket->waiters,node){
+
+		if((uint32_t)woken >= count)
+			break;
+
+		if(q->uaddr != uaddr || q->page_dir != page_dir)
+			continue;
+
+		ilist_del(&bucket->waiters,&q->node);
+		q->woken = true;
+		process_wakeup(q->process);
+		woken++;
+
+	}
+
+	spin_unlock(&bucket->lock);
+	irq_restore(flags);
+
+	return woken;
+
+}
+
+/*
+ * futex, futex sistem cagrisinin giris noktasidir.
+ *
+ * @param uaddr : futex adresi
+ * @param op : FUTEX_WAIT ya da FUTEX_WAKE
+ * @param val : WAIT icin beklenen deger, WAKE icin uyandirilacak sayi
+ * @param timeout : WAIT icin en fazla bekleme suresi
+ */
+int32_t futex(uint32_t *uaddr,int32_t op,uint32_t val,const timespec_t *timeout){
+
+	switch(op){
+		case FUTEX_WAIT:
+			return futex_wait(uaddr,val,timeout);
+		case FUTEX_WAKE:
+			return futex_wake(uaddr,val);
+	}
+
+	return -ENOSYS;
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,252 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Interrupt Statistics
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/irq_stat.h>
+#include <uniq/apic.h>
+#include <uniq/irq.h>
+#include <uniq/div64.h>
+#include <string.h>
+
+#define IRQ_STAT_LINE		160				/* tablo satiri boyutu */
+#define IRQ_STAT_LINES		(IRQ_STAT_VECTORS + 2)		/* baslik + vektorler + SPU */
+
+irq_stat_t irq_stats[MAX_CPUS][IRQ_STAT_VECTORS];
+
+/*
+ * irq_stat_exit, isleyici dondukten sonra suresini vektorun
+ * istatistigine ekler ve bir onceki cerceveye doner.
+ *
+ * @param frame : kesme cercevesi
+ * @param vector : kesme vektoru
+ */
+void irq_stat_exit(irq_frame_t *frame,uint32_t vector){
+
+	uint64_t end = frame->end ? frame->end : rdtsc();
+	uint64_t cycles = end - frame->start;
+	irq_stat_t *stat = &irq_stats[frame->cpu][vector];
+
+	stat->cycles += cycles;
+	if(cycles > stat->max_cycles)
+		stat->max_cycles = cycles;
+
+	this_cpu()->irq_frame = frame->prev;
+
+}
+
+/*
+ * irq_stat_switch, switch_task tarafindan surec degistirilmeden once
+ * kesmeler kapaliyken cagrilir. cpu'da acik kalan cerceveler kapatilir,
+ * surec geri dondugunde irq_stat_exit bu zamani kullanir.
+ */
+void irq_stat_switch(void){
+
+	cpu_t *cpu = this_cpu();
+	uint64_t now;
+
+	if(!cpu->irq_frame)
+		return;
+
+	now = rdtsc();
+	for(irq_frame_t *frame = cpu->irq_frame; frame; frame = frame->prev){
+		if(!frame->end)
+			frame->end = now;
+	}
+
+	cpu->irq_frame = NULL;
+
+}
+
+/*
+ * irq_stat_spurious, isleyicisi cagrilmayan sahte kesmeyi sayar.
+ *
+ * @param vector : kesme vektoru
+ */
+void irq_stat_spurious(uint32_t vector){
+
+	irq_stats[smp_processor_id()][vector].spurious++;
+
+}
+
+/*
+ * irq_stat_reset, tum sayaclari sifirlar.
+ */
+void irq_stat_reset(void){
+
+	memset(irq_stats,0,sizeof(irq_stats));
+	lapic_spurious_count = 0;
+
+}
+
+/*
+ * irq_stat_name, vektorun tabloda gorunecek adi.
+ *
+ * @param vector : kesme vektoru
+ * @param buf : ad icin tampon
+ * @param size : tamponun boyutu
+ */
+static const char *irq_stat_name(uint32_t vector,char *buf,size_t size){
+
+	if(vector < 32)
+		return "exception";
+
+	if(vector >= IRQ_VECTOR_BASE && vector < IRQ_VECTOR_BASE + 16){
+		size_t len = snprintf(buf,size,"IRQ%u ",vector - IRQ_VECTOR_BASE);
+
+		irq_action_names(vector - IRQ_VECTOR_BASE,buf + len,size - len);
+		return buf;
+	}
+
+	if(vector == 128)
+		return "syscall";
+
+	return "vector";
+
+}
+
+/*
+ * irq_stat_append, satirin sonuna bicimlendirilmis metin ekler.
+ * snprintf kirpilmamis uzunlugu dondurdugu icin sonuc tamponun
+ * sonuna sabitlenir, satir uzunlugu hicbir zaman size - 1'i gecmez.
+ *
+ * @param line : satir tamponu
+ * @param size : tamponun boyutu
+ * @param len : satirin su anki uzunlugu
+ * @param fmt : bicim
+ */
+static size_t __printf(4,5) irq_stat_append(char *line,size_t size,size_t len,const char *fmt, ...){
+
+	va_list arg_list;
+
+	va_start(arg_list,fmt);
+	len += vsnprintf(line + len,size - len,fmt,arg_list);
+	va_end(arg_list);
+
+	return len >= size ? size - 1 : len;
+
+}
+
+/*
+ * irq_stat_line, /proc/interrupts benzeri tablonun bir satirini
+ * olusturur. 0. satir baslik, son satir local apic sahte kesmeleridir,
+ * aradakiler vektorlerdir. hic kesme gelmemis vektorler icin 0 doner.
+ *
+ * @param index : satir numarasi
+ * @param line : satir tamponu
+ * @param size : tamponun boyutu
+ */
+static size_t irq_stat_line(uint32_t index,char *line,size_t size){
+
+	uint32_t cpus = cpu_count ? cpu_count : 1;
+	uint32_t vector = index - 1;
+	uint32_t count = 0,spurious = 0;
+	uint64_t cycles = 0,max_cycles = 0;
+	uint32_t avg = 0;
+	char name[48];
+	size_t len;
+
+	if(!index){
+		len = irq_stat_append(line,size,0,"vec ");
+		for(uint32_t cpu = 0; cpu < cpus; cpu++)
+			len = irq_stat_append(line,size,len," %6sCPU%u","",cpu);
+		len = irq_stat_append(line,size,len," %10s %10s %10s  %s","avg cyc","max cyc","spurious","name");
+		return len;
+	}
+
+	if(index == IRQ_STAT_LINES - 1)
+		return irq_stat_append(line,size,0,"SPU  %10u  lapic spurious",lapic_spurious_count);
+
+	for(uint32_t cpu = 0; cpu < cpus; cpu++){
+		irq_stat_t *stat = &irq_stats[cpu][vector];
+
+		count += stat->count;
+		spurious += stat->spurious;
+		cycles += stat->cycles;
+		if(stat->max_cycles > max_cycles)
+			max_cycles = stat->max_cycles;
+	}
+
+	if(!count && !spurious)
+		return 0;
+
+	if(count)
+		avg = (uint32_t)div_u64(cycles,count);
+
+	len = irq_stat_append(line,size,0,"%3u ",vector);
+	for(uint32_t cpu = 0; cpu < cpus; cpu++)
+		len = irq_stat_append(line,size,len," %10u",irq_stats[cpu][vector].count);
+	len = irq_stat_append(line,size,len," %10u %10u %10u  %s",avg,(uint32_t)max_cycles,spurious,
+								irq_stat_name(vector,name,sizeof(name)));
+
+	return len;
+
+}
+
+/*
+ * irq_stat_read, kesme tablosunu satir satir tampona yazar. sigmayan
+ * satirlar yazilmaz. yazilan byte sayisini dondurur.
+ *
+ * @param buf : tampon
+ * @param size : tamponun boyutu
+ */
+size_t irq_stat_read(char *buf,size_t size){
+
+	char line[IRQ_STAT_LINE];
+	size_t copied = 0,len;
+
+	for(uint32_t i = 0; i < IRQ_STAT_LINES; i++){
+		len = irq_stat_line(i,line,sizeof(line) - 1);
+		if(!len)
+			continue;
+
+		line[len++] = '\n';
+		if(copied + len > size)
+			break;
+
+		memcpy(buf + copied,line,len);
+		copied += len;
+	}
+
+	return copied;
+
+}
+
+/*
+ * irq_stat_dump, kesme tablosunu yazdirir. panik sirasinda kesme
+ * yukunun hangi aygittan geldigini gormek icin die tarafindan da
+ * cagrilir.
+ */
+void irq_stat_dump(void){
+
+	char line[IRQ_STAT_LINE];
+
+	debug_print(KERN_DUMP,"Interrupt statistics (cycles):");
+
+	for(uint32_t i = 0; i < IRQ_STAT_LINES; i++){
+		if(irq_stat_line(i,line,sizeof(line)))
+			debug_print(KERN_DUMP,"%s",line);
+	}
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
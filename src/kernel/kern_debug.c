@@ -18,6 +18,7 @@
  */
  
 #include <uniq/kern_debug.h>
+#include <uniq/klog.h>
 #include <va_list.h>
 #include <uniq/module.h>
 
@@ -28,21 +29,9 @@
 #endif
 
 /*
- * debug seviyesi mesajlari
- */
-static const char *level_msgs[] = {
-	"\033[1;32mINFO\033[0m",
-	"\033[1;37mNOTICE\033[0m",
-	"\033[1;33mWARNING\033[0m",
-	"\033[1;31mERROR\033[0m",
-	"\033[1;34mCRITICAL\033[0m",
-	"\033[1;31mALERT\033[0m",
-	"\033[1;36mEMERGENCY\033[0m"
-};
-
-/*
- * _debug_print,kernel debug modundayken ekrana log kayitlarini
- * yazdirmak icin kullanilir.
+ * _debug_print,kernel log kaydi olusturur. kayit once log halkasina
+ * yazilir, ardindan konsol bosaltilir. bilgilendirme kayitlari oops
+ * modunda ekrana basilmaz fakat dmesg ile okunabilir.
  *
  * @param file : dosya
  * @param line : dosya satir numarasi
@@ -51,20 +40,14 @@ static const char *level_msgs[] = {
  * @param ... : argumanlar
  */
 void _debug_print(char *file,uint32_t line,kern_levels_t level,const char *fmt,...){
-	
-	if((level == KERN_INFO) && (kdebug_mode == KERN_DEBUG_OOPS))
-		return;
 
-	char buffer[4096];
 	va_list arg_list;
+
 	va_start(arg_list,fmt);
-	vsnprintf(buffer,sizeof(buffer)-1,fmt,arg_list);
+	klog_write(file,line,level,fmt,arg_list);
 	va_end(arg_list);
-	
-	if(level == KERN_DUMP)
-		printf("%s\n",buffer);
-	else
-		printf("%-10s: [module = %.40s line = %.6d]\n%s %s\n",level_msgs[level],file,line,"->",buffer);
+
+	klog_flush();
 	
 }
 
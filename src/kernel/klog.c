@@ -0,0 +1,436 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Kernel Log Ring Buffer
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/klog.h>
+#include <uniq/spin_lock.h>
+#include <uniq/clocksource.h>
+#include <uniq/div64.h>
+#include <uniq/time.h>
+#include <uniq/errno.h>
+#include <string.h>
+
+/*
+ * kayitlar sabit boyutlu yuvalardan olusan bir halkada tutulur. yazanlar
+ * kilit almadan klog_head'i atomik arttirip kendi yuvalarini alir, kaydi
+ * doldurur ve en son seq'i yazarak yayinlar. okuyucular (konsol, dmesg)
+ * seq'e bakarak yuvanin hazir, yaziliyor ya da ezilmis oldugunu anlar.
+ * halka dolunca en eski kayitlarin uzerine yazilir.
+ */
+static klog_record_t klog_ring[KLOG_RECORDS];
+static volatile uint32_t klog_head = 0;		/* bir sonraki kayit numarasi */
+
+/*
+ * cikislar tek bir islemci tarafindan bosaltilir. kilidi alamayan
+ * yazan beklemez, kaydini kilit sahibi basar.
+ */
+static spinlock_t klog_console_lock = SPIN_LOCK_UNLOCKED("klog_console");
+static uint32_t klog_console_seq = 0;		/* cikislara basilacak ilk kayit */
+static klog_stat_t klog_stats;
+
+static void klog_render(const klog_record_t *record);
+
+/* kern_debug.c'deki kdebug_mode ile ayni, oops modunda bilgilendirme basilmaz */
+static klog_sink_t klog_vga_sink = {
+	.name = "vga",
+	.write = klog_render,
+	.panic = vga_panic,
+#ifdef KDEBUG_DEFAULT
+	.level = KERN_INFO,
+#else  /* KDEBUG_OOPS */
+	.level = KERN_NOTICE,
+#endif
+};
+
+static klog_sink_t *klog_sinks[KLOG_MAX_SINKS] = { &klog_vga_sink };
+static uint32_t klog_nr_sinks = 1;
+static const char *level_names[] = {
+	"INFO",
+	"NOTICE",
+	"WARNING",
+	"ERROR",
+	"CRITICAL",
+	"ALERT",
+	"EMERGENCY",
+	"DUMP"
+};
+
+/*
+ * debug seviyesi mesajlari, konsol hedefi ansi renklerini vga
+ * renklerine cevirir.
+ */
+static const char *level_msgs[] = {
+	"\033[1;32mINFO\033[0m",
+	"\033[1;37mNOTICE\033[0m",
+	"\033[1;33mWARNING\033[0m",
+	"\033[1;31mERROR\033[0m",
+	"\033[1;34mCRITICAL\033[0m",
+	"\033[1;31mALERT\033[0m",
+	"\033[1;36mEMERGENCY\033[0m",
+	"DUMP"
+};
+
+/*
+ * klog_write, mesaji bicimlendirip halkaya yeni bir kayit olarak
+ * ekler. konsola basmaz, bunun icin klog_flush cagrilmalidir.
+ *
+ * @param file : kaynak dosya
+ * @param line : kaynak satiri
+ * @param level : kernel debug seviyesi
+ * @param fmt : format
+ * @param args : argumanlar
+ */
+void klog_write(const char *file,uint32_t line,kern_levels_t level,const char *fmt,va_list args){
+
+	uint32_t seq = __sync_fetch_and_add(&klog_head,1);
+	klog_record_t *record = &klog_ring[seq & KLOG_MASK];
+	int32_t len;
+
+	record->seq = 0;
+	barrier();
+
+	record->level = level;
+	record->file = file;
+	record->line = line;
+	record->time_ns = clocksource_read_ns();
+
+	len = vsnprintf(record->text,KLOG_MSG_SIZE,fmt,args);
+	record->len = len < KLOG_MSG_SIZE ? len : KLOG_MSG_SIZE - 1;
+
+	barrier();
+	record->seq = seq + 1;
+
+	__sync_fetch_and_add(&klog_stats.written,1);
+
+}
+
+/*
+ * klog_first_seq, halkada bulunan en eski kaydin numarasini dondurur.
+ */
+uint32_t klog_first_seq(void){
+
+	uint32_t head = klog_head;
+
+	return head > KLOG_RECORDS ? head - KLOG_RECORDS : 0;
+
+}
+
+/*
+ * klog_next_seq, bir sonraki yazilacak kaydin numarasini dondurur.
+ */
+uint32_t klog_next_seq(void){
+
+	return klog_head;
+
+}
+
+/*
+ * klog_read, *seq numarali kaydi kopyalar ve *seq'i bir sonraki kayda
+ * ilerletir. kayit ezilmisse halkadaki en eski kayittan devam edilir.
+ * kayit henuz yayinlanmamissa false doner, *seq degismez.
+ *
+ * @param seq : okunacak kayit numarasi
+ * @param record : kaydin kopyalanacagi alan
+ */
+bool klog_read(uint32_t *seq,klog_record_t *record){
+
+	const klog_record_t *slot;
+	uint32_t head,committed;
+
+	for(;;){
+
+		head = klog_head;
+		if((int32_t)(head - *seq) > KLOG_RECORDS)
+			*seq = head - KLOG_RECORDS;
+
+		if(*seq == head)
+			return false;
+
+		slot = &klog_ring[*seq & KLOG_MASK];
+		committed = slot->seq;
+		barrier();
+
+		/* yaziliyor ya da henuz bu tura ait degil */
+		if(committed == 0 || (int32_t)(committed - (*seq + 1)) < 0)
+			return false;
+
+		if(committed == *seq + 1){
+			memcpy(record,(const void*)slot,sizeof(klog_record_t));
+			barrier();
+			/* kopyalarken ezilmediyse kayit gecerlidir */
+			if(slot->seq == committed){
+				(*seq)++;
+				return true;
+			}
+		}
+
+		/* ezildi, bir sonraki turda en eskiden devam */
+		(*seq)++;
+
+	}
+
+}
+
+/*
+ * klog_split_time, zamani saniye ve mikrosaniye olarak ayirir.
+ *
+ * @param time_ns : nanosaniye
+ * @param usec : mikrosaniye
+ */
+static inline uint32_t klog_split_time(uint64_t time_ns,uint32_t *usec){
+
+	uint32_t sec = (uint32_t)div_u64_rem(time_ns,NSEC_PER_SEC,usec);
+
+	*usec /= 1000;
+
+	return sec;
+
+}
+
+/*
+ * klog_format, kaydi duz metin olarak bicimlendirir, yazilan uzunlugu
+ * dondurur.
+ *
+ * @param record : kayit
+ * @param buf : karakter dizisi
+ * @param size : dizinin boyutu
+ */
+uint32_t klog_format(const klog_record_t *record,char *buf,size_t size){
+
+	uint32_t usec,sec = klog_split_time(record->time_ns,&usec);
+	int32_t len;
+
+	if(record->level == KERN_DUMP)
+		len = snprintf(buf,size,"[%5u.%06u] %s\n",sec,usec,record->text);
+	else
+		len = snprintf(buf,size,"[%5u.%06u] %s: [module = %.40s line = %u] %s\n",sec,usec,
+			       level_names[record->level],record->file,record->line,record->text);
+
+	return (uint32_t)len < size ? (uint32_t)len : size - 1;
+
+}
+
+/*
+ * klog_sink_wants, kayit cikisin seviyesine uygun mu?
+ *
+ * @param sink : cikis
+ * @param record : kayit
+ */
+static inline bool klog_sink_wants(const klog_sink_t *sink,const klog_record_t *record){
+
+	return record->level == KERN_DUMP || record->level >= sink->level;
+
+}
+
+/*
+ * klog_render, kaydi vga konsola basar. printf ciktiyi toplu halde
+ * putstr'e verir, imlec kayit basina birkac kez tasinir.
+ *
+ * @param record : kayit
+ */
+static void klog_render(const klog_record_t *record){
+
+	uint32_t usec,sec;
+
+	if(record->level == KERN_DUMP){
+		printf("%s\n",record->text);
+		return;
+	}
+
+	sec = klog_split_time(record->time_ns,&usec);
+	printf("[%5u.%06u] %s: [module = %.40s line = %u]\n-> %s\n",sec,usec,level_msgs[record->level],
+	       record->file,record->line,record->text);
+
+}
+
+/*
+ * klog_flush, cikislara basilmamis kayitlari toplu halde basar. baska
+ * bir islemci zaten bosaltiyorsa hemen doner. kilit birakildiktan
+ * sonra yeni kayit gelmisse tekrar denenir ki kayit askida kalmasin.
+ * yayinlanmamis bir kayitta durulursa onu yazan kendi klog_flush'inda
+ * bosaltir.
+ */
+void klog_flush(void){
+
+	klog_record_t record;
+	uint32_t flags = irq_save(),prev,seq;
+
+	while(klog_console_seq != klog_head && spin_trylock(&klog_console_lock)){
+
+		klog_stats.batches++;
+
+		for(prev = klog_console_seq; klog_read(&klog_console_seq,&record); prev = klog_console_seq){
+
+			bool rendered = false;
+
+			klog_stats.overwritten += klog_console_seq - prev - 1;
+
+			for(uint32_t i = 0; i < klog_nr_sinks; i++)
+				if(klog_sink_wants(klog_sinks[i],&record)){
+					klog_sinks[i]->write(&record);
+					rendered = true;
+				}
+
+			if(rendered)
+				klog_stats.rendered++;
+
+		}
+
+		seq = klog_console_seq;
+		spin_unlock(&klog_console_lock);
+
+		/*
+		 * kilidi biraktiktan sonra bakiyoruz, kayit o arada yayinlandiysa
+		 * yazani kilidi alamamis olabilir.
+		 */
+		mb();
+		if(seq != klog_head && klog_ring[seq & KLOG_MASK].seq != seq + 1)
+			break;
+
+	}
+
+	irq_restore(flags);
+
+}
+
+/*
+ * klog_register_sink, yeni bir log cikisi ekler. halkada kalan ve
+ * diger cikislara zaten basilmis kayitlar once yeni cikisa basilir,
+ * boylece erken acilis kayitlari da kaybolmaz.
+ *
+ * @param sink : cikis
+ */
+bool klog_register_sink(klog_sink_t *sink){
+
+	klog_record_t record;
+	uint32_t flags = spin_lock_irqsave(&klog_console_lock);
+	uint32_t seq = klog_first_seq();
+
+	if(klog_nr_sinks == KLOG_MAX_SINKS){
+		spin_unlock_irqrestore(&klog_console_lock,flags);
+		return false;
+	}
+
+	while((int32_t)(klog_console_seq - seq) > 0 && klog_read(&seq,&record))
+		if(klog_sink_wants(sink,&record))
+			sink->write(&record);
+
+	klog_sinks[klog_nr_sinks++] = sink;
+
+	spin_unlock_irqrestore(&klog_console_lock,flags);
+
+	return true;
+
+}
+
+/*
+ * klog_panic, sistem durdurulmadan once cagrilir. cikislar kesmesiz
+ * moda gecirilir ve konsol kilidi zorla acilir, kilidi tutan islemci
+ * bir daha donmeyebilir.
+ */
+void klog_panic(void){
+
+	spin_lock_break(&klog_console_lock);
+
+	for(uint32_t i = 0; i < klog_nr_sinks; i++)
+		if(klog_sinks[i]->panic)
+			klog_sinks[i]->panic();
+
+}
+
+/*
+ * klog_set_console_level, vga konsola basilacak en dusuk seviyeyi
+ * belirler. daha dusuk seviyeli kayitlar yalnizca halkada tutulur.
+ *
+ * @param level : kernel debug seviyesi
+ */
+void klog_set_console_level(kern_levels_t level){
+
+	klog_vga_sink.level = level;
+
+}
+
+/*
+ * klog_stat, istatistiklerin kopyasini dondurur.
+ *
+ * @param stat : istatistiklerin kopyalanacagi alan
+ */
+void klog_stat(klog_stat_t *stat){
+
+	*stat = klog_stats;
+
+}
+
+/*
+ * klog_syslog, syslog sistem cagrisinin islemlerini yapar. halkadaki
+ * kayitlar okunmakla silinmez.
+ *
+ * @param type : SYSLOG_ACTION_*
+ * @param buf : kullanici tamponu
+ * @param len : tamponun boyutu
+ */
+int32_t klog_syslog(int32_t type,char *buf,int32_t len){
+
+	klog_record_t record;
+	char line[KLOG_LINE_SIZE];
+	uint32_t seq,line_len;
+	int32_t copied = 0;
+
+	switch(type){
+		case SYSLOG_ACTION_READ_ALL:
+			if(!buf || len < 0)
+				return -EINVAL;
+
+			for(seq = klog_first_seq(); klog_read(&seq,&record); copied += line_len){
+				line_len = klog_format(&record,line,sizeof(line));
+				if(copied + line_len > (uint32_t)len)
+					break;
+				memcpy(buf + copied,line,line_len);
+			}
+
+			return copied;
+		case SYSLOG_ACTION_SIZE_BUFFER:
+			return KLOG_RECORDS * KLOG_LINE_SIZE;
+		default:
+			return -EINVAL;
+	}
+
+}
+
+/*
+ * dmesg, halkada kalan tum kayitlari konsol seviyesinden bagimsiz
+ * olarak ekrana basar. ekrandan kaymis eski kayitlari gormek icindir.
+ */
+void dmesg(void){
+
+	klog_record_t record;
+	uint32_t flags = spin_lock_irqsave(&klog_console_lock);
+
+	for(uint32_t seq = klog_first_seq(); klog_read(&seq,&record); )
+		klog_render(&record);
+
+	spin_unlock_irqrestore(&klog_console_lock,flags);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
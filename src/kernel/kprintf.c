@@ -17,32 +17,49 @@
  *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
  *  --------------------------------------------------------------------------
  *
- *  printf'in bu versiyonu 64-bit'i desteklememektedir :/.
- *
+ *  Formatted Output
  */
  
 #include <uniq/types.h>
 #include <ctype.h>
 #include <va_list.h>
 #include <uniq/kernel.h>
+#include <uniq/kprintf.h>
+#include <uniq/div64.h>
 #include <string.h>
 #include <uniq/module.h>
 
-#define MAX_HEXDIGIT	8	/* 'FFFFFFFF' */
-
 /* flags */
-#define SIGN		0x001	/* isaretli/isaretsiz sayi */
-#define PLUS		0x002	/* saga dayali */
-#define SMALL		0x004	/* '0xabdef' '0xABCDEF' */
-#define LEFT		0x008	/* sola dayali */
-#define CHAR		0x010	/* karakter */
-#define STRING		0x020	/* karakter dizisi */
-#define INTEGER		0x040	/* integer */
-#define HEX		0x080	/* hexadecimal sayilar */
-#define COLOR		0x100	/* renk */
-#define SPECIAL		0x200	/* ozel karakter icin */
-#define DOT		0x400	/* nokta */
-#define POINTER		0x800	/* pointer */
+#define LEFT		0x001	/* '-', sola dayali */
+#define ZERO		0x002	/* '0', sifirla doldur */
+#define PLUS		0x004	/* '+', pozitifse '+' */
+#define SPACE		0x008	/* ' ', pozitifse bosluk */
+#define ALT		0x010	/* '#', 0x / 0 oneki */
+#define LONGLONG	0x020	/* ll, j */
+#define SHORT		0x040	/* h */
+#define CHAR		0x080	/* hh */
+
+#define KPRINTF_NUM_BUF		32	/* 64 bit sekizlik sayi + onek + bosluk */
+#define KPRINTF_COPY_MIN	16	/* bundan uzun parcalar memcpy ile */
+
+/*
+ * sayilar sondan basa dogru, her bolme ile iki basamak yazilarak
+ * olusturulur.
+ */
+static const char digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char hex_lower[] = "0123456789abcdef";
+static const char hex_upper[] = "0123456789ABCDEF";
 
 /*
  * vga renklerinin ansi renklere cevrilmesi icin
@@ -53,714 +70,623 @@ static const char vga_to_ansi[] = {
 };
 
 /*
- * skip_atoi, kendisine verilen karater dizisinde digit
- * olanlari sayi haline getirir.
- * !dikkat : ulib icindeki atoi'den farkli olarak aldigi
- * karakter dizisinin adresini ilerletir.
+ * kprintf_flush, dolan pencereyi hedefe teslim eder.
  */
-static int skip_atoi(const char **s){
-	int i = 0;
-	
-	while (isdigit(**s))
-		i = i * 10 + *((*s)++) - '0';
-	return i;
+static void kprintf_flush(kprintf_sink_t *sink){
+
+	sink->count += sink->pos - sink->base;
+	sink->flush(sink);
+
 }
 
 /*
- * make_ansi_color, karakter dizisi seklinde verilmis karakter
- * formatini okur ve ansi renklere cevirir.
- *
- * @param s : karakter dizisi
- * !dikkat : yukaridaki skip_atoi gibi gonderilen karakter
- * dizisinin adresi ilerler.
+ * kprintf_put, parcayi pencereye kopyalar. kisa parcalar (cogu sayi
+ * ve duz metin) dongu ile, uzunlar memcpy ile kopyalanir.
  */
-static uint8_t make_ansi_color(const char **s){
+static inline void kprintf_put(kprintf_sink_t *sink,const char *s,size_t len){
 
-	/*
-	* normalde terminal ansi color boyle degil fakat
-	* kendimce basitlik acisinda bu kadari yeterli gibi.
-	* strtok kullanilmamasinin nedeni fmt'nin bozulmasiyla
-	* sonuclanacagindan ve az bucuk yine ayni kod satiri
-	* sayisi kadar olacagi icin gerek duymadim.
-	*
-	*
- 	* \033[aciklik;yazi_rengi;yazi_arkaplan_rengi ve sonuna
-	* 'm' eki
-	*
-	* aciklik = 0-1
-	* yazi rengi = 30-37
-	* arkaplan rengi = 40-47 degerlerini alir
-	*	
-	* yazi rengi :
-	* -------------
-    	* 30 Black - 31 Red - 32 Green - 33 Yellow - 34 Blue
- 	* 35 Magenta - 36 Cyan - 37 White
-	* yazi arkaplan rengi:
-	* --------------
-	* 40 Black - 41 Red - 42 Green - 43 Yellow - 44 Blue
-	* 45 Magenta - 46 Cyan - 47 White
-	*/
-	uint8_t attr;
-	if(**s == '\033'){
-			uint8_t fg,bg,t;
-			fg = bg = t = 0;
-			(*s)++;
-			if(**s == '['){
-				(*s)++;
-				if(isdigit(**s))
-					t = skip_atoi(s);
-				if(**s == ';'){
-					(*s)++;
-					if(isdigit(**s))
-						fg = skip_atoi(s);
-				}
+	for(;;){
+		size_t n = sink->end - sink->pos;
 
-				if(**s == ';'){
-					(*s)++;
-					if(isdigit(**s))
-						bg = skip_atoi(s);
-				} 
-				
-				if(**s == 'm'){
-					if(!t)						/* \033[0m */
-						attr = make_vga_color(vga_to_ansi[t],vga_to_ansi[bg]);
-					else if(t >= 0x1e && t<= 0x28)			/* \033[(30-37)m */
-						attr = make_vga_color(vga_to_ansi[t % 0x1e],vga_to_ansi[bg]);
-					else if(t >= 0x28 && t<= 0x37)			/* \033[(40-54)m */
-						attr = make_vga_color(vga_to_ansi[fg],vga_to_ansi[t % 0x28]);
-					else
-						attr = make_vga_color(vga_to_ansi[(t * 0x8) + (fg % 0x1e)],vga_to_ansi[bg % 0x28]);
-				}
-				
-			}
+		if(len < n)
+			n = len;
 
+		if(n < KPRINTF_COPY_MIN)
+			for(size_t i = 0; i < n; i++)
+				sink->pos[i] = s[i];
+		else
+			memcpy(sink->pos,s,n);
+
+		sink->pos += n;
+		len -= n;
+		if(!len)
+			return;
+
+		s += n;
+		kprintf_flush(sink);
 	}
-	
 
-	return attr;
 }
 
 /*
- * hex_number, decimal sayilari hexadecimal formatina cevirip karakter 
- * dizisi haline getirir.
- * 
- * pointer ve normal hexadecimal sayilari yazarken farklilik soyle,
- * ornegin sayi 32 decimal sayisi olsun
- * hexadecimalde : 20
- * pointer olarak ise : 0x00000020 olarak ekrana basilir
- *
- * @param buf : karakter dizisinin yazilacagi alan
- * @param flags : flaglar
- * @param nptr : sayinin adresi
+ * kprintf_pad, pencereye n adet c karakteri yazar.
  */
-static int hex_number(char *buf,uint32_t flags,uintptr_t *nptr){
-	
-	
-	int hdigit_count = 0;
-	char hex_digits[] = "0123456789ABCDEFabcdef";
-	char *tmptr;
-	char tmp_buf[8];
-	char c;
-	uint32_t number = *nptr;
-
-	if(flags & POINTER){
-		strcpy(buf,"0x");
-		buf += 2;
-	}
-	
-	tmptr = tmp_buf;
-	
-	if((flags & HEX) && (number == 0)){
-		*buf++ = '0';
-		*buf = '\0';
-		return ++hdigit_count;
+static void kprintf_pad(kprintf_sink_t *sink,char c,uint32_t n){
+
+	while(n){
+		if(sink->pos == sink->end)
+			kprintf_flush(sink);
+
+		for(; n && sink->pos < sink->end; n--)
+			*sink->pos++ = c;
 	}
 
-	while(number != 0){
-			uint8_t tmp = number % 16;
-			number/=16;
-			hdigit_count++;
-			*tmptr++ = ((flags & SMALL) && !(tmp >= 0 && tmp <=9)) ? hex_digits[tmp + 6] : hex_digits[tmp];
+}
+
+/*
+ * kprintf_dec32, sayiyi p'den geriye dogru onluk olarak yazar,
+ * en az min_digits basamak olacak sekilde sifirla doldurur.
+ *
+ * @param p : yazilacak alanin sonu
+ * @param v : sayi
+ * @param min_digits : en az basamak sayisi
+ */
+static char *kprintf_dec32(char *p,uint32_t v,uint32_t min_digits){
+
+	char *end = p;
+
+	while(v >= 100){
+		uint32_t i = (v % 100) * 2;
+
+		v /= 100;
+		p -= 2;
+		p[0] = digit_pairs[i];
+		p[1] = digit_pairs[i + 1];
 	}
-	
-	
-	*tmptr = '\0';
-	int8_t x = MAX_HEXDIGIT - hdigit_count;
-	if(flags & POINTER){
-		while(x--)
-			*buf++ = '0';
+
+	if(v >= 10){
+		p -= 2;
+		p[0] = digit_pairs[v * 2];
+		p[1] = digit_pairs[v * 2 + 1];
 	}
+	else
+		*--p = '0' + v;
+
+	while((uint32_t)(end - p) < min_digits)
+		*--p = '0';
+
+	return p;
 
-	if(hdigit_count){
-		tmptr--;
-		while(hdigit_count--)
-			*buf++ = *tmptr--; 
+}
+
+/*
+ * kprintf_dec, 64 bitlik sayiyi onluk olarak yazar. 32 bite sigana
+ * kadar 10^9'luk parcalara bolunur, boylece 64 bit bolme yalnizca
+ * buyuk sayilarda yapilir.
+ *
+ * @param p : yazilacak alanin sonu
+ * @param v : sayi
+ */
+static char *kprintf_dec(char *p,uint64_t v){
+
+	uint32_t rem;
 
+	while(v >> 32){
+		v = div_u64_rem(v,1000000000,&rem);
+		p = kprintf_dec32(p,rem,9);
 	}
-	
-	*buf = '\0';
-	
-	return (flags & HEX) ? hdigit_count : MAX_HEXDIGIT+2;
+
+	return kprintf_dec32(p,(uint32_t)v,1);
+
+}
+
+/*
+ * kprintf_base2, sayiyi 2'nin kuvveti tabanda (8, 16) yazar.
+ *
+ * @param p : yazilacak alanin sonu
+ * @param v : sayi
+ * @param shift : basamak basina bit
+ * @param digits : basamak karakterleri
+ */
+static char *kprintf_base2(char *p,uint64_t v,uint32_t shift,const char *digits){
+
+	uint32_t mask = (1 << shift) - 1;
+
+	do{
+		*--p = digits[(uint32_t)v & mask];
+		v >>= shift;
+	}while(v);
+
+	return p;
+
 }
 
 /*
- * dec_number, decimal sayilari karakter dizisi formatina gore
- * cevirir.
- * 
- * @param buf : karakter dizisinin yazilacagi alan
+ * kprintf_number, sayiyi isaret/onek, hassasiyet ve alan genisligine
+ * gore hedefe yazar.
+ *
+ * @param sink : hedef
+ * @param v : sayinin mutlak degeri
+ * @param neg : negatif mi?
+ * @param conv : donusum karakteri (d, u, x, X, o, p)
+ * @param width : alan genisligi
+ * @param prec : en az basamak sayisi, yoksa -1
  * @param flags : flaglar
- * @param nptr : sayinin adresi
  */
-static int dec_number(char *buf,uint32_t flags,uint32_t* nptr){
-
-	uint32_t decimal_n,count = 0;
-	bool neg = false;
-	if(flags & SIGN){
-		if((int32_t)*nptr < 0){
-			decimal_n = -(*nptr);
-			*buf = '-';
-			neg = true;
-			buf++;
+static void kprintf_number(kprintf_sink_t *sink,uint64_t v,bool neg,char conv,
+				uint32_t width,int32_t prec,uint32_t flags){
+
+	char buf[KPRINTF_NUM_BUF];
+	char *end = buf + sizeof(buf),*p = end;
+	char prefix[2];
+	uint32_t prefix_len = 0,digits,zeros = 0,len,pad = 0;
+
+	if(prec != 0 || v)
+		switch(conv){
+			case 'x':
+			case 'p':
+				p = kprintf_base2(end,v,4,hex_lower);
+				break;
+			case 'X':
+				p = kprintf_base2(end,v,4,hex_upper);
+				break;
+			case 'o':
+				p = kprintf_base2(end,v,3,hex_lower);
+				break;
+			default:
+				p = (v >> 32) ? kprintf_dec(end,v) : kprintf_dec32(end,(uint32_t)v,1);
+				break;
 		}
-		else
-			decimal_n = *nptr;
 
+	digits = end - p;
+
+	if(neg)
+		prefix[prefix_len++] = '-';
+	else if(flags & PLUS)
+		prefix[prefix_len++] = '+';
+	else if(flags & SPACE)
+		prefix[prefix_len++] = ' ';
+
+	if(((flags & ALT) && v && (conv == 'x' || conv == 'X')) || conv == 'p'){
+		prefix[0] = '0';
+		prefix[1] = conv == 'X' ? 'X' : 'x';
+		prefix_len = 2;
 	}
-	else
-		decimal_n = *nptr;
+	else if((flags & ALT) && conv == 'o' && (!digits || *p != '0'))
+		zeros = 1;
+
+	if(prec >= 0 && (uint32_t)prec > digits)
+		zeros = prec - digits;
 
-	if(decimal_n == 0){
-		*buf++ = '0';
-		*buf ='\0';
-		return ++count;
+	len = prefix_len + zeros + digits;
+	if((flags & (ZERO | LEFT)) == ZERO && prec < 0 && width > len){
+		zeros += width - len;
+		len = width;
 	}
-	
-	while(decimal_n > 0){
-		uint32_t temp = decimal_n % 10;
-		decimal_n /= 10;
-		*(buf++) = temp + '0';
-		count++;
-			
+
+	if(width > len)
+		pad = width - len;
+
+	if(!(flags & LEFT))
+		kprintf_pad(sink,' ',pad);
+
+	/*
+	 * onek ve sifirlar tampona sigiyorsa sayinin onune eklenip
+	 * tek parca halinde yazilir.
+	 */
+	if(zeros + prefix_len <= (uint32_t)(p - buf)){
+		while(zeros--)
+			*--p = '0';
+		while(prefix_len)
+			*--p = prefix[--prefix_len];
+		kprintf_put(sink,p,end - p);
 	}
-	*buf = '\0';
-
-	if(count){
-		char *start = (char*)buf-count;
-		buf--;
-		/* sayiyi ters cevir */
-		for(int i=0;i<count/2;i++){
-			char temp = *(start+i);
-			*(start+i) = *(buf-i);
-			*(buf-i) = temp;
-		}
+	else{
+		kprintf_put(sink,prefix,prefix_len);
+		kprintf_pad(sink,'0',zeros);
+		kprintf_put(sink,p,digits);
 	}
 
-	/* negatifse sayi +1 olarak '-' karakteri ekle */
-	return (neg) ? count + 1 : count;
+	if(flags & LEFT)
+		kprintf_pad(sink,' ',pad);
+
 }
 
 /*
- * vasprintf, kendisine verilen format ve arguman listesine
- * gore ekrana karakterleri basar.
+ * kprintf_strlen, dizinin en fazla max karakterlik uzunlugunu ve
+ * ekranda gorunen uzunlugunu tek gecisle bulur. ansi renk kodlari
+ * ("\033[1;32m") yer kaplamaz, hizalama buna gore yapilir.
  *
- * @param fmt : format
- * @param arg_list : arguman listesi
+ * @param s : karakter dizisi
+ * @param max : en fazla uzunluk
+ * @param visible : gorunen uzunluk
  */
-static int vasprintf(const char *fmt, va_list arg_list){
-	
-	uint8_t attr = DEFAULT_ATTR;
-	uint32_t flags,u,printed;
-	uint32_t len = strlen(fmt),slen,buf_len;
-	int32_t d;
-	char *s;
-	char buf[16];
-	unsigned char c;
-	bool cntrl = false;
-	printed = 0;
-
-	for( ;*fmt;++fmt){
-		if(*fmt != '%' && *fmt != '\033'){
-			putchar(*fmt,attr);
-			printed++;
+static uint32_t kprintf_strlen(const char *s,uint32_t max,uint32_t *visible){
+
+	uint32_t len = 0,hidden = 0;
+
+	for(; len < max && s[len]; len++){
+		if(s[len] != '\033')
 			continue;
+
+		uint32_t start = len;
+
+		while(len < max - 1 && s[len + 1] && s[len] != 'm')
+			len++;
+
+		hidden += len - start + 1;
+	}
+
+	*visible = len - hidden;
+
+	return len;
+
+}
+
+/*
+ * kvprintf, format'i tek gecisle isleyip ciktiyi hedefin penceresine
+ * yazar. duz metin taranirken ayni anda kopyalanir. desteklenenler:
+ *
+ *   %[-0+ #][genislik|*][.hassasiyet|*][hh|h|l|ll|j|z|t](d|i|u|x|X|o|p|c|s|%)
+ *
+ * %p, 0x onekiyle 8 basamak olarak basilir.
+ *
+ * @param sink : hedef
+ * @param fmt : format
+ * @param args : argumanlar
+ */
+int kvprintf(kprintf_sink_t *sink,const char *fmt,va_list args){
+
+	sink->count = 0;
+
+	for(;;){
+
+		const char *s;
+		uint32_t flags = 0,width = 0,len,visible;
+		int32_t prec = -1;
+		uint64_t v;
+		bool neg;
+		char conv,c;
+
+		while((c = *fmt) && c != '%'){
+			if(sink->pos == sink->end)
+				kprintf_flush(sink);
+			*sink->pos++ = c;
+			fmt++;
 		}
 
-		if(*fmt == '\033'){
-			attr = make_ansi_color(&fmt);
-			continue;
+		if(!c)
+			break;
+
+		/* flaglar */
+		for(fmt++;; fmt++){
+			if(*fmt == '-')
+				flags |= LEFT;
+			else if(*fmt == '0')
+				flags |= ZERO;
+			else if(*fmt == '+')
+				flags |= PLUS;
+			else if(*fmt == ' ')
+				flags |= SPACE;
+			else if(*fmt == '#')
+				flags |= ALT;
+			else
+				break;
 		}
-		fmt++;
-			
-		flags = 0;
-		if(*fmt == '-')
-			flags |= LEFT;
-		else
-			flags |= PLUS;
 
-		if(flags & LEFT)
+		/* alan genisligi */
+		if(*fmt == '*'){
+			int32_t w = va_arg(args,int);
+
+			if(w < 0){
+				flags |= LEFT;
+				w = -w;
+			}
+			width = w;
 			fmt++;
-		uint32_t arg_width,field_width;
-		arg_width = field_width = 0;
-		if(isdigit(*fmt))
-			field_width = skip_atoi(&fmt);			
+		}
+		else
+			while(isdigit(*fmt))
+				width = width * 10 + *fmt++ - '0';
 
+		/* hassasiyet */
 		if(*fmt == '.'){
-			flags |= DOT;
 			fmt++;
-			arg_width = skip_atoi(&fmt);
+			if(*fmt == '*'){
+				prec = va_arg(args,int);
+				if(prec < 0)
+					prec = -1;
+				fmt++;
+			}
+			else
+				for(prec = 0; isdigit(*fmt); fmt++)
+					prec = prec * 10 + *fmt - '0';
 		}
 
+		/* uzunluk, i386'da long ve size_t 32 bittir */
 		switch(*fmt){
-			case 'c':	/* karakter */
-				c = (unsigned char)va_arg(arg_list,int);
-				flags |= CHAR;
+			case 'h':
+				flags |= (*++fmt == 'h') ? CHAR : SHORT;
+				if(flags & CHAR)
+					fmt++;
+				break;
+			case 'l':
+				if(*++fmt == 'l'){
+					flags |= LONGLONG;
+					fmt++;
+				}
+				break;
+			case 'j':
+				flags |= LONGLONG;
+				fmt++;
 				break;
-			case 's':	/* karakter dizisi */
-				s = (char*)va_arg(arg_list,char*);
+			case 'z':
+			case 't':
+				fmt++;
+				break;
+		}
+
+		conv = *fmt;
+		if(!conv)
+			break;
+		fmt++;
+
+		switch(conv){
+			case 'c':
+				c = (char)va_arg(args,int);
+				if(!(flags & LEFT) && width > 1)
+					kprintf_pad(sink,' ',width - 1);
+				kprintf_pad(sink,c,1);
+				if((flags & LEFT) && width > 1)
+					kprintf_pad(sink,' ',width - 1);
+				continue;
+			case 's':
+				s = va_arg(args,const char*);
 				if(!s)
 					s = "(null)";
-				flags |= STRING;
-				slen = strlen(s);
-				break;
-			case 'd':	/* signed */
+				len = prec >= 0 ? (uint32_t)prec : (uint32_t)-1;
+				/* genislik yoksa uzunluga gerek yok, tarama ile kopyalanir */
+				if(!width){
+					for(; len && *s; len--){
+						if(sink->pos == sink->end)
+							kprintf_flush(sink);
+						*sink->pos++ = *s++;
+					}
+					continue;
+				}
+				len = kprintf_strlen(s,len,&visible);
+				width = width > visible ? width - visible : 0;
+				if(!(flags & LEFT))
+					kprintf_pad(sink,' ',width);
+				kprintf_put(sink,s,len);
+				if(flags & LEFT)
+					kprintf_pad(sink,' ',width);
+				continue;
+			case 'd':
 			case 'i':
-				d = (int32_t)va_arg(arg_list,int);
-				flags |= INTEGER;
-				flags |= SIGN;													
-				break;
-			case 'u':	/* unsigned */
-			case 'x':	/* hexadecimal */
-			case 'X':
-			case 'p':	/* pointer */
-			case 'P':
-				u = (uint32_t)va_arg(arg_list,unsigned int);
-				if(*fmt == 'x'){
-					flags |= HEX;
-					flags |= SMALL;
+				if(flags & LONGLONG){
+					int64_t d = va_arg(args,long long);
+
+					neg = d < 0;
+					v = neg ? -(uint64_t)d : (uint64_t)d;
 				}
-				else if(*fmt == 'X')
-					flags |= HEX;
-				else if(*fmt == 'u')
-					flags |= INTEGER;
-				else if(*fmt == 'p'){
-					flags |= POINTER;
-					flags |= SMALL;
+				else{
+					int32_t d = va_arg(args,int);
+
+					if(flags & CHAR)
+						d = (int8_t)d;
+					else if(flags & SHORT)
+						d = (int16_t)d;
+					neg = d < 0;
+					v = neg ? -(uint32_t)d : (uint32_t)d;
 				}
-				else
-					flags |= POINTER;
 				break;
-			case 'C':	/* renk */
-				attr = (uint8_t)va_arg(arg_list,unsigned int);
-				flags |= COLOR;
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+				if(flags & LONGLONG)
+					v = va_arg(args,unsigned long long);
+				else{
+					v = va_arg(args,unsigned int);
+					if(flags & CHAR)
+						v = (uint8_t)v;
+					else if(flags & SHORT)
+						v = (uint16_t)v;
+				}
+				neg = false;
+				flags &= ~(PLUS | SPACE);
 				break;
-			case '%':
-				putchar('%',attr);
-				flags |= SPECIAL;
+			case 'p':
+				v = (uintptr_t)va_arg(args,void*);
+				neg = false;
+				prec = 8;
+				flags &= LEFT;
 				break;
+			case '%':
+				kprintf_pad(sink,'%',1);
+				continue;
 			default:
-				putchar(*fmt,attr);
-				break;
+				/* bilinmeyen donusum oldugu gibi basilir */
+				kprintf_put(sink,fmt - 2,2);
+				continue;
+		}
+
+		/* sayilar tek noktadan basilir ki kprintf_number satir ici acilsin */
+		kprintf_number(sink,v,neg,conv,width,prec,flags);
+
+	}
+
+	return sink->count + (sink->pos - sink->base);
+
+}
+
+/*
+ * tampon hedefi, pencere olarak sona '\0' icin yer birakilmis tampon
+ * verilir. tampon dolunca sigmayan kisim kucuk bir karalama alanina
+ * yazilip atilir, yalnizca sayilir.
+ */
+#define KPRINTF_SCRATCH		32
+
+typedef struct{
+	kprintf_sink_t sink;
+	char *limit;			/* '\0' icin ayrilan yer */
+	char scratch[KPRINTF_SCRATCH];
+}kprintf_buf_t;
+
+static void kprintf_buf_flush(kprintf_sink_t *sink){
+
+	kprintf_buf_t *b = container_of(sink,kprintf_buf_t,sink);
 
+	sink->base = sink->pos = b->scratch;
+	sink->end = b->scratch + KPRINTF_SCRATCH;
+
+}
+
+/*
+ * konsol hedefi, ciktiyi kucuk bir tamponda biriktirip putstr ile
+ * toplu basar. ansi renk kodlari ("\033[1;31m") vga ozelligine
+ * cevrilir, ekrana basilmaz.
+ */
+#define KPRINTF_CONSOLE_BUF	128
+#define KPRINTF_ANSI_PARAMS	4
+
+typedef enum{
+	ANSI_NONE = 0,
+	ANSI_ESC,		/* '\033' goruldu */
+	ANSI_CSI		/* "\033[" parametreler okunuyor */
+}kprintf_ansi_state_t;
+
+typedef struct{
+	kprintf_sink_t sink;
+	uint8_t attr;
+	kprintf_ansi_state_t state;
+	uint32_t params[KPRINTF_ANSI_PARAMS];
+	uint32_t nr_params;
+	char buf[KPRINTF_CONSOLE_BUF + 1];
+}kprintf_console_t;
+
+/*
+ * kprintf_console_sgr, "\033[...m" parametrelerini vga ozelligine
+ * uygular: 0 sifirla, 1 parlak, 7 ters, 30-37 yazi, 40-47 arkaplan.
+ */
+static void kprintf_console_sgr(kprintf_console_t *con){
+
+	uint8_t fg = con->attr & 0x0F,bg = con->attr >> 4,t;
+
+	for(uint32_t i = 0; i < con->nr_params; i++){
+		uint32_t p = con->params[i];
+
+		if(p == 0){
+			fg = COLOR_LIGHT_GREY;
+			bg = COLOR_BLACK;
 		}
-		cntrl = false;
-
-		/*
-		 * char buf[32] = "\033[1;32mDeneme\033[0m";
-		 * printf("%-10s",buf);
-		 *
-		 * yukaridaki ornekteki gibi renkli yazdirilirken hizalama
-		 * konusunda bir bug olusuyordu. bunu onlemek icin gelen
-		 * karakter dizileri icindeki renk kodlarinin karakter
-		 * adedi cikartiliyor.
-		 */
-		if(flags & STRING){
-			uint32_t length = 0;
-			for(int i=0;i<slen;i++){
-				if(s[i] == '\033'){
-					length++;
-					while(s[i] != 'm' && s[i] != '\0'){
-						length++;
-						i++;
-					}
-				}
-			}
-			slen -= length;
+		else if(p == 1)
+			fg |= 0x08;
+		else if(p == 7){
+			t = fg;
+			fg = bg;
+			bg = t;
 		}
-				
-		if((flags & COLOR) || (flags & SPECIAL))		
-			continue;
-		begin:
+		else if(p >= 30 && p <= 37)
+			fg = (fg & 0x08) | vga_to_ansi[p - 30];
+		else if(p >= 40 && p <= 47)
+			bg = vga_to_ansi[p - 40];
+	}
 
-			if(flags & CHAR){
-				if(!cntrl){
-					if(field_width)
-						field_width--;
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					putchar(c,attr);
-					printed++;
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
-			}
-			else if(flags & STRING){
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > slen)
-							field_width -= slen;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
+	con->attr = make_vga_color(fg,bg);
 
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						while(*s){
-							if(*s == '\033'){
-								attr = make_ansi_color((const char**)(&s));
-								s++;
-								continue;
-							}
-							putchar(*s++,attr);
-							printed++;
-						}
-					else{
-						while(arg_width-- && *s){
-							if(*s == '\033'){
-								attr = make_ansi_color((const char**)(&s));
-								s++;
-								continue;
-							}
-							putchar(*s++,attr);
-							printed++;
-						}
-					}
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
+}
 
-			}
-			else{
-				
-				if((flags & INTEGER) && !cntrl){
-					if(flags & SIGN)
-						buf_len = dec_number(buf,flags,&d);
-					else
-						buf_len = dec_number(buf,flags,&u);
-				}
-				else if( ((flags & HEX) || (flags & POINTER)) && !cntrl)
-					buf_len = hex_number(buf,flags,&u);
-
-				s = buf;
-				
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > buf_len)
-							field_width -= buf_len;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						printed += putstr(buf,attr);
-					else{
-						while(arg_width-- && *s){
-							putchar(*s++,attr);
-							printed++;
-						}
-					}
-				}
-				if((flags& LEFT) && !cntrl)
-					goto blank;
-				
-				continue;
-			}
+/*
+ * kprintf_console_flush, penceredeki metni putstr ile basar. ansi
+ * kodlari ayiklanirken gorunen karakterler tamponun basina dogru
+ * sikistirilir, her renk degisiminde o ana kadarki kisim basilir.
+ */
+static void kprintf_console_flush(kprintf_sink_t *sink){
+
+	kprintf_console_t *con = container_of(sink,kprintf_console_t,sink);
+	char *out = con->buf;
+
+	for(char *s = con->buf; s < sink->pos; s++){
+		char c = *s;
 
-			blank:
-				while(field_width && field_width >0){
-					putchar(' ',attr);
-					printed++;
-					field_width--;
+		switch(con->state){
+			case ANSI_NONE:
+				if(c == '\033'){
+					*out = '\0';
+					if(out != con->buf)
+						putstr(con->buf,con->attr);
+					out = con->buf;
+					con->state = ANSI_ESC;
 				}
-				cntrl = true;
-				goto begin;
+				else if(c)
+					*out++ = c;
+				break;
+			case ANSI_ESC:
+				con->state = (c == '[') ? ANSI_CSI : ANSI_NONE;
+				con->nr_params = 0;
+				con->params[0] = 0;
+				break;
+			case ANSI_CSI:
+				if(isdigit(c))
+					con->params[con->nr_params] = con->params[con->nr_params] * 10 + c - '0';
+				else if(c == ';' && con->nr_params < KPRINTF_ANSI_PARAMS - 1)
+					con->params[++con->nr_params] = 0;
+				else if(c != ';'){
+					con->nr_params++;
+					if(c == 'm')
+						kprintf_console_sgr(con);
+					con->state = ANSI_NONE;
+				}
+				break;
+		}
 	}
 
-	return printed;
+	*out = '\0';
+	if(out != con->buf)
+		putstr(con->buf,con->attr);
+
+	sink->base = sink->pos = con->buf;
+	sink->end = con->buf + KPRINTF_CONSOLE_BUF;
+
 }
 
 /* 
  * vsnprintf,verilen karakter dizisine format'a gore argumanlari
- * belirtilen boyuta kadar yerlestirir.
+ * '\0' dahil en fazla n bayt olacak sekilde yerlestirir. sigsaydi
+ * yazilacak olan uzunlugu dondurur.
  *
  * @param strbuf : karakter dizisi adresi
  * @param n : boyut
  * @param fmt : format
- * @param ... : argumanlar
+ * @param arg_list : argumanlar
  */
-int vsnprintf(char *strbuf,size_t n,const char *fmt, va_list arg_list){
-	
-	uint32_t flags,u,printed;
-	uint32_t len = strlen(fmt),slen,buf_len;
-	int32_t d;
-	char *s;
-	char buf[16];
-	unsigned char c;
-	bool cntrl = false;
-	uint32_t i = 0;
-
-	for( ;n && *fmt;++fmt){
-		if(*fmt != '%'){
-			*strbuf++ = *fmt; 
-			i++;
-			n--;
-			continue;
-		}
-		fmt++;
-			
-		flags = 0;
-		if(*fmt == '-')
-			flags |= LEFT;
-		else
-			flags |= PLUS;
-
-		if(flags & LEFT)
-			fmt++;
-		uint32_t arg_width,field_width;
-		arg_width = field_width = 0;
-		if(isdigit(*fmt))
-			field_width = skip_atoi(&fmt);			
-
-		if(*fmt == '.'){
-			flags |= DOT;
-			fmt++;
-			arg_width = skip_atoi(&fmt);
-		}
+int vsnprintf(char *strbuf,size_t n,const char *fmt,va_list arg_list){
 
-		switch(*fmt){
-			case 'c':	/* karakter */
-				c = (unsigned char)va_arg(arg_list,int);
-				flags |= CHAR;
-				break;
-			case 's':	/* karakter dizisi */
-				s = (char*)va_arg(arg_list,char*);
-				if(!s)
-					s = "(null)";
-				flags |= STRING;
-				slen = strlen(s);
-				break;
-			case 'd':	/* signed */
-			case 'i':
-				d = (int32_t)va_arg(arg_list,int);
-				flags |= INTEGER;
-				flags |= SIGN;													
-				break;
-			case 'u':	/* unsigned */
-			case 'x':	/* hexadecimal */
-			case 'X':
-			case 'p':	/* pointer */
-			case 'P':
-				u = (uint32_t)va_arg(arg_list,unsigned int);
-				if(*fmt == 'x'){
-					flags |= HEX;
-					flags |= SMALL;
-				}
-				else if(*fmt == 'X')
-					flags |= HEX;
-				else if(*fmt == 'u')
-					flags |= INTEGER;
-				else if(*fmt == 'p'){
-					flags |= POINTER;
-					flags |= SMALL;
-				}
-				else
-					flags |= POINTER;
-				break;
-			case '%':
-				if(n)
-					*strbuf++ = '%';
-				i++;
-				n--;
-				flags |= SPECIAL;
-				break;
-			default:
-				break;
+	kprintf_buf_t b;		/* karalama alani sifirlanmasin diye ilk degersiz */
+	int printed;
 
-		}
-		cntrl = false;
-		
-		/* renk bug'i icin */
-		if(flags & STRING){
-			uint32_t length = 0;
-			for(int i=0;i<slen;i++){
-				if(s[i] == '\033'){
-					length++;
-					while(s[i] != 'm' && s[i] != '\0'){
-						length++;
-						i++;
-					}
-				}
-			}
-			slen -= length;
-		}
+	b.sink.flush = kprintf_buf_flush;
+	if(n){
+		/* vsprintf'in buyuk boyutu adres alanini tasirmasin */
+		if(n - 1 > (uintptr_t)-1 - (uintptr_t)strbuf)
+			n = (uintptr_t)-1 - (uintptr_t)strbuf + 1;
 
-		if(flags & SPECIAL)		
-			continue;
-		begin:
+		b.limit = strbuf + n - 1;
+		b.sink.base = b.sink.pos = strbuf;
+		b.sink.end = b.limit;
+	}
+	else
+		kprintf_buf_flush(&b.sink);
 
-			if(flags & CHAR){
-				if(!cntrl){
-					if(field_width)
-						field_width--;
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl &&  n) ){
-					*strbuf++ = c;
-					i++;
-					n--;
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
-			}
-			else if(flags & STRING){
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > slen)
-							field_width -= slen;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
+	printed = kvprintf(&b.sink,fmt,arg_list);
 
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						while(*s && n){
-							*strbuf++ = *s++;
-							i++;
-							n--;
-						}
-					else{
-						while(arg_width-- && *s && n){
-							*strbuf++ = *s++;
-							i++;
-							n--;
-						}
-					}
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
+	if(n)
+		*(b.sink.base == strbuf ? b.sink.pos : b.limit) = '\0';
 
-			}
-			else{
-				
-				if((flags & INTEGER) && !cntrl){
-					if(flags & SIGN)
-						buf_len = dec_number(buf,flags,&d);
-					else
-						buf_len = dec_number(buf,flags,&u);
-				}
-				else if( ((flags & HEX) || (flags & POINTER)) && !cntrl)
-					buf_len = hex_number(buf,flags,&u);
-
-				s = buf;
-				
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > buf_len)
-							field_width -= buf_len;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						while(*s && n){
-							*strbuf++ = *s++;
-							i++;
-							n--;
-						}
-					else{
-						while(arg_width-- && *s && n){
-							*strbuf++ = *s++;
-							i++;
-							n--;
-						}
-					}
-				}
-				if((flags& LEFT) && !cntrl)
-					goto blank;
-				
-				continue;
-			}
+	return printed;
 
-			blank:
-				while(field_width && field_width >0 && n){
-					*strbuf++ = ' ';
-					i++;
-					n--;
-					field_width--;
-				}
-				cntrl = true;
-				goto begin;
-	}
-	*strbuf = '\0';
-	return i;
 }
 
 /* 
@@ -781,242 +707,23 @@ int snprintf(char *buf,size_t n,const char *fmt, ...){
 	va_start(arg_list,fmt);
 	i = vsnprintf(buf,n,fmt,arg_list);
 	va_end(arg_list);
+
 	return i;
+
 }
 
 /* 
  * vsprintf,verilen karakter dizisine format'a gore argumanlari
- * yerlestirir.
+ * yerlestirir. tampon yeterince buyuk olmalidir.
  *
  * @param strbuf : karakter dizisi adresi
  * @param fmt : format
- * @param ... : argumanlar
+ * @param arg_list : argumanlar
  */
-int vsprintf(char *strbuf,const char *fmt, va_list arg_list){
-	
-	uint32_t flags,u,printed;
-	uint32_t len = strlen(fmt),slen,buf_len;
-	int32_t d;
-	char *s;
-	char buf[16];
-	unsigned char c;
-	bool cntrl = false;
-	uint32_t i = 0;
-
-	for( ;*fmt;++fmt){
-		if(*fmt != '%'){
-			*strbuf++ = *fmt; 
-			i++;
-			continue;
-		}
-		fmt++;
-			
-		flags = 0;
-		if(*fmt == '-')
-			flags |= LEFT;
-		else
-			flags |= PLUS;
-
-		if(flags & LEFT)
-			fmt++;
-		uint32_t arg_width,field_width;
-		arg_width = field_width = 0;
-		if(isdigit(*fmt))
-			field_width = skip_atoi(&fmt);			
-
-		if(*fmt == '.'){
-			flags |= DOT;
-			fmt++;
-			arg_width = skip_atoi(&fmt);
-		}
-
-		switch(*fmt){
-			case 'c':	/* karakter */
-				c = (unsigned char)va_arg(arg_list,int);
-				flags |= CHAR;
-				break;
-			case 's':	/* karakter dizisi */
-				s = (char*)va_arg(arg_list,char*);
-				if(!s)
-					s = "(null)";
-				flags |= STRING;
-				slen = strlen(s);
-				break;
-			case 'd':	/* signed */
-			case 'i':
-				d = (int32_t)va_arg(arg_list,int);
-				flags |= INTEGER;
-				flags |= SIGN;													
-				break;
-			case 'u':	/* unsigned */
-			case 'x':	/* hexadecimal */
-			case 'X':
-			case 'p':	/* pointer */
-			case 'P':
-				u = (uint32_t)va_arg(arg_list,unsigned int);
-				if(*fmt == 'x'){
-					flags |= HEX;
-					flags |= SMALL;
-				}
-				else if(*fmt == 'X')
-					flags |= HEX;
-				else if(*fmt == 'u')
-					flags |= INTEGER;
-				else if(*fmt == 'p'){
-					flags |= POINTER;
-					flags |= SMALL;
-				}
-				else
-					flags |= POINTER;
-				break;
-			case '%':
-				*strbuf++ = '%';
-				i++;
-				flags |= SPECIAL;
-				break;
-			default:
-				break;
-
-		}
-		cntrl = false;
-		
-		/* renk bug'i icin */
-		if(flags & STRING){
-			uint32_t length = 0;
-			for(int i=0;i<slen;i++){
-				if(s[i] == '\033'){
-					length++;
-					while(s[i] != 'm' && s[i] != '\0'){
-						length++;
-						i++;
-					}
-				}
-			}
-			slen -= length;
-		}
-
-		if(flags & SPECIAL)		
-			continue;
-		begin:
-
-			if(flags & CHAR){
-				if(!cntrl){
-					if(field_width)
-						field_width--;
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					*strbuf++ = c;
-					i++;
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
-			}
-			else if(flags & STRING){
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > slen)
-							field_width -= slen;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
+int vsprintf(char *strbuf,const char *fmt,va_list arg_list){
 
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						while(*s){
-							*strbuf++ = *s++;
-							i++;
-						}
-					else{
-						while(arg_width-- && *s){
-							*strbuf++ = *s++;
-							i++;
-						}
-					}
-				}
-				if((flags & LEFT) && !cntrl)
-					goto blank;
-				continue;
-
-			}
-			else{
-				
-				if((flags & INTEGER) && !cntrl){
-					if(flags & SIGN)
-						buf_len = dec_number(buf,flags,&d);
-					else
-						buf_len = dec_number(buf,flags,&u);
-				}
-				else if( ((flags & HEX) || (flags & POINTER)) && !cntrl)
-					buf_len = hex_number(buf,flags,&u);
-
-				s = buf;
-				
-				if(!cntrl){
-					/*
-					 * "%-10.3s"
- 					 * %(+/-)field_width.arg_width(char)
-					 */
-					if(!arg_width){
-						if(field_width > buf_len)
-							field_width -= buf_len;
-						else
-							field_width = 0;
-					}
-					else if(field_width <= arg_width)
-						field_width = 0;
-					else{
-						if(arg_width && field_width)
-							field_width -=arg_width;
-					} 
-				}
-				if((flags & PLUS) && !cntrl)
-					goto blank;
-				if( ((flags & PLUS) && cntrl) || ((flags & LEFT) && !cntrl) ){
-					if(!arg_width)
-						while(*s){
-							*strbuf++ = *s++;
-							i++;
-						}
-					else{
-						while(arg_width-- && *s){
-							*strbuf++ = *s++;
-							i++;
-						}
-					}
-				}
-				if((flags& LEFT) && !cntrl)
-					goto blank;
-				
-				continue;
-			}
+	return vsnprintf(strbuf,(size_t)-1 >> 1,fmt,arg_list);
 
-			blank:
-				while(field_width && field_width >0){
-					*strbuf++ = ' ';
-					i++;
-					field_width--;
-				}
-				cntrl = true;
-				goto begin;
-	}
-	*strbuf = '\0';
-	return i;
 }
 
 /* 
@@ -1032,19 +739,38 @@ int sprintf(char *buf, const char *fmt, ...){
 	va_list arg_list;
 	int i;
 	
-	/*
-	 * format uzunlugu, buf uzunlugundan buyuk olmamali
-	 * en azindan esit olmalidir. bug duzeltidi gibi :/
-	 * gibi oldu diyelim. simdilik bu fonksiyonda bug
-	 * bulunuyor. dikkat!
-	 */
-	
 	va_start(arg_list,fmt);
 	i = vsprintf(buf,fmt,arg_list);
 	va_end(arg_list);
+
 	return i;
+
 }
 
+/*
+ * vprintf,formatli olarak ekrana cikti verir.
+ *
+ * @param fmt : format
+ * @param arg_list : argumanlar
+ */
+int vprintf(const char *fmt,va_list arg_list){
+
+	kprintf_console_t con = {
+		.sink.flush = kprintf_console_flush,
+		.attr = DEFAULT_ATTR,
+		.state = ANSI_NONE,
+	};
+	int printed;
+
+	con.sink.base = con.sink.pos = con.buf;
+	con.sink.end = con.buf + KPRINTF_CONSOLE_BUF;
+
+	printed = kvprintf(&con.sink,fmt,arg_list);
+	kprintf_console_flush(&con.sink);
+
+	return printed;
+
+}
 
 /*
  * printf,formatli olarak ekrana cikti verir.
@@ -1056,11 +782,59 @@ int printf(const char *fmt, ...){
 
 	va_list arg_list;
 	va_start(arg_list, fmt);
-	int printed = vasprintf(fmt,arg_list);
+	int printed = vprintf(fmt,arg_list);
 	va_end(arg_list);
 	return printed;
 
 }
 
+#define KPRINTF_BENCH_LOOPS	10000
+
+/*
+ * __kprintf_bench, tipik formatlar icin snprintf'in cagri basina
+ * cycle sayisini olcer. sadece derlenen motoru olcer, eski motorla
+ * karsilastirma icin ayni bench her iki cekirdekte ayri ayri
+ * calistirilmalidir.
+ */
+void __kprintf_bench(void){
+
+	static const char *names[] = { "%u", "%s", "0x%08X", "%llu", "mixed" };
+	char buf[128];
+	uint64_t start,cycles[5];
+
+	for(uint32_t test = 0; test < 5; test++){
+
+		start = rdtsc();
+
+		for(uint32_t i = 0; i < KPRINTF_BENCH_LOOPS; i++){
+			switch(test){
+				case 0:
+					snprintf(buf,sizeof(buf),"%u",i * 2654435761U);
+					break;
+				case 1:
+					snprintf(buf,sizeof(buf),"%s","kernel/kprintf.c");
+					break;
+				case 2:
+					snprintf(buf,sizeof(buf),"0x%08X",i * 2654435761U);
+					break;
+				case 3:
+					snprintf(buf,sizeof(buf),"%llu",(uint64_t)i * 0x9E3779B97F4A7C15ULL);
+					break;
+				default:
+					snprintf(buf,sizeof(buf),"[%5u.%06u] %-10s: [module = %.40s line = %u] %d",
+						 i,i * 7,"WARNING","kernel/kprintf.c",i,-(int32_t)i);
+					break;
+			}
+		}
+
+		cycles[test] = div_u64(rdtsc() - start,KPRINTF_BENCH_LOOPS);
+
+	}
+
+	for(uint32_t test = 0; test < 5; test++)
+		debug_print(KERN_DUMP,"kprintf %-8s: %llu cycles",names[test],cycles[test]);
+
+}
+
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,135 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Lock Statistics
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/spin_lock.h>
+#include <uniq/div64.h>
+
+#ifdef LOCK_STAT
+
+/*
+ * kilitler ilk alindiklarinda bu listeye eklenir. liste sadece basina
+ * ekleme yapildigi icin cmpxchg ile kilitsiz tutulur.
+ */
+static lock_stat_t *volatile lock_stat_list = NULL;
+
+/*
+ * lock_stat_register, kilidi kayitli kilitler listesine ekler.
+ *
+ * @param stat : kilit istatistigi
+ */
+static void lock_stat_register(lock_stat_t *stat){
+
+	lock_stat_t *head;
+
+	if(__sync_lock_test_and_set(&stat->registered,1))
+		return;
+
+	if(!stat->name)
+		stat->name = "[unnamed lock]";
+
+	do{
+		head = lock_stat_list;
+		stat->next = head;
+	}while(!__sync_bool_compare_and_swap(&lock_stat_list,head,stat));
+
+}
+
+/*
+ * lock_stat_acquired, kilit alindiginda spin_lock, mcs_lock ve
+ * read/write_lock tarafindan cagrilir.
+ *
+ * @param stat : kilit istatistigi
+ * @param spin_start : beklemeye baslama zamani (tsc)
+ * @param contended : kilit beklenerek mi alindi?
+ */
+void lock_stat_acquired(lock_stat_t *stat,uint64_t spin_start,bool contended){
+
+	uint64_t now = rdtsc();
+
+	if(!stat->registered)
+		lock_stat_register(stat);
+
+	stat->acquired++;
+	if(contended){
+		stat->contended++;
+		stat->spin_cycles += now - spin_start;
+	}
+
+	stat->hold_start = now;
+
+}
+
+/*
+ * lock_stat_released, kilit birakilmadan hemen once cagrilir.
+ *
+ * @param stat : kilit istatistigi
+ */
+void lock_stat_released(lock_stat_t *stat){
+
+	uint64_t held = rdtsc() - stat->hold_start;
+
+	if(held > stat->hold_max)
+		stat->hold_max = held;
+
+}
+
+/*
+ * lock_stat_reset, kayitli tum kilitlerin sayaclarini sifirlar.
+ */
+void lock_stat_reset(void){
+
+	for(lock_stat_t *stat = lock_stat_list; stat; stat = stat->next){
+		stat->acquired = 0;
+		stat->contended = 0;
+		stat->spin_cycles = 0;
+		stat->hold_max = 0;
+	}
+
+}
+
+/*
+ * lock_stat_dump, kayitli kilitlerin istatistiklerini yazdirir.
+ * sureler tsc cinsindendir.
+ */
+void lock_stat_dump(void){
+
+	debug_print(KERN_INFO,"lock stat: name, acquired, contended, avg spin, max hold (cycles)");
+
+	for(lock_stat_t *stat = lock_stat_list; stat; stat = stat->next){
+
+		uint32_t avg_spin = 0;
+
+		if(stat->contended)
+			avg_spin = (uint32_t)div_u64(stat->spin_cycles,stat->contended);
+
+		debug_print(KERN_INFO,"%s: %u %u %u %u",stat->name,stat->acquired,stat->contended,
+								avg_spin,(uint32_t)stat->hold_max);
+
+	}
+
+}
+
+#endif /* LOCK_STAT */
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,165 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Semaphore & Mutex
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/mutex.h>
+
+/*
+ * sema_init, semaforu verilen kaynak sayisi ile hazirlar.
+ *
+ * @param sema : semafor
+ * @param count : kaynak sayisi
+ */
+void sema_init(semaphore_t *sema,int32_t count){
+
+	sema->count = count;
+	wait_queue_init(&sema->wait);
+
+}
+
+/*
+ * sema_down, kaynak kalmadiysa bir kaynak birakilana kadar sureci
+ * uyutur, sonra kaynagi alir.
+ *
+ * @param sema : semafor
+ */
+void sema_down(semaphore_t *sema){
+
+	uint32_t flags = irq_save();
+
+	while(sema->count <= 0)
+		sleep_on(&sema->wait);
+
+	sema->count--;
+	irq_restore(flags);
+
+}
+
+/*
+ * sema_trydown, kaynak varsa alir ve true dondurur, yoksa beklemeden
+ * false dondurur.
+ *
+ * @param sema : semafor
+ */
+bool sema_trydown(semaphore_t *sema){
+
+	uint32_t flags = irq_save();
+	bool ret = false;
+
+	if(sema->count > 0){
+		sema->count--;
+		ret = true;
+	}
+
+	irq_restore(flags);
+
+	return ret;
+
+}
+
+/*
+ * sema_up, kaynagi birakir ve bekleyen bir sureci uyandirir.
+ *
+ * @param sema : semafor
+ */
+void sema_up(semaphore_t *sema){
+
+	uint32_t flags = irq_save();
+
+	sema->count++;
+	wake_up_one(&sema->wait);
+	irq_restore(flags);
+
+}
+
+/*
+ * mutex_init, mutex'i kilitsiz olarak hazirlar.
+ *
+ * @param mutex : mutex
+ */
+void mutex_init(mutex_t *mutex){
+
+	mutex->locked = 0;
+	mutex->owner = NULL;
+	wait_queue_init(&mutex->wait);
+
+}
+
+/*
+ * mutex_trylock, kilit bossa alir ve true dondurur. kilit bos oldugu
+ * surece kesmeler kapatilmadan tek bir atomik islemle alinir.
+ *
+ * @param mutex : mutex
+ */
+bool mutex_trylock(mutex_t *mutex){
+
+	if(__sync_lock_test_and_set(&mutex->locked,0x1))
+		return false;
+
+	mutex->owner = current_process;
+
+	return true;
+
+}
+
+/*
+ * mutex_lock, kilidi alir. kilit baska bir surecteyse birakilana
+ * kadar uyur.
+ *
+ * @param mutex : mutex
+ */
+void mutex_lock(mutex_t *mutex){
+
+	uint32_t flags;
+
+	if(mutex_trylock(mutex))
+		return;
+
+	assert(mutex->owner != current_process);
+
+	flags = irq_save();
+
+	while(!mutex_trylock(mutex))
+		sleep_on(&mutex->wait);
+
+	irq_restore(flags);
+
+}
+
+/*
+ * mutex_unlock, kilidi birakir ve bekleyen bir sureci uyandirir.
+ *
+ * @param mutex : mutex
+ */
+void mutex_unlock(mutex_t *mutex){
+
+	uint32_t flags = irq_save();
+
+	mutex->owner = NULL;
+	__sync_lock_release(&mutex->locked);
+	wake_up_one(&mutex->wait);
+	irq_restore(flags);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
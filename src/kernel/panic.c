@@ -21,6 +21,8 @@
 #include <uniq/kernel.h>
 #include <uniq/types.h>
 #include <uniq/module.h>
+#include <uniq/klog.h>
+#include <uniq/irq_stat.h>
 
 /*
  * die,kendisine verilen formatli yada formatsiz karakter
@@ -36,9 +38,11 @@ void die(const char *fmt, ...){
 	char err_msg[4096];
 	va_list arg_list;
 	va_start(arg_list,fmt);
-	vsnprintf(err_msg,sizeof(err_msg)-1,fmt,arg_list);
+	vsnprintf(err_msg,sizeof(err_msg),fmt,arg_list);
+	klog_panic();
 	debug_print(KERN_EMERG,"%s",err_msg);
 	va_end(arg_list);
+	irq_stat_dump();
 	disable_irq();
 	halt_system();
 
@@ -52,6 +56,7 @@ void die(const char *fmt, ...){
  */
 void _assert(const char *err,const char *file,uint32_t line_no){
 	
+	klog_panic();
 	debug_print(KERN_EMERG,"Kernel Assert Fault : %s",err);
 	debug_print(KERN_DUMP,"file name : %s, line : %u",file,line_no);
 	disable_irq();
@@ -0,0 +1,133 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  PID Allocator
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/pid.h>
+#include <uniq/spin_lock.h>
+
+/*
+ * her bit bir pid'i gosterir, 1 = kullanimda. 32768 pid icin 4 KiB
+ * yer tutar. pid'ler en son verilen pid'den ileriye dogru dagitilir,
+ * sona gelince basa donulur. boylece yeni biten bir surecin pid'i
+ * hemen baska bir surece verilmez.
+ */
+static uint32_t pid_bitmap[PID_BITMAP_WORDS];
+static pid_t pid_last = PID_IDLE;
+static spinlock_t pid_lock = SPIN_LOCK_UNLOCKED("pid");
+
+/*
+ * pid_find_free, [start,end) araliginda ilk bos pid'i bulur. tum
+ * kelime doluysa tek seferde atlanir, bos bit bsf ile bulunur.
+ * bulunamazsa -1 doner.
+ *
+ * @param start : baslangic
+ * @param end : bitis
+ */
+static pid_t pid_find_free(uint32_t start,uint32_t end){
+
+	uint32_t pid = start;
+
+	while(pid < end){
+		uint32_t word = ~pid_bitmap[pid / 32] & (0xFFFFFFFF << (pid % 32));
+
+		if(word){
+			pid = (pid & ~31) + __builtin_ctz(word);
+			return pid < end ? (pid_t)pid : -1;
+		}
+
+		pid = (pid & ~31) + 32;
+	}
+
+	return -1;
+
+}
+
+/*
+ * pid_init, pid tablosunu hazirlar. 0 numarali pid bos surece
+ * ayrilmistir.
+ */
+void pid_init(void){
+
+	for(uint32_t i = 0; i < PID_BITMAP_WORDS; i++)
+		pid_bitmap[i] = 0;
+
+	pid_bitmap[0] = 1 << PID_IDLE;
+	pid_last = PID_IDLE;
+
+}
+
+/*
+ * pid_alloc, yeni bir pid ayirir. bos pid kalmadiysa -1 doner.
+ */
+pid_t pid_alloc(void){
+
+	pid_t pid;
+
+	spin_lock(&pid_lock);
+
+	pid = pid_find_free(pid_last + 1,PID_MAX);
+	if(pid < 0)
+		pid = pid_find_free(PID_IDLE + 1,pid_last + 1);
+
+	if(pid >= 0){
+		pid_bitmap[pid / 32] |= 0x1 << (pid % 32);
+		pid_last = pid;
+	}
+
+	spin_unlock(&pid_lock);
+
+	return pid;
+
+}
+
+/*
+ * pid_free, pid'i tekrar kullanilabilir yapar.
+ *
+ * @param pid : pid
+ */
+void pid_free(pid_t pid){
+
+	if(pid <= PID_IDLE || pid >= PID_MAX)
+		return;
+
+	spin_lock(&pid_lock);
+	pid_bitmap[pid / 32] &= ~(0x1 << (pid % 32));
+	spin_unlock(&pid_lock);
+
+}
+
+/*
+ * pid_is_used, pid kullanimda mi?
+ *
+ * @param pid : pid
+ */
+bool pid_is_used(pid_t pid){
+
+	if(pid < 0 || pid >= PID_MAX)
+		return false;
+
+	return (pid_bitmap[pid / 32] >> (pid % 32)) & 1;
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
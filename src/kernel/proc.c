@@ -18,30 +18,339 @@
  */
  
 #include <uniq/module.h>
+#include <uniq/kernel.h>
 #include <uniq/proc.h>
+#include <uniq/pid.h>
+#include <uniq/task.h>
+#include <uniq/runqueue.h>
 #include <tree.h>
-#include <list.h>
+#include <ilist.h>
+#include <chashmap.h>
+#include <string.h>
 
 
 process_t *current_process = NULL;			/* calistirilan surec */
 process_t *idle_process = NULL;				/* kernel bos sureci */
 
-list_t *process_list;					/* surec listesi */
-list_t *process_ready_queue;				/* hazir olan surec listesi */		
-list_t *process_sleep_queue;				/* beklemeye alinmis surec listesi */
+ilist_t process_list = ILIST_INIT(process_list);	/* surec listesi */
+ilist_t process_sleep_queue = ILIST_INIT(process_sleep_queue);	/* beklemeye alinmis surec listesi */
 tree_t *process_tree;					/* surec agaci (parent-child) */
+chashmap_t *process_map;				/* pid -> surec */
+
+uint32_t process_orphans_finished = 0;			/* toplanmayi bekleyen yetimler */
 
 char *process_default_name = "[unnamed process]";	/* varsayilan surec ismi */
 
 /*
- * process_init,
+ * process_init, surec listelerini, pid tablosunu ve pid hashmap'ini
+ * olusturur.
  */
 void process_init(void){
 
 	process_tree = tree_create();
-	process_list = list_create();
-	process_ready_queue = list_create();
-	process_sleep_queue = list_create();
+	process_map = chashmap_int_create(PROCESS_MAP_SIZE);
+	pid_init();
+	runqueue_init();
+
+	/*
+	 * bos surec agacin kokudur, ebeveyni olmayan surecler
+	 * ona baglanir.
+	 */
+	idle_process = process_alloc();
+	idle_process->id = PID_IDLE;
+	idle_process->name = "idle";
+	idle_process->flags = PROCESS_STARTED | PROCESS_RUNNING;
+	tree_node_init(&idle_process->tree_node,idle_process);
+	tree_set_root(process_tree,&idle_process->tree_node);
+	ilist_add_tail(&process_list,&idle_process->list_node);
+
+}
+
+/*
+ * process_alloc, yeni bir surec yapisi olusturur.
+ */
+process_t *process_alloc(void){
+
+	process_t *process = malloc(sizeof(process_t));
+
+	if(!process)
+		return NULL;
+
+	memset(process,0,sizeof(process_t));
+	process->name = process_default_name;
+	process->umask = PROCESS_PREUMASK;
+	ilist_node_init(&process->sched_node);
+	ilist_node_init(&process->list_node);
+
+	return process;
+
+}
+
+/*
+ * process_attach, yeni sureci surec agacina, surec listesine ve
+ * hazir kuyruguna ekler.
+ *
+ * @param process : yeni surec
+ * @param parent : ebeveyn surec
+ */
+void process_attach(process_t *process,process_t *parent){
+
+	tree_node_init(&process->tree_node,process);
+	tree_push_child_node(process_tree,&process->tree_node,&parent->tree_node);
+	ilist_add_tail(&process_list,&process->list_node);
+
+	process->flags |= PROCESS_STARTED;
+	process->last_cpu = smp_processor_id();
+	runqueue_enqueue(process);
+
+}
+
+/*
+ * process_reparent_children, cikan surecin cocuklarini agacin kokune
+ * (bos surec) baglar. kardes zinciri tek seferde tasinir. bos surec
+ * waitpid cagirmaz, bu yuzden zaten bitmis cocuklar tasinmadan once
+ * toplanir. kesmeler kapaliyken cagrilmalidir.
+ *
+ * @param process : surec
+ */
+void process_reparent_children(process_t *process){
+
+	tree_node_t *node = process->tree_node.first_child,*next;
+
+	for(; node; node = next){
+		process_t *child = (process_t*)node->item;
+
+		next = node->next_sibling;
+		if(child->flags & PROCESS_FINISHED)
+			process_reap(child);
+	}
+
+	tree_node_reparent_children(&process->tree_node,process_tree->root_node);
+
+}
+
+/*
+ * process_reap_orphans, bos surece bagliyken bitmis surecleri toplar.
+ * cikan surec kendi stack'i ve sayfa dizini uzerinde calistigi icin
+ * kendini toplayamaz, exit sayaci artirir ve is bos surece kalir.
+ * kesmeler kapaliyken bos surecten cagrilir.
+ */
+static void process_reap_orphans(void){
+
+	tree_node_t *node,*next;
+
+	if(!process_orphans_finished)
+		return;
+
+	process_orphans_finished = 0;
+
+	for(node = process_tree->root_node->first_child; node; node = next){
+		process_t *child = (process_t*)node->item;
+
+		next = node->next_sibling;
+		if(child->flags & PROCESS_FINISHED)
+			process_reap(child);
+	}
+
+}
+
+/*
+ * process_reap, bitmis (zombie) surecin tum kaynaklarini bosa cikarir.
+ * surecin kendisi calismiyor olmali, ebeveyni tarafindan cagrilir.
+ *
+ * @param process : surec
+ */
+void process_reap(process_t *process){
+
+	tree_node_unlink(&process->tree_node);
+	process_tree->node_count--;
+
+	ilist_del(&process_list,&process->list_node);
+	process_unregister(process);
+	page_directory_free(process->thread.page_dir);
+	free(process);
+
+}
+
+/*
+ * process_next, calisacak siradaki sureci secer (round-robin). calisan
+ * surec durumuna gore hazir ya da bekleme kuyruguna eklenir, baska
+ * hazir surec yoksa calismaya devam eder. hazir surec yoksa bos surec
+ * doner. kesmeler kapaliyken cagrilmalidir.
+ */
+process_t *process_next(void){
+
+	process_t *prev = current_process;
+	process_t *next = runqueue_dequeue();
+
+	if(prev != idle_process){
+
+		if(prev->flags & PROCESS_SLEEPING)
+			ilist_add_tail(&process_sleep_queue,&prev->sched_node);
+		else if(!(prev->flags & PROCESS_FINISHED)){
+			if(!next)
+				return prev;
+			runqueue_requeue(prev);
+		}
+
+	}
+
+	return next ? next : idle_process;
+
+}
+
+/*
+ * process_prepare_sleep, calisan sureci uyuyor olarak isaretler, surec
+ * bundan sonraki process_sleep'te kuyruktan cikar. bekleme kuyrugunun
+ * kilidi birakilmadan cagrilmalidir. boylece kilit birakildiktan sonra
+ * baska islemciden gelen process_wakeup bayragi temizler ve
+ * process_sleep hic uyumadan doner, uyandirma kaybolmaz.
+ */
+void process_prepare_sleep(void){
+
+	current_process->flags |= PROCESS_SLEEPING;
+
+}
+
+/*
+ * process_sleep, process_prepare_sleep ile isaretlenmis sureci
+ * process_wakeup cagrilana kadar uyutur, arada uyandirilmissa hemen
+ * doner. kesmeler kapaliyken cagrilmalidir. bos surec hicbir kuyrukta
+ * beklemez, baska hazir surec yoksa bir sonraki kesmeye kadar uyur.
+ * cagiran, uyanmasina sebep olan kosulu tekrar kontrol etmelidir.
+ */
+void process_sleep(void){
+
+	process_t *process = current_process;
+
+	if(!(process->flags & PROCESS_SLEEPING))
+		return;
+
+	switch_task();
+
+	if(process->flags & PROCESS_SLEEPING){
+		safe_halt();
+		disable_irq();
+		process->flags &= ~PROCESS_SLEEPING;
+	}
+
+}
+
+/*
+ * process_wakeup, uyuyan sureci hazir kuyruguna alir.
+ *
+ * @param process : surec
+ */
+void process_wakeup(process_t *process){
+
+	uint32_t flags;
+
+	if(!(process->flags & PROCESS_SLEEPING))
+		return;
+
+	flags = irq_save();
+	process->flags &= ~PROCESS_SLEEPING;
+
+	/*
+	 * bos surec hicbir kuyrukta durmaz, calisan surec ise henuz
+	 * kuyruga eklenmemistir.
+	 */
+	if(process != idle_process && ilist_linked(&process->sched_node)){
+
+		ilist_del(&process_sleep_queue,&process->sched_node);
+		runqueue_enqueue(process);
+
+	}
+
+	irq_restore(flags);
+
+}
+
+/*
+ * process_from_pid, pid'e ait sureci hashmap uzerinden bulur.
+ * bulunamazsa NULL doner. bos surec (pid 0) hashmap'te tutulmaz,
+ * int hashmap'ler 0 anahtarini kabul etmez.
+ *
+ * @param pid : surec id
+ */
+process_t *process_from_pid(pid_t pid){
+
+	if(pid == PID_IDLE)
+		return idle_process;
+
+	if(pid < 0 || !pid_is_used(pid))
+		return NULL;
+
+	return (process_t*)chashmap_get(process_map,(void*)pid);
+
+}
+
+/*
+ * process_register, surece yeni bir pid ayirir ve sureci pid
+ * hashmap'ine ekler. pid kalmadiysa -1 doner.
+ *
+ * @param process : surec
+ */
+int32_t process_register(process_t *process){
+
+	pid_t pid = pid_alloc();
+
+	if(pid < 0)
+		return -1;
+
+	process->id = pid;
+	chashmap_set(process_map,process,(void*)pid);
+
+	return pid;
+
+}
+
+/*
+ * process_unregister, sureci pid hashmap'inden cikarir ve pid'i
+ * tekrar kullanilabilir yapar.
+ *
+ * @param process : surec
+ */
+void process_unregister(process_t *process){
+
+	if(process->id == PID_IDLE)
+		return;
+
+	chashmap_remove(process_map,(void*)process->id);
+	pid_free(process->id);
+
+}
+
+/*
+ * process_idle, kernel bos sureci (idle_process) dongusu. hazir surec
+ * varsa ona gecer, calisacak is yokken islemciyi hlt ile bir sonraki kesmeye kadar uyutur. tick'siz
+ * modda uyumadan once periyodik tick durdurulur ve pit en yakin
+ * zamanlayiciya gore kurulur, uyanista jiffies duzeltilir.
+ */
+void process_idle(void){
+
+	for(;;){
+		disable_irq();
+
+		process_reap_orphans();
+
+		/* calisacak surec var */
+		if(runqueue_pending()){
+			switch_task();
+			enable_irq();
+			continue;
+		}
+
+#ifdef PIT_TICKLESS_IDLE
+		timer_nohz_enter();
+#endif
+		safe_halt();	/* sti; hlt - kesme gelince uyaniriz */
+#ifdef PIT_TICKLESS_IDLE
+		disable_irq();
+		timer_nohz_exit();
+		enable_irq();
+#endif
+	}
 
 }
  
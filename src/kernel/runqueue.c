@@ -0,0 +1,386 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Per-CPU Run Queues
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/runqueue.h>
+#include <uniq/asm.h>
+
+runqueue_t runqueues[MAX_CPUS];
+
+/*
+ * wsdeque_size, kuyruktaki yaklasik eleman sayisi. baska cpu'lar
+ * eszamanli calabildigi icin sonuc sadece ipucudur.
+ *
+ * @param deque : kuyruk
+ */
+static inline uint32_t wsdeque_size(wsdeque_t *deque){
+
+	int32_t size = (int32_t)(deque->bottom - deque->top);
+
+	return size > 0 ? (uint32_t)size : 0;
+
+}
+
+/*
+ * wsdeque_push, kuyrugun sonuna ekler. sadece sahibi olan cpu,
+ * kesmeler kapaliyken cagirabilir. kuyruk doluysa false doner.
+ *
+ * @param deque : kuyruk
+ * @param process : surec
+ */
+static bool wsdeque_push(wsdeque_t *deque,process_t *process){
+
+	uint32_t bottom = deque->bottom;
+
+	if((int32_t)(bottom - deque->top) >= RQ_DEQUE_SIZE)
+		return false;
+
+	deque->slots[bottom & RQ_DEQUE_MASK] = process;
+	/*
+	 * x86'da store'lar sirayla gorunur, yuvanin bottom'dan once
+	 * yazilmasi icin derleyici bariyeri yeterlidir.
+	 */
+	barrier();
+	deque->bottom = bottom + 1;
+
+	return true;
+
+}
+
+/*
+ * wsdeque_steal, kuyrugun basindan bir eleman alir. herhangi bir
+ * cpu cagirabilir. kuyruk bossa NULL doner, cas yarisi kaybedilirse
+ * NULL doner ve aborted true olur.
+ *
+ * @param deque : kuyruk
+ * @param aborted : yaris kaybedildi mi?
+ */
+static process_t *wsdeque_steal(wsdeque_t *deque,bool *aborted){
+
+	uint32_t top,bottom;
+	process_t *process;
+
+	*aborted = false;
+
+	top = deque->top;
+	/* x86'da load'lar sirayla yapilir, top bottom'dan once okunmali */
+	barrier();
+	bottom = deque->bottom;
+
+	if((int32_t)(bottom - top) <= 0)
+		return NULL;
+
+	process = deque->slots[top & RQ_DEQUE_MASK];
+	if(!__sync_bool_compare_and_swap(&deque->top,top,top + 1)){
+		*aborted = true;
+		return NULL;
+	}
+
+	return process;
+
+}
+
+/*
+ * runqueue_init, tum cpu'larin kuyruklarini hazirlar ve bsp'nin
+ * kuyrugunu etkinlestirir.
+ */
+void runqueue_init(void){
+
+	for(uint32_t i = 0; i < MAX_CPUS; i++){
+
+		runqueue_t *rq = &runqueues[i];
+
+		rq->deque.top = rq->deque.bottom = 0;
+		spin_lock_init(&rq->inbox_lock);
+		ilist_init(&rq->inbox);
+		rq->active = 0;
+
+	}
+
+	runqueue_stat_reset();
+	runqueue_activate(smp_processor_id());
+
+}
+
+/*
+ * runqueue_activate, cpu'nun kuyrugunu uzak uyandirmalara ve calmaya
+ * acar. cpu kendi zamanlayici dongusune girmeden once cagirmalidir.
+ *
+ * @param cpu : cpu numarasi
+ */
+void runqueue_activate(uint32_t cpu){
+
+	runqueues[cpu].active = 1;
+
+}
+
+/*
+ * runqueue_load, cpu'nun kuyrugundaki surec sayisi (yaklasik).
+ *
+ * @param cpu : cpu numarasi
+ */
+uint32_t runqueue_load(uint32_t cpu){
+
+	runqueue_t *rq = &runqueues[cpu];
+
+	return wsdeque_size(&rq->deque) + rq->inbox.size;
+
+}
+
+/*
+ * runqueue_inbox_link, sureci cpu'nun gelen kutusuna ekler.
+ *
+ * @param rq : kuyruk
+ * @param process : surec
+ */
+static void runqueue_inbox_link(runqueue_t *rq,process_t *process){
+
+	spin_lock(&rq->inbox_lock);
+	ilist_add_tail(&rq->inbox,&process->sched_node);
+	spin_unlock(&rq->inbox_lock);
+
+}
+
+/*
+ * runqueue_enqueue, sureci hazir kuyruguna ekler. surec en son
+ * calistigi cpu'ya gonderilir (onbellegi hala sicak olabilir), o cpu
+ * etkin degilse yerel kuyruga eklenir. uzak cpu sureci kendi inbox'indan
+ * bir sonraki secimde alir, yuk dengesizligini bos cpu'larin calmasi
+ * giderir. surec baska cpu'da henuz kaydediliyor olabilecegi icin
+ * uzaktaki surec asla calinabilir yerel kuyruga alinmaz.
+ *
+ * @param process : surec
+ */
+void runqueue_enqueue(process_t *process){
+
+	uint32_t flags = irq_save();
+	uint32_t self = smp_processor_id();
+	uint32_t target = process->last_cpu;
+	runqueue_t *rq = &runqueues[self];
+
+	if(target >= MAX_CPUS || !runqueues[target].active)
+		target = self;
+
+	if(target == self){
+
+		if(wsdeque_push(&rq->deque,process))
+			rq->stat.enqueued++;
+		else
+			runqueue_inbox_link(rq,process);
+
+	}else{
+
+		/* zamanlama ipi'si henuz yok, uzak cpu'nun bir sonraki tick'ini bekler */
+		rq->stat.remote++;
+		runqueue_inbox_link(&runqueues[target],process);
+
+	}
+
+	irq_restore(flags);
+
+}
+
+/*
+ * runqueue_requeue, zaman dilimi dolan sureci calisan cpu'nun inbox'ina
+ * geri koyar. surecin kaydedicileri henuz kaydedilmedigi icin calinabilir
+ * kuyruga hemen eklenmez, inbox bir sonraki secimde (surec bu cpu'dan
+ * tamamen ciktiktan sonra) bosaltilir. kesmeler kapaliyken cagrilmalidir.
+ *
+ * @param process : surec
+ */
+void runqueue_requeue(process_t *process){
+
+	runqueue_inbox_link(&runqueues[smp_processor_id()],process);
+
+}
+
+/*
+ * runqueue_drain_inbox, gelen kutusundaki surecleri yerel kuyruga
+ * tasir. kuyruk dolarsa kalanlar inbox'ta bekler.
+ *
+ * @param rq : yerel kuyruk
+ */
+static void runqueue_drain_inbox(runqueue_t *rq){
+
+	ilist_node_t *node;
+
+	/* kilitsiz bakis, bos inbox icin kilit alinmaz */
+	if(!rq->inbox.size)
+		return;
+
+	spin_lock(&rq->inbox_lock);
+
+	while((node = ilist_first(&rq->inbox))){
+
+		if(!wsdeque_push(&rq->deque,ilist_entry(node,process_t,sched_node)))
+			break;
+
+		ilist_del(&rq->inbox,node);
+
+	}
+
+	spin_unlock(&rq->inbox_lock);
+
+}
+
+/*
+ * runqueue_steal, en yuklu etkin cpu'dan bir surec calar. cas yarisi
+ * kaybedilirse kurban yeniden secilir.
+ *
+ * @param self : calan cpu
+ */
+static process_t *runqueue_steal(uint32_t self){
+
+	runqueue_t *rq = &runqueues[self];
+	process_t *process;
+	bool aborted;
+
+	for(uint32_t retry = 0; retry < RQ_STEAL_RETRIES; retry++){
+
+		uint32_t victim = self,max_load = 0;
+
+		for(uint32_t i = 0; i < cpu_count; i++){
+
+			uint32_t load;
+
+			if(i == self || !runqueues[i].active)
+				continue;
+
+			load = wsdeque_size(&runqueues[i].deque);
+			if(load > max_load){
+				max_load = load;
+				victim = i;
+			}
+
+		}
+
+		if(victim == self)
+			return NULL;
+
+		process = wsdeque_steal(&runqueues[victim].deque,&aborted);
+		if(process){
+			rq->stat.steals++;
+			if(process->last_cpu != self)
+				rq->stat.migrations++;
+			return process;
+		}
+
+		if(aborted)
+			rq->stat.steal_aborts++;
+
+	}
+
+	return NULL;
+
+}
+
+/*
+ * runqueue_dequeue, calisan cpu icin siradaki sureci secer. once inbox
+ * yerel kuyruga aktarilir, sonra yerel kuyrugun basindan alinir, o da
+ * bossa en yuklu cpu'dan calinir. zaman dilimli round-robin icin sahibi
+ * de kuyrugu fifo kullanir (bottom'dan lifo pop, ayni sureci tekrar
+ * tekrar secerdi). kesmeler kapaliyken cagrilmalidir, is yoksa NULL doner.
+ */
+process_t *runqueue_dequeue(void){
+
+	uint32_t self = smp_processor_id();
+	runqueue_t *rq = &runqueues[self];
+	process_t *process;
+	bool aborted;
+
+	runqueue_drain_inbox(rq);
+
+	do{
+		process = wsdeque_steal(&rq->deque,&aborted);
+	}while(aborted);
+
+	if(process)
+		rq->stat.dequeued++;
+	else if(!(process = runqueue_steal(self))){
+		rq->stat.idle++;
+		return NULL;
+	}
+
+	process->last_cpu = self;
+
+	return process;
+
+}
+
+/*
+ * runqueue_pending, calisan cpu'nun secebilecegi bir surec var mi?
+ * bos dongu tarafindan kullanilir.
+ */
+bool runqueue_pending(void){
+
+	uint32_t self = smp_processor_id();
+
+	if(runqueue_load(self))
+		return true;
+
+	for(uint32_t i = 0; i < cpu_count; i++)
+		if(i != self && runqueues[i].active && wsdeque_size(&runqueues[i].deque))
+			return true;
+
+	return false;
+
+}
+
+/*
+ * runqueue_stat_reset, dengeleme istatistiklerini sifirlar.
+ */
+void runqueue_stat_reset(void){
+
+	for(uint32_t i = 0; i < MAX_CPUS; i++){
+		rq_stat_t *stat = &runqueues[i].stat;
+
+		stat->enqueued = stat->remote = stat->dequeued = 0;
+		stat->steals = stat->steal_aborts = stat->migrations = 0;
+		stat->idle = 0;
+	}
+
+}
+
+/*
+ * runqueue_stat_dump, etkin cpu'larin dengeleme istatistiklerini yazdirir.
+ */
+void runqueue_stat_dump(void){
+
+	debug_print(KERN_INFO,"runqueue stat: cpu, load, enqueued, remote, dequeued, steals, aborts, migrations, idle");
+
+	for(uint32_t i = 0; i < cpu_count; i++){
+
+		rq_stat_t *stat = &runqueues[i].stat;
+
+		if(!runqueues[i].active)
+			continue;
+
+		debug_print(KERN_INFO,"cpu%u: %u %u %u %u %u %u %u %u",i,runqueue_load(i),stat->enqueued,
+				stat->remote,stat->dequeued,stat->steals,stat->steal_aborts,
+				stat->migrations,stat->idle);
+
+	}
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -18,6 +18,41 @@
  */
  
 #include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/proc.h>
+#include <uniq/signal.h>
+#include <uniq/errno.h>
+
+/*
+ * kill, pid'i verilen surece sinyal gonderir. surec pid hashmap'i
+ * uzerinden bulunur, sinyal surecin bekleyen sinyallerine eklenir ve
+ * surec bir sonraki calismasinda isler. sig 0 ise sadece surecin
+ * varligi kontrol edilir. basarili ise 0, degilse -1 doner.
+ *
+ * @param pid : surec id
+ * @param sig : sinyal
+ */
+int32_t kill(pid_t pid,int32_t sig){
+
+	process_t *process;
+
+	if(sig < 0 || sig >= NSIG)
+		return -EINVAL;
+
+	/* surec gruplari henuz yok */
+	if(pid <= 0)
+		return -ESRCH;
+
+	process = process_from_pid(pid);
+	if(!process || (process->flags & PROCESS_FINISHED))
+		return -ESRCH;
+
+	if(sig)
+		__sync_fetch_and_or(&process->signal_pending,signal_mask(sig));
+
+	return 0;
+
+}
  
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
@@ -16,9 +16,124 @@
  *  You should have received a copy of the GNU General Public License along
  *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
  */
- 
+
 #include <uniq/module.h>
+#include <uniq/kernel.h>
 #include <uniq/regs.h>
+#include <uniq/errno.h>
+#include <uniq/syscall_nums.h>
+#include <uniq/proc.h>
+#include <uniq/task.h>
+#include <uniq/signal.h>
+#include <uniq/futex.h>
+#include <uniq/klog.h>
+#include <uniq/time.h>
+#include <mm/mem.h>
+
+#define SYSCALL_INT		0x80
+#define SYSCALL_GATE		0xEE	/* kesme kapisi, dpl 3 */
+#define KERN_CODE_SEGMENT	0x8
+
+extern void _isr128(void);
+
+/*
+ * sistem cagrilarinin hepsi ayni imzaya sahiptir, parametreler sirasiyla
+ * ebx, ecx, edx, esi, edi kaydedicilerinden alinir. donus degeri eax'e
+ * yazilir, hata durumunda negatif errno doner.
+ */
+typedef int32_t (*syscall_t)(uint32_t,uint32_t,uint32_t,uint32_t,uint32_t);
+
+static int32_t sys_exit(uint32_t status,uint32_t a2,uint32_t a3,uint32_t a4,uint32_t a5){
+
+	exit((int32_t)status);
+
+}
+
+static int32_t sys_fork(uint32_t a1,uint32_t a2,uint32_t a3,uint32_t a4,uint32_t a5){
+
+	pid_t pid = fork();
+
+	return pid < 0 ? -ENOMEM : pid;
+
+}
+
+static int32_t sys_waitpid(uint32_t pid,uint32_t status,uint32_t options,uint32_t a4,uint32_t a5){
+
+	if(status && user_access_check((int32_t*)status,sizeof(int32_t),true))
+		return -EFAULT;
+
+	return waitpid((pid_t)pid,(int32_t*)status,(int32_t)options);
+
+}
+
+static int32_t sys_getpid(uint32_t a1,uint32_t a2,uint32_t a3,uint32_t a4,uint32_t a5){
+
+	return get_pid();
+
+}
+
+static int32_t sys_kill(uint32_t pid,uint32_t sig,uint32_t a3,uint32_t a4,uint32_t a5){
+
+	return kill((pid_t)pid,(int32_t)sig);
+
+}
+
+static int32_t sys_syslog(uint32_t type,uint32_t buf,uint32_t len,uint32_t a4,uint32_t a5){
+
+	if(type == SYSLOG_ACTION_READ_ALL){
+		if((int32_t)len < 0)
+			return -EINVAL;
+
+		/* halkadan fazlasi hicbir zaman yazilmaz */
+		if(len > KLOG_RECORDS * KLOG_LINE_SIZE)
+			len = KLOG_RECORDS * KLOG_LINE_SIZE;
+
+		if(!buf || user_access_check((char*)buf,len,true))
+			return -EFAULT;
+	}
+
+	return klog_syslog((int32_t)type,(char*)buf,(int32_t)len);
+
+}
+
+static int32_t sys_futex(uint32_t uaddr,uint32_t op,uint32_t val,uint32_t timeout,uint32_t a5){
+
+	if(user_access_check((uint32_t*)uaddr,sizeof(uint32_t),false))
+		return -EFAULT;
+
+	if(timeout && user_access_check((timespec_t*)timeout,sizeof(timespec_t),false))
+		return -EFAULT;
+
+	return futex((uint32_t*)uaddr,(int32_t)op,val,(const timespec_t*)timeout);
+
+}
+
+static int32_t sys_clock_gettime(uint32_t clk_id,uint32_t tp,uint32_t a3,uint32_t a4,uint32_t a5){
+
+	timespec_t ts;
+
+	if(user_access_check((timespec_t*)tp,sizeof(timespec_t),true))
+		return -EFAULT;
+
+	if(clock_gettime((clockid_t)clk_id,&ts) < 0)
+		return -EINVAL;
+
+	*(timespec_t*)tp = ts;
+
+	return 0;
+
+}
+
+static syscall_t syscall_table[NR_SYSCALLS] = {
+	[SYS_EXIT]	= sys_exit,
+	[SYS_FORK]	= sys_fork,
+	[SYS_WAITPID]	= sys_waitpid,
+	[SYS_GETPID]	= sys_getpid,
+	[SYS_KILL]	= sys_kill,
+	[SYS_SYSLOG]	= sys_syslog,
+	[SYS_FUTEX]	= sys_futex,
+	[SYS_CLOCK_GETTIME] = sys_clock_gettime,
+};
 
 /*
  * syscall_handler, sistem cagrilari isleyicisidir.
@@ -26,17 +141,31 @@
  * @param regs : kaydediciler
  */
 void syscall_handler(registers_t *regs){
-	
 
-}
+	syscall_t call = NULL;
+
+	if(regs->eax < NR_SYSCALLS)
+		call = syscall_table[regs->eax];
 
+	if(!call){
+		regs->eax = (uint32_t)-ENOSYS;
+		return;
+	}
+
+	regs->eax = (uint32_t)call(regs->ebx,regs->ecx,regs->edx,regs->esi,regs->edi);
+
+}
 
 /*
- * syscall_init, 
+ * syscall_init, int 0x80 kapisini kurar. kapi dpl 3 ile kurulur ki
+ * kullanici modundan da cagrilabilsin.
  */
 void syscall_init(void){
- 
- 
+
+	futex_init();
+	idt_set_gate(SYSCALL_INT,_isr128,KERN_CODE_SEGMENT,SYSCALL_GATE);
+	isr_add_handler(SYSCALL_INT,syscall_handler);
+
 }
 
 MODULE_AUTHOR("Burak Köken");
@@ -19,12 +19,16 @@
  
 #include <uniq/module.h>
 #include <uniq/task.h>
+#include <uniq/proc.h>
 #include <mm/mem.h>
 #include <mm/heap.h>
 #include <uniq/kernel.h>
+#include <uniq/irq_stat.h>
+#include <uniq/smp.h>
 #include <string.h>
 
-uint32_t next_pid = 0;
+#define KERNEL_STACK_TOP	0xE0000000	/* surecin kernel stack'i (kopyalanir) */
+#define KERNEL_STACK_SIZE	0x4000		/* 16 KiB */
 
 extern page_dir_t *kernel_dir;
 extern page_dir_t *current_dir;
@@ -44,7 +48,10 @@ void goto_user_mode(void){
  */
 uint32_t get_pid(void){
 
-	return 0;
+	if(!current_process)
+		return 0;
+
+	return current_process->id;
 
 }
 
@@ -96,7 +103,12 @@ page_dir_t *page_directory_clone(page_dir_t *src_directory){
 	uint32_t physical;
 	page_dir_t *clone_directory = (page_dir_t*)kmalloc_aphysic(sizeof(page_dir_t),&physical);
 	memset(clone_directory,0,sizeof(page_dir_t));
-	clone_directory->physical_addr = physical;
+	/*
+	 * cr3'e sayfa dizini yapisinin degil, physical_tables dizisinin
+	 * fiziksel adresi yazilir. dizi ayri bir sayfada oldugu icin
+	 * adresini ayrica buluyoruz.
+	 */
+	clone_directory->physical_addr = virt_to_phys((uint32_t)clone_directory->physical_tables);
 
 	for(uint32_t i = 0; i < PAGE_TABLE_MAX;i++){
 
@@ -128,33 +140,140 @@ page_dir_t *page_directory_clone(page_dir_t *src_directory){
  *
  * @param directory : sayfa dizini adresi(isaretcisi)
  */
-void *page_directory_free(page_dir_t *directory){
+void page_directory_free(page_dir_t *directory){
+
+	if(!directory)
+		return;
+
+	for(uint32_t i = 0; i < PAGE_TABLE_MAX; i++){
+
+		page_table_t *table = directory->tables[i];
+
+		/* kernel tablolari paylasiliyor, onlara dokunmuyoruz */
+		if(!table || table == kernel_dir->tables[i])
+			continue;
+
+		for(uint32_t j = 0; j < PAGE_MAX; j++)
+			free_frame(&table->pages[j]);
+
+		free(table);
+
+	}
 
+	free(directory);
 
 }
 
 /*
- * switch_task,
+ * move_stack, boot stack'i ilk 1 MiB'ta, yani tum sureclerin paylastigi
+ * kernel sayfa tablosunda duruyor. fork'ta her surecin kendi stack'i
+ * olmasi icin stack'i kernel_dir'de olmayan bir adrese tasiyoruz,
+ * boylece page_directory_clone stack'i kopyalar. eski stack'i gosteren
+ * degerler (ebp zinciri) yeni stack'e gore duzeltilir.
+ *
+ * @param new_stack_top : yeni stack'in ust adresi
+ * @param size : yeni stack boyutu
+ * @param initial_esp : boot stack'in ust adresi
  */
-void switch_task(void){
+static void move_stack(uint32_t new_stack_top,uint32_t size,uint32_t initial_esp){
+
+	uint32_t old_esp,old_ebp,new_esp,new_ebp,offset;
+
+	for(uint32_t i = new_stack_top - size; i < new_stack_top; i += FRAME_SIZE_BYTE)
+		alloc_frame(get_page(i,true,current_dir),PAGE_RWRITE,PAGE_KERNEL_ACCESS);
+
+	/* tlb'yi temizle */
+	__asm__ volatile("mov %%cr3, %%eax\n\t"
+			 "mov %%eax, %%cr3" ::: "eax");
+
+	__asm__ volatile("mov %%esp, %0" : "=r"(old_esp));
+	__asm__ volatile("mov %%ebp, %0" : "=r"(old_ebp));
+
+	offset = new_stack_top - initial_esp;
+	new_esp = old_esp + offset;
+	new_ebp = old_ebp + offset;
+
+	memcpy((void*)new_esp,(void*)old_esp,initial_esp - old_esp);
+
+	for(uint32_t i = new_esp; i < new_stack_top; i += sizeof(uint32_t)){
+
+		uint32_t value = *(uint32_t*)i;
 
+		if(value > old_esp && value < initial_esp)
+			*(uint32_t*)i = value + offset;
+
+	}
+
+	__asm__ volatile("mov %0, %%esp" :: "r"(new_esp));
+	__asm__ volatile("mov %0, %%ebp" :: "r"(new_ebp));
 
 }
 
 /*
- * switch_next_task,
+ * switch_task, siradaki surece gecer. timer kesmesinden (zaman dilimi
+ * doldugunda) ya da surecin kendisinden (uyurken, cikarken) cagrilir.
+ * surecin kaydedicileri thread_save ile kaydedilir, surec tekrar
+ * secildiginde thread_save 1 dondurur ve kaldigi yerden devam eder.
  */
-void switch_next_task(void){
+void switch_task(void){
+
+	process_t *prev = current_process,*next;
+	uint32_t flags;
 
+	/* multitasking baslatilmamis */
+	if(!prev)
+		return;
+
+	flags = irq_save();
+	next = process_next();
+
+	if(next == prev){
+		irq_restore(flags);
+		return;
+	}
+
+	/* bu kesme isleyicisinin suresi burada biter */
+	irq_stat_switch();
+
+	if(thread_save(&prev->thread)){
+		/* tekrar secildik */
+		irq_restore(flags);
+		return;
+	}
+
+	current_process = next;
+	current_dir = next->thread.page_dir;
+	/* kullanici modundan gelen kesmeler surecin kernel stack'ine duser */
+	this_cpu()->tss.esp0 = next->thread.kernel_stack;
+	thread_restore(&next->thread,current_dir->physical_addr);
 
 }
 
 /*
-* multitasking_init,
-*/
-void multitasking_init(void){
+ * multitasking_init, kernel sayfa dizininin bir kopyasina gecip stack'i
+ * tasir ve calisan kodu (kmain) bos surec olarak ayarlar.
+ *
+ * @param stack_ptr : boot stack'in ust adresi
+ */
+void multitasking_init(uint32_t stack_ptr){
 
 	debug_print(KERN_INFO,"Initializing the multitasking...");
+	disable_irq();
+
+	process_init();
+
+	change_page_dir(page_directory_clone(kernel_dir));
+	move_stack(KERNEL_STACK_TOP,KERNEL_STACK_SIZE,stack_ptr);
+
+	idle_process->thread.page_dir = current_dir;
+	idle_process->thread.kernel_stack = KERNEL_STACK_TOP;
+	current_process = idle_process;
+
+	/* bsp'nin stack'i gdt_init'te bilinmiyordu, tss'i simdi kuralim */
+	this_cpu()->stack = KERNEL_STACK_TOP;
+	this_cpu()->tss.esp0 = KERNEL_STACK_TOP;
+
+	enable_irq();
 
 }
 	
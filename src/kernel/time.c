@@ -20,9 +20,12 @@
 #include <uniq/module.h>
 #include <uniq/kernel.h>
 #include <uniq/time.h>
+#include <uniq/clocksource.h>
+#include <uniq/div64.h>
 #include <drivers/cmos.h>
 
 static tm_t kern_start_time;
+static time_t kern_boot_epoch;		/* acilistaki rtc zamani (1970'ten beri) */
 
 uint8_t month_days[] = { /* 0  */ 31, /* 1  */ 28, /* 2  */ 31,
 			 /* 3  */ 30, /* 4  */ 31, /* 5  */ 30,
@@ -30,13 +33,50 @@ uint8_t month_days[] = { /* 0  */ 31, /* 1  */ 28, /* 2  */ 31,
 			 /* 9  */ 31, /* 10 */ 30, /* 11 */ 31 };
 
 /*
- * time_init, kernel baslama zamanini saklamak icin.
+ * time_to_epoch, tm_t yapisindaki zamani 1970 yilindan bu yana
+ * gecen saniyeye cevirir.
+ *
+ * @param time : tm_t yapisi
+ */
+static time_t time_to_epoch(tm_t *time){
+
+	int32_t time_sec,days,years;
+	time_sec = days = 0;
+	
+
+	years = 1900 + time->tm_year - 1;
+	while(years > 1969){
+		
+		days += 365;
+
+		if(is_leap_year(years))
+			days++;
+
+		years--;
+
+	}
+
+	time_sec += days * TIME_DAY;
+	time_sec += time->tm_yday * TIME_DAY;
+	time_sec += time->tm_hour * TIME_HOUR;
+	time_sec += time->tm_min * TIME_MINUTE;
+	time_sec += time->tm_sec;
+
+	return time_sec;
+
+}
+
+/*
+ * time_init, kernel baslama zamanini saklamak icin. saat kaynagi
+ * burada kalibre edilir ve rtc sadece bir kez okunur.
  */
 void time_init(void){
 
 
 	debug_print(KERN_INFO,"Initializing the time.");
 	get_time(&kern_start_time);
+	clocksource_init();
+	kern_boot_epoch = time_to_epoch(&kern_start_time);
 	
 	debug_print(KERN_DUMP,"kernel start time =  %u:%u:%u, %u.%u.%u",kern_start_time.tm_hour,
 								        kern_start_time.tm_min,
@@ -77,37 +117,48 @@ void __dump_time_test(void){
  */
 int32_t gettimeofday(timeval_t *timeval,void *tz){
 
-	tm_t time;
-	get_time(&time);
-	time.tm_mon++;
-	time.tm_yday++;
+	timespec_t ts;
 
-	int32_t time_sec,days,years;
-	time_sec = days = 0;
-	
+	clock_gettime(CLOCK_REALTIME,&ts);
+	timeval->tv_sec = ts.tv_sec;
+	timeval->tv_usec = ts.tv_nsec / NSEC_PER_USEC;
 
-	years = 1900 + time.tm_year - 1;
-	while(years > 1969){
-		
-		days += 365;
+ 	return 0;
 
-		if(is_leap_year(years))
-			days++;
+}
 
-		years--;
+/*
+ * clock_gettime, verilen saate gore zamani nanosaniye cozunurlukle
+ * timespec yapisina doldurur. cmos'a erisilmez, realtime saati
+ * acilista okunan rtc zamani ile monotonik saatin toplamidir.
+ *
+ * @param clk_id : CLOCK_REALTIME ya da CLOCK_MONOTONIC
+ * @param tp : timespec yapisi
+ */
+int32_t clock_gettime(clockid_t clk_id,timespec_t *tp){
+
+	uint64_t ns;
+	uint32_t nsec;
 
+	if(!tp)
+		return -1;
+
+	ns = clocksource_read_ns();
+
+	switch(clk_id){
+		case CLOCK_REALTIME:
+			ns += (uint64_t)kern_boot_epoch * NSEC_PER_SEC;
+			break;
+		case CLOCK_MONOTONIC:
+			break;
+		default:
+			return -1;
 	}
 
-	time_sec += days * TIME_DAY;
-	time_sec += (time.tm_yday - 1) * TIME_DAY;
-	time_sec += time.tm_hour * TIME_HOUR;
-	time_sec += time.tm_min * TIME_MINUTE;
-	time_sec += time.tm_sec;
-	
-	timeval->tv_sec = time_sec;
-	timeval->tv_usec = 0;
+	tp->tv_sec = (time_t)div_u64_rem(ns,NSEC_PER_SEC,&nsec);
+	tp->tv_nsec = nsec;
 
- 	return 0;
+	return 0;
 
 }
 
@@ -0,0 +1,192 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Timer Wheel
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/timer.h>
+
+/*
+ * zamanlayicilar bitis zamanlarinin alt TIMER_WHEEL_BITS bitine gore
+ * yuvalara dagitilir. yuvalar ktimer icindeki dugumu bagladigi icin
+ * ekleme/cikarma sirasinda bellek ayrilmaz, bu sayede irq isleyicisi
+ * icinden de guvenle kullanilabilir.
+ */
+static ilist_t timer_wheel[TIMER_WHEEL_SIZE];
+static uint32_t timer_last_run = 0;		/* islenecek ilk jiffies */
+
+/*
+ * ktimer_wheel_init, zamanlayici carkini hazirlar.
+ */
+void ktimer_wheel_init(void){
+
+	for(uint32_t i = 0; i < TIMER_WHEEL_SIZE; i++)
+		ilist_init(&timer_wheel[i]);
+
+	timer_last_run = timer_ticks;
+
+}
+
+/*
+ * ktimer_setup, zamanlayiciyi kullanima hazirlar.
+ *
+ * @param timer : zamanlayici
+ * @param function : sure doldugunda cagrilacak fonksiyon
+ * @param data : fonksiyona gonderilecek veri
+ */
+void ktimer_setup(ktimer_t *timer,ktimer_func_t function,void *data){
+
+	ilist_node_init(&timer->node);
+	timer->slot = NULL;
+	timer->expires = 0;
+	timer->function = function;
+	timer->data = data;
+
+}
+
+/*
+ * ktimer_pending, zamanlayici carka bagli mi?
+ *
+ * @param timer : zamanlayici
+ */
+bool ktimer_pending(ktimer_t *timer){
+
+	return ilist_linked(&timer->node);
+
+}
+
+/*
+ * ktimer_add, zamanlayiciyi verilen jiffies degerinde calismak
+ * uzere carka ekler. zamanlayici zaten bekliyorsa yeniden kurulur.
+ *
+ * @param timer : zamanlayici
+ * @param expires : bitis zamani (jiffies)
+ */
+void ktimer_add(ktimer_t *timer,uint32_t expires){
+
+	uint32_t flags = irq_save();
+
+	if(ktimer_pending(timer))
+		ilist_del(timer->slot,&timer->node);
+
+	timer->expires = expires;
+	/*
+	 * suresi gecmis bir zaman verildiyse, bir sonraki islenecek
+	 * yuvaya koyalim ki kaybolmasin.
+	 */
+	if(time_before(expires,timer_last_run))
+		expires = timer_last_run;
+
+	timer->slot = &timer_wheel[expires & TIMER_WHEEL_MASK];
+	ilist_add_tail(timer->slot,&timer->node);
+
+	irq_restore(flags);
+
+}
+
+/*
+ * ktimer_del, bekleyen zamanlayiciyi carktan cikarir.
+ *
+ * @param timer : zamanlayici
+ */
+void ktimer_del(ktimer_t *timer){
+
+	uint32_t flags = irq_save();
+
+	if(ktimer_pending(timer))
+		ilist_del(timer->slot,&timer->node);
+
+	irq_restore(flags);
+
+}
+
+/*
+ * ktimer_next_expiry, en yakin zamanlayicinin bitis zamanini
+ * dondurur. bekleyen zamanlayici yoksa timer_ticks + TIMER_NO_EXPIRY
+ * doner. bos donguden kesmeler kapaliyken cagrilmalidir.
+ */
+uint32_t ktimer_next_expiry(void){
+
+	uint32_t now = timer_ticks;
+	uint32_t next = now + TIMER_NO_EXPIRY;
+
+	/*
+	 * carki su andan itibaren bir tur tarariz. bir yuvada tam o
+	 * tura denk gelen zamanlayici varsa daha yakini olamaz, digerleri
+	 * (sonraki turlara ait olanlar) icin en kucugu akilda tutulur.
+	 */
+	for(uint32_t i = 0; i < TIMER_WHEEL_SIZE; i++){
+		uint32_t slot_time = now + i;
+		ktimer_t *timer;
+
+		ilist_for_each_entry(timer,&timer_wheel[slot_time & TIMER_WHEEL_MASK],node){
+			if(time_before_eq(timer->expires,slot_time))
+				return time_before(timer->expires,now) ? now : timer->expires;
+
+			if(time_before(timer->expires,next))
+				next = timer->expires;
+		}
+	}
+
+	return next;
+
+}
+
+/*
+ * ktimer_run, suresi dolan zamanlayicilari calistirir. jiffies bir
+ * seferde birden fazla ilerlemis olabilir (tick'siz bos dongu), bu
+ * yuzden son islenen jiffies'ten itibaren aradaki tum yuvalar islenir.
+ * irq baglaminda, kesmeler kapaliyken cagrilir.
+ */
+void ktimer_run(void){
+
+	while(time_before_eq(timer_last_run,timer_ticks)){
+		/*
+		 * timer_last_run fonksiyonlar cagrilmadan ilerletilir. boylece
+		 * fonksiyon icinden suresi gecmis bir zamanla yeniden kurulan
+		 * zamanlayici ktimer_add'de bir sonraki yuvaya duser, taranan
+		 * yuvaya geri eklenip sonsuz donguye yol acmaz.
+		 */
+		uint32_t now = timer_last_run++;
+		ilist_t *slot = &timer_wheel[now & TIMER_WHEEL_MASK];
+		ilist_node_t *node = slot->head.next;
+
+		while(node != &slot->head){
+			ilist_node_t *next = node->next;
+			ktimer_t *timer = ilist_entry(node,ktimer_t,node);
+
+			if(time_after_eq(now,timer->expires)){
+				ilist_del(slot,node);
+				timer->function(timer->data);
+				/*
+				 * fonksiyon baska zamanlayicilari silmis ya da
+				 * eklemis olabilir, yuvayi bastan tara.
+				 */
+				next = slot->head.next;
+			}
+
+			node = next;
+		}
+	}
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
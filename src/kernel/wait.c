@@ -0,0 +1,116 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Wait Queue
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <uniq/wait.h>
+
+/*
+ * wait_queue_init, bekleme kuyrugunu hazirlar.
+ *
+ * @param wait : bekleme kuyrugu
+ */
+void wait_queue_init(wait_queue_t *wait){
+
+	spin_lock_init(&wait->lock);
+	ilist_init(&wait->waiters);
+
+}
+
+/*
+ * sleep_on, calisan sureci kuyrukta uyandirilana kadar uyutur. bos
+ * surec uyuyamadigi icin bir kesme ile de donebilir, bu yuzden
+ * cagiran kosulunu bir dongu icinde kontrol etmelidir:
+ *
+ *	flags = irq_save();
+ *	while(!kosul)
+ *		sleep_on(&wait);
+ *	irq_restore(flags);
+ *
+ * @param wait : bekleme kuyrugu
+ */
+void sleep_on(wait_queue_t *wait){
+
+	wait_entry_t entry;
+	uint32_t flags = irq_save();
+
+	entry.process = current_process;
+	entry.woken = false;
+
+	spin_lock(&wait->lock);
+	ilist_add_tail(&wait->waiters,&entry.node);
+
+	while(!entry.woken){
+
+		/* kilit altinda isaretlenir, wake_up arada gelirse kaybolmaz */
+		process_prepare_sleep();
+		spin_unlock(&wait->lock);
+		process_sleep();
+		spin_lock(&wait->lock);
+
+		/* bos surec uyandirilmadan donmus olabilir */
+		if(current_process == idle_process)
+			break;
+
+	}
+
+	if(!entry.woken)
+		ilist_del(&wait->waiters,&entry.node);
+	spin_unlock(&wait->lock);
+
+	irq_restore(flags);
+
+}
+
+/*
+ * wake_up, kuyruktaki ilk count kadar sureci uyandirir ve uyandirilan
+ * surec sayisini dondurur.
+ *
+ * @param wait : bekleme kuyrugu
+ * @param count : en fazla uyandirilacak surec sayisi
+ */
+uint32_t wake_up(wait_queue_t *wait,uint32_t count){
+
+	uint32_t flags = irq_save();
+	uint32_t woken = 0;
+	ilist_node_t *node;
+
+	spin_lock(&wait->lock);
+
+	while(woken < count && (node = ilist_pop_first(&wait->waiters))){
+
+		wait_entry_t *entry = ilist_entry(node,wait_entry_t,node);
+
+		entry->woken = true;
+		process_wakeup(entry->process);
+		woken++;
+
+	}
+
+	spin_unlock(&wait->lock);
+	irq_restore(flags);
+
+	return woken;
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,334 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Concurrent Hashmap
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <chashmap.h>
+#include <hash.h>
+#include <string.h>
+
+/*
+ * chashmap_hash, anahtarin hash degerini dondurur.
+ *
+ * @param map : hashmap
+ * @param hash_key : hash anahtari
+ */
+static inline uint32_t chashmap_hash(chashmap_t *map,void *hash_key){
+
+	if(map->type == CHASHMAP_INT)
+		return hash_fmix32((uint32_t)hash_key);
+
+	return hash_str((const char*)hash_key);
+
+}
+
+/*
+ * chashmap_match, elemanin anahtari aranan anahtar mi?
+ *
+ * @param map : hashmap
+ * @param entry : eleman
+ * @param hash : aranan anahtarin hash degeri
+ * @param hash_key : aranan anahtar
+ */
+static inline bool chashmap_match(chashmap_t *map,chashmap_entry_t *entry,
+				  uint32_t hash,void *hash_key){
+
+	if(entry->hash != hash)
+		return false;
+
+	if(map->type == CHASHMAP_INT)
+		return entry->hash_key == hash_key;
+
+	return !strcmp(entry->hash_key,hash_key);
+
+}
+
+static inline spinlock_t *chashmap_lock(chashmap_t *map,uint32_t hash){
+
+	return &map->locks[hash & (CHASHMAP_STRIPES - 1)];
+
+}
+
+/*
+ * chashmap_entry_free, epoch dolduktan sonra elemani bosa cikarir.
+ *
+ * @param head : elemanin erteleme dugumu
+ */
+static void chashmap_entry_free(epoch_head_t *head){
+
+	free(container_of(head,chashmap_entry_t,epoch));
+
+}
+
+/*
+ * chashmap_str_entry_free, ayni, anahtar kopyasi da bosa cikarilir.
+ *
+ * @param head : elemanin erteleme dugumu
+ */
+static void chashmap_str_entry_free(epoch_head_t *head){
+
+	chashmap_entry_t *entry = container_of(head,chashmap_entry_t,epoch);
+
+	free(entry->hash_key);
+	free(entry);
+
+}
+
+/*
+ * chashmap_create, verilen tipte eszamanli hashmap olusturur. kova
+ * sayisi 2'nin kuvvetine yuvarlanir ve sonradan degismez.
+ *
+ * @param size : kova sayisi
+ * @param type : anahtar tipi
+ */
+static chashmap_t *chashmap_create(uint32_t size,chashmap_type_t type){
+
+	uint32_t buckets = CHASHMAP_STRIPES;
+	chashmap_t *map;
+
+	if(!size)
+		return NULL;
+
+	while(buckets < size)
+		buckets <<= 1;
+
+	map = malloc(sizeof(chashmap_t));
+	if(!map)
+		return NULL;
+
+	map->buckets = malloc(sizeof(chashmap_entry_t*) * buckets);
+	if(!map->buckets){
+		free(map);
+		return NULL;
+	}
+
+	memset((void*)map->buckets,0,sizeof(chashmap_entry_t*) * buckets);
+	for(uint32_t i = 0; i < CHASHMAP_STRIPES; i++)
+		spin_lock_init(&map->locks[i]);
+
+	map->signature = CHASHMAP_SIGNATURE;
+	map->type = type;
+	map->mask = buckets - 1;
+	map->count = 0;
+
+	return map;
+
+}
+
+/*
+ * chashmap_int_create, integer anahtarli eszamanli hashmap olusturur.
+ *
+ * @param size : kova sayisi
+ */
+chashmap_t *chashmap_int_create(uint32_t size){
+
+	return chashmap_create(size,CHASHMAP_INT);
+
+}
+
+/*
+ * chashmap_str_create, string anahtarli eszamanli hashmap olusturur.
+ *
+ * @param size : kova sayisi
+ */
+chashmap_t *chashmap_str_create(uint32_t size){
+
+	return chashmap_create(size,CHASHMAP_STR);
+
+}
+
+/*
+ * chashmap_destroy, hashmap'i anahtarlariyla birlikte siler. itemler
+ * bosa cikarilmaz. hashmap'i kullanan okuyucu kalmamis olmalidir.
+ *
+ * @param map : hashmap
+ */
+void chashmap_destroy(chashmap_t *map){
+
+	if(!map)
+		return;
+
+	assert(map->signature == CHASHMAP_SIGNATURE && "Wrong! chashmap signature");
+
+	for(uint32_t i = 0; i <= map->mask; i++){
+
+		chashmap_entry_t *entry = map->buckets[i],*next;
+
+		for(; entry; entry = next){
+			next = entry->next;
+			if(map->type == CHASHMAP_STR)
+				free(entry->hash_key);
+			free(entry);
+		}
+
+	}
+
+	free((void*)map->buckets);
+	free(map);
+
+}
+
+/*
+ * chashmap_get, anahtara ait itemi dondurur, bulunamazsa NULL doner.
+ * kilit almaz, bu yuzden diger cpu'lardaki okuyucularla ve yazarlarla
+ * ayni anda calisabilir. item'in omru cagirana aittir, item'ler de
+ * epoch ile bosa cikariliyorsa cagiran epoch_enter icinde kalmalidir.
+ *
+ * @param map : hashmap
+ * @param hash_key : hash anahtari
+ */
+void *chashmap_get(chashmap_t *map,void *hash_key){
+
+	chashmap_entry_t *entry;
+	uint32_t hash;
+	void *item = NULL;
+
+	if(!map || !hash_key)
+		return NULL;
+
+	hash = chashmap_hash(map,hash_key);
+
+	epoch_enter();
+
+	for(entry = map->buckets[hash & map->mask]; entry; entry = entry->next){
+		if(chashmap_match(map,entry,hash,hash_key)){
+			item = entry->item;
+			break;
+		}
+	}
+
+	epoch_exit();
+
+	return item;
+
+}
+
+/*
+ * chashmap_set, anahtara item'i baglar. anahtar varsa item'i
+ * degistirilir ve eski item doner. yeni eleman tum alanlari
+ * yazildiktan sonra kovanin basina yayinlanir, okuyucular yarim
+ * kurulmus eleman goremez.
+ *
+ * @param map : hashmap
+ * @param item : item
+ * @param hash_key : hash anahtari
+ */
+void *chashmap_set(chashmap_t *map,void *item,void *hash_key){
+
+	chashmap_entry_t *volatile *bucket;
+	chashmap_entry_t *entry;
+	spinlock_t *lock;
+	uint32_t hash,flags;
+
+	if(!map || !hash_key)
+		return NULL;
+
+	assert(map->signature == CHASHMAP_SIGNATURE && "Wrong! chashmap signature");
+
+	hash = chashmap_hash(map,hash_key);
+	bucket = &map->buckets[hash & map->mask];
+	lock = chashmap_lock(map,hash);
+
+	flags = spin_lock_irqsave(lock);
+
+	for(entry = *bucket; entry; entry = entry->next){
+		if(chashmap_match(map,entry,hash,hash_key)){
+			void *break_item = entry->item;
+			entry->item = item;
+			spin_unlock_irqrestore(lock,flags);
+			return break_item;
+		}
+	}
+
+	entry = malloc(sizeof(chashmap_entry_t));
+	if(entry && map->type == CHASHMAP_STR){
+		if(!(hash_key = strdup(hash_key))){
+			free(entry);
+			entry = NULL;
+		}
+	}
+
+	if(entry){
+		entry->hash = hash;
+		entry->hash_key = hash_key;
+		entry->item = item;
+		entry->next = *bucket;
+		/* x86'da store'lar sirayla gorunur */
+		barrier();
+		*bucket = entry;
+		__sync_fetch_and_add(&map->count,1);
+	}
+
+	spin_unlock_irqrestore(lock,flags);
+
+	return NULL;
+
+}
+
+/*
+ * chashmap_remove, anahtari hashmap'ten cikarir ve item'ini dondurur.
+ * eleman zincirden ayrilir fakat halen onu dolasan okuyucular olabilir,
+ * next isaretcisi korunur ve eleman epoch dolunca bosa cikarilir.
+ *
+ * @param map : hashmap
+ * @param hash_key : hash anahtari
+ */
+void *chashmap_remove(chashmap_t *map,void *hash_key){
+
+	chashmap_entry_t *volatile *link;
+	chashmap_entry_t *entry;
+	spinlock_t *lock;
+	uint32_t hash,flags;
+	void *item = NULL;
+
+	if(!map || !hash_key)
+		return NULL;
+
+	assert(map->signature == CHASHMAP_SIGNATURE && "Wrong! chashmap signature");
+
+	hash = chashmap_hash(map,hash_key);
+	link = &map->buckets[hash & map->mask];
+	lock = chashmap_lock(map,hash);
+
+	flags = spin_lock_irqsave(lock);
+
+	for(; (entry = *link); link = &entry->next){
+
+		if(!chashmap_match(map,entry,hash,hash_key))
+			continue;
+
+		*link = entry->next;
+		item = entry->item;
+		__sync_fetch_and_sub(&map->count,1);
+		epoch_defer(&entry->epoch,map->type == CHASHMAP_STR ? chashmap_str_entry_free :
+								       chashmap_entry_free);
+		break;
+
+	}
+
+	spin_unlock_irqrestore(lock,flags);
+
+	return item;
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
@@ -0,0 +1,173 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Hash Functions
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <hash.h>
+#include <uniq/word.h>
+
+#define XXH_PRIME1		0x9E3779B1
+#define XXH_PRIME2		0x85EBCA77
+#define XXH_PRIME3		0xC2B2AE3D
+#define XXH_PRIME4		0x27D4EB2F
+#define XXH_PRIME5		0x165667B1
+
+#define HASH_PAGE_MASK		0xFFF			/* 4 KiB sayfa */
+
+/*
+ * hash_fnv1a, FNV-1a, bayt bayt calisan basit ve kisa anahtarlarda
+ * iyi dagilim veren hash.
+ *
+ * @param data : veri
+ * @param len : veri uzunlugu
+ */
+uint32_t hash_fnv1a(const void *data,size_t len){
+
+	const uint8_t *p = data;
+	uint32_t hash = FNV1A_OFFSET;
+
+	while(len--){
+		hash ^= *p++;
+		hash *= FNV1A_PRIME;
+	}
+
+	return hash;
+
+}
+
+static inline uint32_t xxh32_round(uint32_t acc,uint32_t input){
+
+	acc += input * XXH_PRIME2;
+	acc = hash_rotl32(acc,13);
+
+	return acc * XXH_PRIME1;
+
+}
+
+/*
+ * hash_xxh32, xxHash32. 16 baytlik bloklar birbirinden bagimsiz dort
+ * akumulatore dagitilir, islemci bunlari paralel isleyebilir. uzun
+ * tamponlarda (dosya bloklari, yollar) bayt bayt hash'lerden cok
+ * daha hizlidir.
+ *
+ * @param data : veri
+ * @param len : veri uzunlugu
+ * @param seed : tohum
+ */
+uint32_t hash_xxh32(const void *data,size_t len,uint32_t seed){
+
+	const uint8_t *p = data;
+	const uint8_t *end = p + len;
+	uint32_t hash;
+
+	if(len >= 16){
+
+		const uint8_t *limit = end - 16;
+		uint32_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+		uint32_t v2 = seed + XXH_PRIME2;
+		uint32_t v3 = seed;
+		uint32_t v4 = seed - XXH_PRIME1;
+
+		do{
+			v1 = xxh32_round(v1,read_unaligned32(p));
+			v2 = xxh32_round(v2,read_unaligned32(p + 4));
+			v3 = xxh32_round(v3,read_unaligned32(p + 8));
+			v4 = xxh32_round(v4,read_unaligned32(p + 12));
+			p += 16;
+		}while(p <= limit);
+
+		hash = hash_rotl32(v1,1) + hash_rotl32(v2,7) +
+		       hash_rotl32(v3,12) + hash_rotl32(v4,18);
+
+	}else
+		hash = seed + XXH_PRIME5;
+
+	hash += (uint32_t)len;
+
+	for(; p + 4 <= end; p += 4){
+		hash += read_unaligned32(p) * XXH_PRIME3;
+		hash = hash_rotl32(hash,17) * XXH_PRIME4;
+	}
+
+	for(; p < end; p++){
+		hash += *p * XXH_PRIME5;
+		hash = hash_rotl32(hash,11) * XXH_PRIME1;
+	}
+
+	hash ^= hash >> 15;
+	hash *= XXH_PRIME2;
+	hash ^= hash >> 13;
+	hash *= XXH_PRIME3;
+	hash ^= hash >> 16;
+
+	return hash;
+
+}
+
+/*
+ * hash_str, sifirla biten karakter dizisini tek geciste kelime kelime
+ * hash'ler, once strlen ile uzunluk bulunmaz. kelime dizinin sonunu
+ * asabilir, fakat sayfa sinirini asmadigi surece okumak guvenlidir ve
+ * sifir bayttan sonraki baytlar hash'e katilmaz. sonuc dizinin bellekteki
+ * hizasindan bagimsizdir.
+ *
+ * @param s : karakter dizisi
+ */
+uint32_t hash_str(const char *s){
+
+	const uint8_t *p = (const uint8_t*)s;
+	uint32_t hash = HASH_SEED,len = 0,word;
+
+	for(;; p += 4,len += 4){
+
+		if(((uint32_t)p & HASH_PAGE_MASK) > HASH_PAGE_MASK - 3){
+
+			/* kelime sonraki sayfaya tasiyor, sifira kadar bayt bayt */
+			uint32_t i;
+
+			word = 0;
+			for(i = 0; i < 4 && p[i]; i++)
+				word |= (uint32_t)p[i] << (i * 8);
+			if(i < 4)
+				break;
+
+		}else{
+
+			word = read_unaligned32(p);
+			if(word_haszero(word))
+				break;
+
+		}
+
+		hash = hash_rotl32(hash ^ word,13) * XXH_PRIME1;
+
+	}
+
+	/* son kelimede sifir bayttan onceki baytlar tek tek eklenir */
+	for(uint32_t i = 0; i < 4 && p[i]; i++,len++)
+		hash = hash_rotl32(hash ^ p[i],5) * XXH_PRIME1;
+
+	return hash_fmix32(hash ^ len);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
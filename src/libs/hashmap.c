@@ -19,129 +19,355 @@
 
 #include <uniq/module.h>
 #include <hashmap.h>
+#include <hash.h>
 #include <string.h>
 #include <uniq/kernel.h>
 #include <list.h>
 
+#define HASHMAP_TEST_KEYS	200
+
 /*
  * hashmap_str_hashcode, karakter dizisi icin hash kodu
- * uretir.
+ * uretir. (kelime kelime, bkz. hash_str)
  *
  * @param hash_key : hash anahtari
  */
 static uint32_t hashmap_str_hashcode(void *hash_key){
 
-	uint32_t hash_code = 0;
-	char *key = (char*)hash_key;
-	uint8_t c;
-
-	while(c = *key++)
-		hash_code = c + (hash_code << 6) + (hash_code << 16) - hash_code;
-
-	return hash_code;
+	return hash_str((const char*)hash_key);
 
 }
 
 /*
  * hashmap_int_hashcode, integer hashmap icin hash kodu belirlenir.
- * (hash kodu olarak adresin geri donduruldugune dikkat edin!)
+ * anahtar oldugu gibi kullanilirsa ardisik ya da ayni adimla artan
+ * anahtarlar (pid, inode, hizali adresler) tablonun ayni bolgesinde
+ * kumelenir, bu yuzden bitleri karistirilir.
  *
  * @param hash_key : hash anahtari
  */
 static uint32_t hashmap_int_hashcode(void *hash_key){
 
-	return (uint32_t)hash_key;
+	return hash_fmix32((uint32_t)hash_key);
+
+}
+
+/*
+ * hashmap_strdup, verilen karakter dizisini klonlar.(hashmap icin
+ * hash key'in klonlanmasinda kullanilir.)
+ *
+ * @param s : karakter dizisi
+ */
+static void *hashmap_strdup(void *s){
+
+	return strdup(s);
+
+}
+
+/*
+ * hashmap_intdup ve hashmap_int_free, integer hashmap'te anahtar
+ * adresin kendisi oldugu icin kopyalanmaz ve bosa cikarilmaz.
+ */
+static void *hashmap_intdup(void *integer){
+
+	return integer;
+
+}
+
+static void hashmap_int_free(void *integer){
+
+	return;
 
 }
 
 /*
- * hashmap_strcmp, hashmap icin 2 karakter dizisini karsilastirir.
- * (hashmap icin hash key karsilastirilmasinda kullanilir.)
+ * hashmap_hash, anahtarin hash degerini dondurur. 0 bos yuvayi
+ * ifade ettigi icin hic uretilmez.
  *
- * @param x : ilk karakter dizisi
- * @param y : diger karakter dizisi
+ * @param hashmap : hashmap yapisi
+ * @param hash_key : hash anahtari
  */
-static int32_t hashmap_strcmp(void *x,void *y){
+static inline uint32_t hashmap_hash(hashmap_t *hashmap,void *hash_key){
+
+	uint32_t hash = hashmap->hash_code(hash_key);
+
+	return hash ? hash : 1;
+
+}
+
+/*
+ * hashmap_key_equal, iki anahtari karsilastirir. hashmap tipine gore
+ * dogrudan karsilastirilir, fonksiyon isaretcisi uzerinden gidilmez.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param x : yuvadaki anahtar
+ * @param y : aranan anahtar
+ */
+static inline bool hashmap_key_equal(hashmap_t *hashmap,void *x,void *y){
+
+	if(hashmap->type == HASHMAP_INT)
+		return x == y;
 
 	return !strcmp(x,y);
 
 }
 
 /*
- * hashmap_intcmp, verilen 2 adresi karsilastirir.
- * (hashmap icin hash key karsilastirilmasinda kullanilir.)
+ * hashmap_probe_dist, yuvadaki elemanin kendi ideal yuvasina olan
+ * uzakligi.
  *
- * @param x : ilk adres
- * @param y : diger adres
+ * @param table : tablo
+ * @param hash : elemanin hash degeri
+ * @param index : elemanin bulundugu yuva
  */
-static int32_t hashmap_intcmp(void *x,void *y){
+static inline uint32_t hashmap_probe_dist(hashmap_table_t *table,uint32_t hash,uint32_t index){
 
-	return (int32_t)x == (int32_t)y;
+	return (index - (hash & table->mask)) & table->mask;
 
 }
 
 /*
- * hashmap_strdup, verilen karakter dizisini klonlar.(hashmap icin
- * hash key'in klonlanmasinda kullanilir.)
+ * hashmap_table_alloc, verilen boyutta bos tablo olusturur.
  *
- * @param s : karakter dizisi
+ * @param table : tablo
+ * @param size : yuva sayisi (2'nin kuvveti)
  */
-static void *hashmap_strdup(void *s){
+static bool hashmap_table_alloc(hashmap_table_t *table,uint32_t size){
 
-	return strdup(s);
+	table->slots = malloc(sizeof(hashmap_slot_t) * size);
+	if(!table->slots)
+		return false;
+
+	memset(table->slots,0,sizeof(hashmap_slot_t) * size);
+	table->mask = size - 1;
+
+	return true;
 
 }
 
 /*
- * hashmap_intdup ve hashmap_int_free fonksiyonlarinin kullanilmasi
- * gereksiz gibi durabilir. fakat hashmap yapisi incelediginizde
- * yapida fonksiyon isaretcilerinin oldugunu goreceksiniz. bu
- * fonksiyonlar string ve integer hashmaplerin ortak fonksiyonlar
- * tarafindan islenmesinde ayri ayri fonksiyonlarin yazilmamasi
- * konusunda icin gereklidir. bunu hashmap fonksiyonlarinin tamamini
- * incelediginizde goreceksiniz.
+ * hashmap_table_find, tabloda anahtari arar, bulunamazsa NULL doner.
+ * robin hood duzeninde aranan anahtar, ideal yuvasina bizden daha
+ * yakin bir elemana rastlandigi anda tabloda olamaz.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param table : tablo
+ * @param hash : anahtarin hash degeri
+ * @param hash_key : hash anahtari
  */
-static void *hashmap_intdup(void *integer){
+static hashmap_slot_t *hashmap_table_find(hashmap_t *hashmap,hashmap_table_t *table,
+					   uint32_t hash,void *hash_key){
 
-	return integer;
+	uint32_t index = hash & table->mask;
+
+	for(uint32_t dist = 0;; dist++){
+
+		hashmap_slot_t *slot = &table->slots[index];
+
+		if(!slot->hash || dist > hashmap_probe_dist(table,slot->hash,index))
+			return NULL;
+
+		if(slot->hash == hash && slot->hash_key &&
+		   hashmap_key_equal(hashmap,slot->hash_key,hash_key))
+			return slot;
+
+		index = (index + 1) & table->mask;
+
+	}
 
 }
 
-static void hashmap_int_free(void *integer){
+/*
+ * hashmap_table_insert, tabloda olmayan bir anahtari ekler. yoklama
+ * sirasinda ideal yuvasina bizden daha yakin olan elemanin yerini
+ * alir ve onu ilerletir (robin hood), boylece yoklama mesafeleri
+ * birbirine yakin kalir. tabloda en az bir bos yuva olmalidir.
+ *
+ * @param table : tablo
+ * @param entry : eklenecek yuva icerigi
+ */
+static void hashmap_table_insert(hashmap_table_t *table,hashmap_slot_t entry){
 
-	return;
+	uint32_t index = entry.hash & table->mask;
+
+	for(uint32_t dist = 0;; dist++){
+
+		hashmap_slot_t *slot = &table->slots[index];
+		uint32_t slot_dist;
+
+		if(!slot->hash){
+			*slot = entry;
+			return;
+		}
+
+		slot_dist = hashmap_probe_dist(table,slot->hash,index);
+		if(slot_dist < dist){
+			hashmap_slot_t tmp = *slot;
+			*slot = entry;
+			entry = tmp;
+			dist = slot_dist;
+		}
+
+		index = (index + 1) & table->mask;
+
+	}
+
+}
+
+/*
+ * hashmap_table_delete, yuvayi bosaltir ve arkasindaki elemanlari
+ * birer geri kaydirir (backward shift), mezar tasi birakilmaz.
+ *
+ * @param table : tablo
+ * @param slot : silinecek yuva
+ */
+static void hashmap_table_delete(hashmap_table_t *table,hashmap_slot_t *slot){
+
+	uint32_t index = slot - table->slots;
+
+	for(;;){
+
+		uint32_t next = (index + 1) & table->mask;
+		hashmap_slot_t *next_slot = &table->slots[next];
+
+		if(!next_slot->hash || !hashmap_probe_dist(table,next_slot->hash,next))
+			break;
+
+		table->slots[index] = *next_slot;
+		index = next;
+
+	}
+
+	table->slots[index].hash = 0;
 
 }
 
 /*
- * hashmap_destroy, hashmap yapisini tum icerigiyle
- * birlikte siler.
+ * hashmap_rehash_step, eski tablodan en fazla count yuvayi yeni
+ * tabloya tasir. buyutme bu sekilde yazmalara yayilir, tek bir
+ * ekleme tum tabloyu kopyalamak zorunda kalmaz.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param count : tasinacak yuva sayisi
+ */
+static void hashmap_rehash_step(hashmap_t *hashmap,uint32_t count){
+
+	hashmap_table_t *old = &hashmap->old;
+
+	if(!old->slots)
+		return;
+
+	for(; count && hashmap->rehash_index <= old->mask; count--){
+
+		hashmap_slot_t *slot = &old->slots[hashmap->rehash_index++];
+
+		if(slot->hash && slot->hash_key){
+			hashmap_table_insert(&hashmap->table,*slot);
+			/*
+			 * eski kopya silinmis olarak isaretlenir, aksi halde
+			 * yeni tablodan silinen anahtar eski tabloda bulunur
+			 * ve destroy anahtari iki kere bosa cikarir.
+			 */
+			slot->hash_key = NULL;
+		}
+
+	}
+
+	if(hashmap->rehash_index > old->mask){
+		free(old->slots);
+		old->slots = NULL;
+	}
+
+}
+
+/*
+ * hashmap_grow, doluluk orani asildiysa tabloyu iki katina buyutur.
+ * eski tablo hashmap_rehash_step ile yavas yavas tasinir. bellek
+ * yetmezse tablo oldugu gibi kalir.
+ *
+ * @param hashmap : hashmap yapisi
+ */
+static void hashmap_grow(hashmap_t *hashmap){
+
+	uint32_t size = hashmap->table.mask + 1;
+	hashmap_table_t table;
+
+	if((hashmap->count + 1) * 100 <= size * HASHMAP_MAX_LOAD)
+		return;
+
+	/* onceki buyutme bitmeden yenisine baslanmaz */
+	hashmap_rehash_step(hashmap,hashmap->old.mask + 1);
+
+	if(!hashmap_table_alloc(&table,size << 1))
+		return;
+
+	hashmap->old = hashmap->table;
+	hashmap->table = table;
+	hashmap->rehash_index = 0;
+
+}
+
+/*
+ * hashmap_find, anahtari once yeni, buyutme suruyorsa eski tabloda
+ * arar.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param hash : anahtarin hash degeri
+ * @param hash_key : hash anahtari
+ * @param table : anahtarin bulundugu tablo
+ */
+static hashmap_slot_t *hashmap_find(hashmap_t *hashmap,uint32_t hash,void *hash_key,
+				    hashmap_table_t **table){
+
+	hashmap_slot_t *slot = hashmap_table_find(hashmap,&hashmap->table,hash,hash_key);
+
+	*table = &hashmap->table;
+	if(slot || !hashmap->old.slots)
+		return slot;
+
+	*table = &hashmap->old;
+
+	return hashmap_table_find(hashmap,&hashmap->old,hash,hash_key);
+
+}
+
+/*
+ * hashmap_destroy, hashmap yapisini anahtarlariyla birlikte
+ * siler. itemler bosa cikarilmaz.
  *
  * @param hashmap : hashmap yapisi
  */
 void hashmap_destroy(hashmap_t *hashmap){
 
+	hashmap_table_t *tables[2];
+
 	if(!hashmap)
 		return;
 	
 	assert(hashmap->signature == HASHMAP_SIGNATURE && "Wrong! hashmap signature");
 
-	for(uint32_t i = 0;i < hashmap->size;i++){
+	tables[0] = &hashmap->table;
+	tables[1] = &hashmap->old;
+
+	for(uint32_t t = 0;t < 2;t++){
 
-		hashmap_entry_t *entry = hashmap->entries[i],*last;
+		if(!tables[t]->slots)
+			continue;
 
-		for(;entry;entry = entry->next){
+		for(uint32_t i = 0;i <= tables[t]->mask;i++){
 
-			last = entry;
-			hashmap->hash_key_free(last->hash_key);
-			hashmap->hash_item_free(last);
-			
+			hashmap_slot_t *slot = &tables[t]->slots[i];
+
+			if(slot->hash && slot->hash_key)
+				hashmap->hash_key_free(slot->hash_key);
 
 		}
 
+		free(tables[t]->slots);
+
 	}
 	
-	free(hashmap->entries);
+	free(hashmap);
 
 }
 
@@ -154,6 +380,8 @@ void hashmap_destroy(hashmap_t *hashmap){
  */
 int32_t hashmap_check(hashmap_t *hashmap,void *hash_key){
 
+	hashmap_table_t *table;
+
 	if(!hashmap)
 		return -1;
 	
@@ -162,23 +390,42 @@ int32_t hashmap_check(hashmap_t *hashmap,void *hash_key){
 	if(!hash_key)
 		return -1;
 
-	uint32_t index = hashmap->hash_code(hash_key) % hashmap->size;
-	hashmap_entry_t *entry = hashmap->entries[index];
+	if(hashmap_find(hashmap,hashmap_hash(hashmap,hash_key),hash_key,&table))
+		return 1;
 
-	if(entry){
+	return -1;	
 
-		do{
-			
-			if(hashmap->hash_cmp(entry->hash_key,hash_key))
-				return 1;
+}
 
-			entry = entry->next;
-	
-		}while(entry);
+/*
+ * hashmap_collect, hashmap yapisindaki itemleri ya da anahtarlari
+ * yeni bir listeye doldurur.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param keys : anahtarlar mi toplansin?
+ */
+static list_t *hashmap_collect(hashmap_t *hashmap,bool keys){
+
+	hashmap_table_t *tables[2] = { &hashmap->table, &hashmap->old };
+	list_t *list = list_create();
+
+	for(uint32_t t = 0;t < 2;t++){
+
+		if(!tables[t]->slots)
+			continue;
+
+		for(uint32_t i = 0;i <= tables[t]->mask;i++){
+
+			hashmap_slot_t *slot = &tables[t]->slots[i];
+
+			if(slot->hash && slot->hash_key)
+				list_push(list,keys ? slot->hash_key : slot->item);
+
+		}
 
 	}
 
-	return -1;	
+	return list;
 
 }
 
@@ -196,18 +443,7 @@ list_t *hashmap_get_values(hashmap_t *hashmap){
 	
 	assert(hashmap->signature == HASHMAP_SIGNATURE && "Wrong! hashmap signature");
 
-	list_t *list = list_create();
-
-	for(uint32_t i = 0;i < hashmap->size;i++){
-
-		hashmap_entry_t *entry = hashmap->entries[i];
-
-		for(;entry;entry = entry->next)
-			list_push(list,entry->item);
-
-	}
-
-	return list;	
+	return hashmap_collect(hashmap,false);
 
 }
 
@@ -225,18 +461,7 @@ list_t *hashmap_get_keys(hashmap_t *hashmap){
 	
 	assert(hashmap->signature == HASHMAP_SIGNATURE && "Wrong! hashmap signature");
 
-	list_t *list = list_create();
-
-	for(uint32_t i = 0;i < hashmap->size;i++){
-
-		hashmap_entry_t *entry = hashmap->entries[i];
-
-		for(;entry;entry = entry->next)
-			list_push(list,entry->hash_key);
-
-	}
-
-	return list;	
+	return hashmap_collect(hashmap,true);
 
 }
 
@@ -250,6 +475,9 @@ list_t *hashmap_get_keys(hashmap_t *hashmap){
  */
 void *hashmap_get(hashmap_t *hashmap,void *hash_key){
 
+	hashmap_table_t *table;
+	hashmap_slot_t *slot;
+
 	if(!hashmap)
 		return NULL;
 	
@@ -258,30 +486,18 @@ void *hashmap_get(hashmap_t *hashmap,void *hash_key){
 	if(!hash_key)
 		return NULL;
 
-	uint32_t index = hashmap->hash_code(hash_key) % hashmap->size;
-	hashmap_entry_t *entry = hashmap->entries[index];
-
-	if(entry)
+	slot = hashmap_find(hashmap,hashmap_hash(hashmap,hash_key),hash_key,&table);
 
-		do{
-
-			if(hashmap->hash_cmp(entry->hash_key,hash_key))
-				return entry->item;
-			
-			entry = entry->next;
-
-		}while(entry);
-
-	}
-
-	return NULL;
+	return slot ? slot->item : NULL;
 
 }
 
 /*
  * hashmap_set, hashmap yapisina hash anahtarina gore yeni
  * icerik eklenir yada belirtilen hash anahtari onceden
- * listede varsa icerigi guncellenir.
+ * listede varsa icerigi guncellenir ve eski icerik doner.
+ * tablo buyutulemeyecek kadar doluysa ve bellek yoksa ekleme
+ * yapilmaz.
  *
  * @param hashmap : hashmap yapisi
  * @param item : icerik
@@ -289,6 +505,10 @@ void *hashmap_get(hashmap_t *hashmap,void *hash_key){
  */
 void *hashmap_set(hashmap_t *hashmap,void *item,void *hash_key){
 
+	hashmap_table_t *table;
+	hashmap_slot_t *slot,entry;
+	uint32_t hash;
+
 	if(!hashmap)
 		return NULL;
 	
@@ -297,71 +517,88 @@ void *hashmap_set(hashmap_t *hashmap,void *item,void *hash_key){
 	if(!hash_key)
 		return NULL;
 
-	uint32_t index = hashmap->hash_code(hash_key) % hashmap->size;
-	hashmap_entry_t *entry = hashmap->entries[index];
+	hash = hashmap_hash(hashmap,hash_key);
+	hashmap_rehash_step(hashmap,HASHMAP_REHASH_STEP);
+
+	/* anahtar hangi tablodaysa orada guncellenir */
+	slot = hashmap_find(hashmap,hash,hash_key,&table);
+	if(slot){
 
-	if(!entry){
+		void *break_item = slot->item;
+		slot->item = item;
 
-		hashmap_entry_t *new_entry = malloc(sizeof(hashmap_entry_t));
-		new_entry->next = NULL;
-		new_entry->item = item;
-		new_entry->hash_key = hashmap->hash_dup(hash_key);
-		hashmap->entries[index] = new_entry;
+		return break_item;
 
 	}
-	else{
 
-		hashmap_entry_t *last = NULL;
+	hashmap_grow(hashmap);
+	/* tablo tamamen dolu ve buyutulemedi */
+	if(hashmap->count > hashmap->table.mask)
+		return NULL;
 
-		do{
+	entry.hash = hash;
+	entry.hash_key = hashmap->hash_dup(hash_key);
+	entry.item = item;
 
-			if(hashmap->hash_cmp(entry->hash_key,hash_key)){
+	hashmap_table_insert(&hashmap->table,entry);
+	hashmap->count++;
 
-				void *break_item = entry->item;
-				entry->item = item;
+	return NULL;
 
-				return break_item;
+}
 
-			}
+/*
+ * hashmap_create, verilen tipte hashmap olusturur. boyut baslangic
+ * yuva sayisidir, 2'nin kuvvetine yuvarlanir ve gerektikce buyur.
+ *
+ * @param size : baslangic boyutu
+ * @param type : anahtar tipi
+ */
+static hashmap_t *hashmap_create(uint32_t size,hashmap_type_t type){
 
-			last = entry;
-			entry = entry->next;
+	uint32_t slots = HASHMAP_MIN_SIZE;
+	hashmap_t *new_map;
 
-		}while(entry);
+	if(!size)
+		return NULL;
 
-		hashmap_entry_t *new_entry = malloc(sizeof(hashmap_entry_t));
-		new_entry->next = NULL;
-		new_entry->item = item;
-		new_entry->hash_key = hashmap->hash_dup(hash_key);
-		last->next = new_entry;
+	while(slots < size)
+		slots <<= 1;
 
+	new_map = malloc(sizeof(hashmap_t));
+	if(!new_map)
+		return NULL;
+
+	if(!hashmap_table_alloc(&new_map->table,slots)){
+		free(new_map);
+		return NULL;
 	}
 
-	return NULL;
+	new_map->old.slots = NULL;
+	new_map->old.mask = 0;
+	new_map->rehash_index = 0;
+	new_map->count = 0;
+	new_map->type = type;
+	new_map->signature = HASHMAP_SIGNATURE;
+
+	return new_map;
 
 }
 
 /*
  * hashmap_int_create, integer hashmap olusturur.
  *
- * @param size : boyut
+ * @param size : baslangic boyutu
  */
 hashmap_t *hashmap_int_create(uint32_t size){
 
-	if(!size)
-		return NULL;
+	hashmap_t *new_map = hashmap_create(size,HASHMAP_INT);
 
-	hashmap_t *new_map = malloc(sizeof(hashmap_t));
-	new_map->entries = malloc(sizeof(hashmap_entry_t*) * size);
-	memset(new_map->entries,0,sizeof(hashmap_entry_t*) * size);
-
-	new_map->size = size;
-	new_map->signature = HASHMAP_SIGNATURE;
+	if(!new_map)
+		return NULL;
 
 	/* fonksiyonlar */
 	new_map->hash_code = &hashmap_int_hashcode;
-	new_map->hash_cmp = &hashmap_intcmp;
-	new_map->hash_item_free = &free;
 	new_map->hash_key_free = &hashmap_int_free;
 	new_map->hash_dup = &hashmap_intdup;
 
@@ -372,24 +609,18 @@ hashmap_t *hashmap_int_create(uint32_t size){
 /*
  * hashmap_str_create, string hashmap olusturur.
  *
- * @param size : boyut
+ * @param size : baslangic boyutu
  */
 hashmap_t *hashmap_str_create(uint32_t size){
 
-	if(!size)
-		return NULL;
+	hashmap_t *new_map = hashmap_create(size,HASHMAP_STR);
 
-	hashmap_t *new_map = malloc(sizeof(hashmap_t));
-	new_map->entries = malloc(sizeof(hashmap_entry_t*) * size);
-	memset(new_map->entries,0,sizeof(hashmap_entry_t*) * size);
-	
-	new_map->size = size;
-	new_map->signature = HASHMAP_SIGNATURE;
+	if(!new_map)
+		return NULL;
 
 	/* fonksiyonlar */
 	new_map->hash_code = &hashmap_str_hashcode;
-	new_map->hash_cmp = &hashmap_strcmp;
-	new_map->hash_item_free = new_map->hash_key_free = &free; 
+	new_map->hash_key_free = &free; 
 	new_map->hash_dup = &hashmap_strdup;
 
 	return new_map;
@@ -398,13 +629,17 @@ hashmap_t *hashmap_str_create(uint32_t size){
 
 /*
  * hashmap_remove, hashmap yapisindaki belirtilen hash
- * anahtarini kaldirir.
+ * anahtarini kaldirir ve icerigini dondurur.
  *
  * @param hashmap : hashmap yapisi
  * @param hash_key : hash anahtari
  */
 void *hashmap_remove(hashmap_t *hashmap,void *hash_key){
 
+	hashmap_table_t *table;
+	hashmap_slot_t *slot;
+	void *break_item;
+
 	if(!hashmap)
 		return NULL;
 	
@@ -413,57 +648,171 @@ void *hashmap_remove(hashmap_t *hashmap,void *hash_key){
 	if(!hash_key)
 		return NULL;
 
-	uint32_t index = hashmap->hash_code(hash_key) % hashmap->size;
-	hashmap_entry_t *entry = hashmap->entries[index];
+	hashmap_rehash_step(hashmap,HASHMAP_REHASH_STEP);
+
+	slot = hashmap_find(hashmap,hashmap_hash(hashmap,hash_key),hash_key,&table);
+	if(!slot)
+		return NULL;
+
+	break_item = slot->item;
+	hashmap->hash_key_free(slot->hash_key);
+	hashmap->count--;
+
+	/*
+	 * eski tablo sirayla tasindigi icin elemanlar geri kaydirilamaz,
+	 * tasima imlecinin gerisine dusebilirler. yuva silinmis olarak
+	 * isaretlenir, hash korunur ki yoklama zinciri kopmasin.
+	 */
+	if(table == &hashmap->old)
+		slot->hash_key = NULL;
+	else
+		hashmap_table_delete(table,slot);
+
+	return break_item;
+
+}
+
+/*
+ * hashmap_set_hash, hashmap'in hash fonksiyonunu degistirir. mevcut
+ * anahtarlarin yeri hash'e bagli oldugu icin sadece bos hashmap'te
+ * yapilabilir, aksi halde -1 doner.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param hash_code : hash fonksiyonu
+ */
+int32_t hashmap_set_hash(hashmap_t *hashmap,hashmap_hash_code_t hash_code){
+
+	if(!hashmap || !hash_code)
+		return -1;
+
+	assert(hashmap->signature == HASHMAP_SIGNATURE && "Wrong! hashmap signature");
+
+	if(hashmap->count)
+		return -1;
+
+	hashmap->hash_code = hash_code;
 
-	if(entry){
+	return 0;
 
-		if(hashmap->hash_cmp(entry->hash_key,hash_key)){
+}
 
-			void *break_item = entry->item;
-			hashmap->entries[index] = entry->next;
-			hashmap->hash_key_free(entry->hash_key);
-			hashmap->hash_item_free(entry);
-			
-			return break_item;
+/*
+ * hashmap_stat, hashmap'in doluluk ve yoklama mesafesi istatistiklerini
+ * hesaplar. yoklama mesafesi, anahtarin ideal yuvasindan kac yuva
+ * ileride durdugudur (zincirli tablodaki zincir uzunlugunun karsiligi).
+ *
+ * @param hashmap : hashmap yapisi
+ * @param stat : istatistiklerin yazilacagi yapi
+ */
+void hashmap_stat(hashmap_t *hashmap,hashmap_stat_t *stat){
 
-		}else{
+	hashmap_table_t *tables[2] = { &hashmap->table, &hashmap->old };
 
-			hashmap_entry_t *last = entry;
-			entry = entry->next;
+	assert(hashmap->signature == HASHMAP_SIGNATURE && "Wrong! hashmap signature");
 
-			do{
+	memset(stat,0,sizeof(hashmap_stat_t));
+	stat->count = hashmap->count;
+	stat->size = hashmap->table.mask + 1;
+	stat->rehashing = hashmap->old.slots != NULL;
 
-				if(hashmap->hash_cmp(entry->hash_key,hash_key)){
+	for(uint32_t t = 0;t < 2;t++){
 
-					void *break_item = entry->item;
-					last->next = entry->next;
-					hashmap->hash_key_free(entry->hash_key);
-					hashmap->hash_item_free(entry);
+		if(!tables[t]->slots)
+			continue;
 
-					return break_item;
+		for(uint32_t i = 0;i <= tables[t]->mask;i++){
 
-				}
+			hashmap_slot_t *slot = &tables[t]->slots[i];
+			uint32_t dist;
 
-				last = entry;
-				entry = entry->next;
+			if(!slot->hash || !slot->hash_key)
+				continue;
 
-			}while(entry);
+			dist = hashmap_probe_dist(tables[t],slot->hash,i);
+			stat->total_probe += dist;
+			if(dist)
+				stat->collisions++;
+			if(dist > stat->max_probe)
+				stat->max_probe = dist;
 
 		}
 
 	}
 
-	return NULL;
+}
+
+/*
+ * hashmap_stat_dump, hashmap istatistiklerini yazdirir.
+ *
+ * @param hashmap : hashmap yapisi
+ * @param name : hashmap ismi
+ */
+void hashmap_stat_dump(hashmap_t *hashmap,const char *name){
+
+	hashmap_stat_t stat;
+	uint32_t avg = 0;
+
+	if(!hashmap)
+		return;
+
+	hashmap_stat(hashmap,&stat);
+	if(stat.count)
+		avg = stat.total_probe * 100 / stat.count;
+
+	debug_print(KERN_INFO,"hashmap %s: %u/%u keys, %u collisions, probe avg %u.%02u max %u%s",
+			name,stat.count,stat.size,stat.collisions,avg / 100,avg % 100,
+			stat.max_probe,stat.rehashing ? " (rehashing)" : "");
 
 }
 
 /*
- * __hashmap_test
+ * __hashmap_test, buyutme surerken silme, arama ve destroy'u dener.
+ * tasinan anahtarlarin eski kopyalari gorunmemelidir.
  */
 void __hashmap_test(void){
 
+	hashmap_t *map = hashmap_str_create(HASHMAP_MIN_SIZE);
+	char key[16];
+	list_t *keys;
+	uint32_t removed = 0,size;
+
+	debug_print(KERN_INFO,"hashmap rehash test...");
+
+	/* en son eklemeden sonra da buyutme surmeli */
+	for(uint32_t i = 0; i < HASHMAP_TEST_KEYS || !map->old.slots; i++){
+
+		snprintf(key,sizeof(key),"key%u",i);
+		hashmap_set(map,(void*)(i + 1),key);
+
+		/* buyutme suruyorken yarisi silinir */
+		if(!map->old.slots || (i & 1))
+			continue;
+
+		snprintf(key,sizeof(key),"key%u",removed);
+		hashmap_remove(map,key);
+		if(hashmap_get(map,key) || hashmap_check(map,key) > 0){
+			debug_print(KERN_ERROR,"hashmap: removed key %s still found",key);
+			hashmap_destroy(map);
+			return;
+		}
+		removed++;
+
+		keys = hashmap_get_keys(map);
+		size = keys->size;
+		list_free(keys);
+		free(keys);
+		if(size != map->count){
+			debug_print(KERN_ERROR,"hashmap: %u keys listed, %u expected",size,map->count);
+			hashmap_destroy(map);
+			return;
+		}
+
+	}
 
+	/* eski tablo tam tasinmadan yok edilir, anahtarlar bir kere bosa cikmali */
+	debug_print(KERN_DUMP,"hashmap rehash test passed, %u keys%s",map->count,
+							map->old.slots ? " (rehashing)" : "");
+	hashmap_destroy(map);
 
 }
 
@@ -236,8 +236,8 @@ linked_list_t *linked_list_merge(linked_list_t *dest,linked_list_t *src){
 	if(src->last_node)
 		dest->last_node = src->last_node;
 
-	free(src);
 	dest->size += src->size;
+	free(src);
 
 	return dest;
 
@@ -517,11 +517,11 @@ void __linked_list_test(void){
 	
 	debug_print(KERN_INFO,"test-0\n");
 	list_t *list = list_create();
-	debug_print(KERN_DUMP,"linked_list : %P",list);
+	debug_print(KERN_DUMP,"linked_list : 0x%08X",list);
 	list_destroy(list);
 
 	list_t *new_list = list_create();
-	debug_print(KERN_DUMP,"new linked_list : %P",new_list);
+	debug_print(KERN_DUMP,"new linked_list : 0x%08X",new_list);
 
 #endif
 
@@ -530,55 +530,55 @@ void __linked_list_test(void){
 	debug_print(KERN_INFO,"\ntest-1");
 	uint32_t *x = malloc(4);
 	list_t *list = list_create();
-	debug_print(KERN_DUMP,"linked_list : %P, x : %P",list,x);
-	debug_print(KERN_DUMP,"first_node : %P",list->first_node);
+	debug_print(KERN_DUMP,"linked_list : 0x%08X, x : 0x%08X",list,x);
+	debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
 	
 	list_push(list,x);
-	debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-	debug_print(KERN_DUMP,"last_node : %P",list->last_node);
-	debug_print(KERN_DUMP,"item : %P",list->first_node->item);
+	debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+	debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
+	debug_print(KERN_DUMP,"item : 0x%08X",list->first_node->item);
 
 	#if 1	/* test-1.1 */
 		debug_print(KERN_DUMP,"\ntest-1.1");
 		node_t *node = list_pop(list);
-		debug_print(KERN_DUMP,"node : %P",node);	
-		debug_print(KERN_DUMP,"node -> item : %P",node->item);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"node : 0x%08X",node);	
+		debug_print(KERN_DUMP,"node -> item : 0x%08X",node->item);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 	
 		/* test-1.2 */
 		debug_print(KERN_DUMP,"\ntest-1.2");
 		list_link(list,node);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 
 		/* test-1.3 */
 		debug_print(KERN_DUMP,"\ntest-1.3");
 		uint32_t *y = malloc(4);
 		list_push(list,y);
 		int8_t index = list_get_index(list,y);
-		debug_print(KERN_DUMP,"item index : %d, y : %P",index,y);
+		debug_print(KERN_DUMP,"item index : %d, y : 0x%08X",index,y);
 		
 		node = list_search(list,x);
-		debug_print(KERN_DUMP,"node : %P",node);	
-		debug_print(KERN_DUMP,"node -> item : %P",node->item);
+		debug_print(KERN_DUMP,"node : 0x%08X",node);	
+		debug_print(KERN_DUMP,"node -> item : 0x%08X",node->item);
 	
 		/* test-1.4 */
 		debug_print(KERN_DUMP,"\ntest-1.4");
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);		
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);		
 		list_unlink(list,node);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 		list_link(list,node);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 
 		/* test-1.5 */
 		debug_print(KERN_DUMP,"\ntest-1.5");
 		list_remove(list,1);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 	#endif
 
 #endif
@@ -587,47 +587,47 @@ void __linked_list_test(void){
 	debug_print(KERN_INFO,"\ntest-2");
 	uint32_t *x = malloc(4);
 	list_t *list = list_create();
-	debug_print(KERN_DUMP,"linked_list : %P, x : %P",list,x);
-	debug_print(KERN_DUMP,"first_node : %P",list->first_node);
+	debug_print(KERN_DUMP,"linked_list : 0x%08X, x : 0x%08X",list,x);
+	debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
 	
 	list_push(list,x);
-	debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-	debug_print(KERN_DUMP,"last_node : %P",list->last_node);
-	debug_print(KERN_DUMP,"item : %P",list->first_node->item);
+	debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+	debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
+	debug_print(KERN_DUMP,"item : 0x%08X",list->first_node->item);
 
 	#if 1	/* test-2.1 */
 		debug_print(KERN_DUMP,"\ntest-2.1");
 		list_destroy(list);
 		list_t *new_list = list_create();
 		uint32_t *y = malloc(4);
-		debug_print(KERN_DUMP,"new linked_list : %P, y : %P",new_list,y);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"new linked_list : 0x%08X, y : 0x%08X",new_list,y);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 
 		/* test-2.2 */
 		debug_print(KERN_DUMP,"\ntest-2.2");
 		list_push(list,y);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 		list_free(list);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 		
 		node_t *new_node = malloc(sizeof(node_t));
 		uint32_t *w = malloc(4);
-		debug_print(KERN_DUMP,"new node : %P, w : %P",new_node,w);
+		debug_print(KERN_DUMP,"new node : 0x%08X, w : 0x%08X",new_node,w);
 		free(new_node);
 
 		/* test-2.3 */
 		debug_print(KERN_DUMP,"\ntest-2.3");
 		list_push(list,w);
 		list_push(list,y);
-		debug_print(KERN_DUMP,"first_node : %P",list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",list->last_node);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",list->last_node);
 		list_clear(list);
 		uint32_t *h = malloc(4);
 		uint32_t *n = malloc(4);
-		debug_print(KERN_DUMP,"h : %P, n : %P",h,n);
+		debug_print(KERN_DUMP,"h : 0x%08X, n : 0x%08X",h,n);
 
 		/* test-2.4 */
 		debug_print(KERN_DUMP,"\ntest-2.4");
@@ -635,9 +635,9 @@ void __linked_list_test(void){
 		list_t *end_list = list_create();
 		uint32_t *r = malloc(4);
 		uint32_t *t = malloc(4);
-		debug_print(KERN_DUMP,"new linked_list : %P, r : %P, t : %P",end_list,r,t);
-		debug_print(KERN_DUMP,"first_node : %P",end_list->first_node);
-		debug_print(KERN_DUMP,"last_node : %P",end_list->last_node);
+		debug_print(KERN_DUMP,"new linked_list : 0x%08X, r : 0x%08X, t : 0x%08X",end_list,r,t);
+		debug_print(KERN_DUMP,"first_node : 0x%08X",end_list->first_node);
+		debug_print(KERN_DUMP,"last_node : 0x%08X",end_list->last_node);
 	#endif
 #endif
 
@@ -646,16 +646,16 @@ void __linked_list_test(void){
 	debug_print(KERN_INFO,"\ntest-3");
 	uint32_t *x = malloc(4);
 	list_t *list = list_create();
-	debug_print(KERN_DUMP,"linked_list : %P, x : %P",list,x);
-	debug_print(KERN_DUMP,"first_node : %P, size : %u",list->first_node,list->size);
+	debug_print(KERN_DUMP,"linked_list : 0x%08X, x : 0x%08X",list,x);
+	debug_print(KERN_DUMP,"first_node : 0x%08X, size : %u",list->first_node,list->size);
 	list_push(list,x);
-	debug_print(KERN_DUMP,"first_node : %P, size : %u",list->first_node,list->size);
+	debug_print(KERN_DUMP,"first_node : 0x%08X, size : %u",list->first_node,list->size);
 
 	#if 1	/* test-3.1 */
 		debug_print(KERN_DUMP,"\ntest-3.1");
 		list_t *clone = list_clone(list);
-		debug_print(KERN_DUMP,"clone list : %P",clone);
-		debug_print(KERN_DUMP,"first_node : %P, size : %u",clone->first_node,list->size);
+		debug_print(KERN_DUMP,"clone list : 0x%08X",clone);
+		debug_print(KERN_DUMP,"first_node : 0x%08X, size : %u",clone->first_node,list->size);
 
 		/* test-3.2 */
 		debug_print(KERN_DUMP,"\ntest-3.2");
@@ -666,11 +666,11 @@ void __linked_list_test(void){
 		list_push(list1,w);
 		list_t *list2 = list_create();
 		list_t *list3 = list_create();
-		debug_print(KERN_DUMP,"list1 : %P, list2 : %P, list3 : %P",list1,list2,list3);
-		debug_print(KERN_DUMP,"list1 first_node : %P",list1->first_node);
-		debug_print(KERN_DUMP,"list1 last_node : %P",list1->last_node);
-		debug_print(KERN_DUMP,"list2 first_node : %P",list2->first_node);
-		debug_print(KERN_DUMP,"list2 last_node : %P",list2->last_node);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list2 : 0x%08X, list3 : 0x%08X",list1,list2,list3);
+		debug_print(KERN_DUMP,"list1 first_node : 0x%08X",list1->first_node);
+		debug_print(KERN_DUMP,"list1 last_node : 0x%08X",list1->last_node);
+		debug_print(KERN_DUMP,"list2 first_node : 0x%08X",list2->first_node);
+		debug_print(KERN_DUMP,"list2 last_node : 0x%08X",list2->last_node);
 	#endif
 #endif
 
@@ -683,22 +683,22 @@ void __linked_list_test(void){
 	list_t *list2 = list_create();
 
 	list_push(list1,x);
-	debug_print(KERN_DUMP,"list1 : %P, size : %u, x : %P",list1,list1->size,x);
-	debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
+	debug_print(KERN_DUMP,"list1 : 0x%08X, size : %u, x : 0x%08X",list1,list1->size,x);
+	debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
 	list_push(list2,y);
 	list_push(list2,z);
-	debug_print(KERN_DUMP,"list2 : %P, size : %u, y : %P, z : %P",list2,list2->size,y,z);
-	debug_print(KERN_DUMP,"list2 first node : %P, last node : %P",list2->first_node,list2->last_node);
+	debug_print(KERN_DUMP,"list2 : 0x%08X, size : %u, y : 0x%08X, z : 0x%08X",list2,list2->size,y,z);
+	debug_print(KERN_DUMP,"list2 first node : 0x%08X, last node : 0x%08X",list2->first_node,list2->last_node);
 
 	#if 1	/* test-4.1 */
 		debug_print(KERN_DUMP,"\ntest-4.1");
 		list_merge(list1,list2);
-		debug_print(KERN_DUMP,"list1 : %P, size : %u",list1,list1->size);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, size : %u",list1,list1->size);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
 		list_t *list3 = list_create();
 		uint32_t *w = malloc(4);
-		debug_print(KERN_DUMP,"list3 : %P, size : %u, w : %P",list3,list3->size,w);
-		debug_print(KERN_DUMP,"list3 first node : %P, last node : %P",list3->first_node,list3->last_node);
+		debug_print(KERN_DUMP,"list3 : 0x%08X, size : %u, w : 0x%08X",list3,list3->size,w);
+		debug_print(KERN_DUMP,"list3 first node : 0x%08X, last node : 0x%08X",list3->first_node,list3->last_node);
 	#endif
 	
 #endif
@@ -711,15 +711,15 @@ void __linked_list_test(void){
 
 
 	node_t *node0 = list_push(list1,x);
-	debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-	debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
+	debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+	debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
 
 	#if 0	/* test-5.1 */
 		debug_print(KERN_DUMP,"\ntest-5.1");
 		node_t *node1 = malloc(sizeof(node_t));
 		list_link_next(list1,node1,node0);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
 	#endif
 
 	#if 0	/* test-5.2 */
@@ -727,20 +727,20 @@ void __linked_list_test(void){
 		uint32_t *h = malloc(4);
 		node_t *h_node = list_push(list1,h);
 		node_t *node1 = malloc(sizeof(node_t));
-		debug_print(KERN_DUMP,"h_node : %P, h : %P, node1 : %P",h_node,h,node1);
+		debug_print(KERN_DUMP,"h_node : 0x%08X, h : 0x%08X, node1 : 0x%08X",h_node,h,node1);
 		list_link_next(list1,node1,node0);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
-		debug_print(KERN_DUMP,"list1 first node next : %P",list1->first_node->next);
-		debug_print(KERN_DUMP,"node1 next : %P, node1 prev : %P, last node prev : %P",node1->next,node1->prev,list1->last_node->prev);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 first node next : 0x%08X",list1->first_node->next);
+		debug_print(KERN_DUMP,"node1 next : 0x%08X, node1 prev : 0x%08X, last node prev : 0x%08X",node1->next,node1->prev,list1->last_node->prev);
 	#endif
 
 	#if 0	/* test-5.3 */
 		debug_print(KERN_DUMP,"\ntest-5.3");
 		node_t *node1 = malloc(sizeof(node_t));
 		list_link_prev(list1,node1,node0);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
 	#endif
 	
 	#if 0	/* test-5.4 */
@@ -748,12 +748,12 @@ void __linked_list_test(void){
 		uint32_t *h = malloc(4);
 		node_t *h_node = list_push(list1,h);
 		node_t *node1 = malloc(sizeof(node_t));
-		debug_print(KERN_DUMP,"h_node : %P, h : %P, node1 : %P",h_node,h,node1);
+		debug_print(KERN_DUMP,"h_node : 0x%08X, h : 0x%08X, node1 : 0x%08X",h_node,h,node1);
 		list_link_prev(list1,node1,node0);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
-		debug_print(KERN_DUMP,"list1 first node next : %P",list1->first_node->next);
-		debug_print(KERN_DUMP,"node1 next : %P, node1 prev : %P, last node prev : %P",node1->next,node1->prev,list1->last_node->prev);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 first node next : 0x%08X",list1->first_node->next);
+		debug_print(KERN_DUMP,"node1 next : 0x%08X, node1 prev : 0x%08X, last node prev : 0x%08X",node1->next,node1->prev,list1->last_node->prev);
 	#endif
 
 	#if 0	/* test-5.5 */
@@ -761,12 +761,12 @@ void __linked_list_test(void){
 		uint32_t *h = malloc(4);
 		node_t *h_node = list_push(list1,h);
 		node_t *node1 = malloc(sizeof(node_t));
-		debug_print(KERN_DUMP,"h_node : %P, h : %P, node1 : %P",h_node,h,node1);
+		debug_print(KERN_DUMP,"h_node : 0x%08X, h : 0x%08X, node1 : 0x%08X",h_node,h,node1);
 		list_link_next(list1,node1,h_node);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P",list1->first_node,list1->last_node);
-		debug_print(KERN_DUMP,"list1 first node next : %P",list1->first_node->next);
-		debug_print(KERN_DUMP,"node1 next : %P, node1 prev : %P, last node prev : %P",node1->next,node1->prev,list1->last_node->prev);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 first node next : 0x%08X",list1->first_node->next);
+		debug_print(KERN_DUMP,"node1 next : 0x%08X, node1 prev : 0x%08X, last node prev : 0x%08X",node1->next,node1->prev,list1->last_node->prev);
 	#endif
 
 	#if 0	/* test-5.6 */
@@ -774,12 +774,12 @@ void __linked_list_test(void){
 		uint32_t *h = malloc(4);
 		node_t *h_node = list_push(list1,h);
 		node_t *node1 = malloc(sizeof(node_t));
-		debug_print(KERN_DUMP,"h_node : %P, h : %P, node1 : %P\n",h_node,h,node1);
+		debug_print(KERN_DUMP,"h_node : 0x%08X, h : 0x%08X, node1 : 0x%08X\n",h_node,h,node1);
 		list_link_prev(list1,node1,h_node);
-		debug_print(KERN_DUMP,"list1 : %P, list1 size : %u, x : %P",list1,list1->size,x);
-		debug_print(KERN_DUMP,"list1 first node : %P, last node : %P\n",list1->first_node,list1->last_node);
-		debug_print(KERN_DUMP,"list1 first node next : %P",list1->first_node->next);
-		debug_print(KERN_DUMP,"node1 next : %P, node1 prev : %P, last node prev : %P",node1->next,node1->prev,list1->last_node->prev);
+		debug_print(KERN_DUMP,"list1 : 0x%08X, list1 size : %u, x : 0x%08X",list1,list1->size,x);
+		debug_print(KERN_DUMP,"list1 first node : 0x%08X, last node : 0x%08X\n",list1->first_node,list1->last_node);
+		debug_print(KERN_DUMP,"list1 first node next : 0x%08X",list1->first_node->next);
+		debug_print(KERN_DUMP,"node1 next : 0x%08X, node1 prev : 0x%08X, last node prev : 0x%08X",node1->next,node1->prev,list1->last_node->prev);
 	#endif
 #endif
 
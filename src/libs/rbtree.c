@@ -0,0 +1,669 @@
+/*
+ *  Copyright(C) 2014 Codnect Team
+ *  Copyright(C) 2014 Burak Köken
+ *
+ *  This file is part of Uniq.
+ *
+ *  Uniq is free software: you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation, version 2 of the License.
+ *
+ *  Uniq is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Uniq.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Red-Black Tree
+ */
+
+#include <uniq/module.h>
+#include <uniq/kernel.h>
+#include <rbtree.h>
+
+#define rb_is_red(node)		((node) && (node)->color == RB_RED)
+#define rb_is_black(node)	(!rb_is_red(node))
+
+/*
+ * rb_replace_child, parent'in old cocugunu new ile degistirir. parent
+ * NULL ise old koktur.
+ *
+ * @param root : agac
+ * @param old : eski cocuk
+ * @param new : yeni cocuk
+ * @param parent : ebeveyn
+ */
+static inline void rb_replace_child(rb_root_t *root,rb_node_t *old,rb_node_t *new,
+				    rb_node_t *parent){
+
+	if(!parent)
+		root->root = new;
+	else if(parent->left == old)
+		parent->left = new;
+	else
+		parent->right = new;
+
+}
+
+/*
+ * rb_rotate_left, node'u sag cocugunun soluna indirir.
+ *
+ *      node              right
+ *     /    \            /     \
+ *    a    right  =>   node     c
+ *        /     \     /    \
+ *       b       c   a      b
+ *
+ * @param root : agac
+ * @param node : dondurulen dugum
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+static void rb_rotate_left(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug){
+
+	rb_node_t *right = node->right;
+
+	node->right = right->left;
+	if(right->left)
+		right->left->parent = node;
+
+	right->parent = node->parent;
+	rb_replace_child(root,node,right,node->parent);
+
+	right->left = node;
+	node->parent = right;
+
+	if(aug)
+		aug->rotate(node,right);
+
+}
+
+/*
+ * rb_rotate_right, rb_rotate_left'in simetrigi.
+ *
+ * @param root : agac
+ * @param node : dondurulen dugum
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+static void rb_rotate_right(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug){
+
+	rb_node_t *left = node->left;
+
+	node->left = left->right;
+	if(left->right)
+		left->right->parent = node;
+
+	left->parent = node->parent;
+	rb_replace_child(root,node,left,node->parent);
+
+	left->right = node;
+	node->parent = left;
+
+	if(aug)
+		aug->rotate(node,left);
+
+}
+
+/*
+ * rb_link_node, dugumu arama sirasinda bulunan bos yere (link) baglar.
+ * cagiran kendi karsilastirmasiyla inip yeri bulur, ardindan
+ * rb_insert_color cagirmalidir.
+ *
+ * @param node : yeni dugum
+ * @param parent : ebeveyn (agac bossa NULL)
+ * @param link : parent->left, parent->right ya da &root->root
+ */
+void rb_link_node(rb_node_t *node,rb_node_t *parent,rb_node_t **link){
+
+	node->parent = parent;
+	node->left = node->right = NULL;
+	node->color = RB_RED;
+	*link = node;
+
+}
+
+/*
+ * rb_insert_color, yeni baglanan kirmizi dugumden baslayarak
+ * kirmizi-kirmizi ihlallerini yeniden boyama ve dondurmelerle giderir.
+ *
+ * @param root : agac
+ * @param node : rb_link_node ile baglanan dugum
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+void rb_insert_color(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug){
+
+	rb_node_t *parent,*grand,*uncle;
+
+	root->count++;
+
+	/* yeni yaprak atalarinin bilgisini degistirir */
+	if(aug && node->parent)
+		aug->propagate(node->parent,NULL);
+
+	while((parent = node->parent) && parent->color == RB_RED){
+
+		/* kirmizi dugum kok olamaz, dede vardir */
+		grand = parent->parent;
+
+		if(parent == grand->left){
+
+			uncle = grand->right;
+			if(rb_is_red(uncle)){
+				parent->color = uncle->color = RB_BLACK;
+				grand->color = RB_RED;
+				node = grand;
+				continue;
+			}
+
+			if(node == parent->right){
+				rb_rotate_left(root,parent,aug);
+				node = parent;
+				parent = node->parent;
+			}
+
+			parent->color = RB_BLACK;
+			grand->color = RB_RED;
+			rb_rotate_right(root,grand,aug);
+
+		}else{
+
+			uncle = grand->left;
+			if(rb_is_red(uncle)){
+				parent->color = uncle->color = RB_BLACK;
+				grand->color = RB_RED;
+				node = grand;
+				continue;
+			}
+
+			if(node == parent->left){
+				rb_rotate_right(root,parent,aug);
+				node = parent;
+				parent = node->parent;
+			}
+
+			parent->color = RB_BLACK;
+			grand->color = RB_RED;
+			rb_rotate_left(root,grand,aug);
+
+		}
+
+	}
+
+	root->root->color = RB_BLACK;
+
+}
+
+/*
+ * rb_insert, dugumu cmp sirasina gore agaca ekler. esit dugumler
+ * mevcutlarin sagina (sonrasina) eklenir.
+ *
+ * @param root : agac
+ * @param node : yeni dugum
+ * @param cmp : karsilastirma fonksiyonu
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+void rb_insert(rb_root_t *root,rb_node_t *node,rb_cmp_t cmp,const rb_augment_t *aug){
+
+	rb_node_t **link = &root->root,*parent = NULL;
+
+	while(*link){
+		parent = *link;
+		link = cmp(node,parent) < 0 ? &parent->left : &parent->right;
+	}
+
+	rb_link_node(node,parent,link);
+	rb_insert_color(root,node,aug);
+
+}
+
+/*
+ * rb_erase_color, siyah bir dugum silindikten sonra eksik kalan siyah
+ * yuksekligi giderir. node, silinen dugumun yerine gecen (NULL
+ * olabilir) dugum, parent onun ebeveynidir.
+ *
+ * @param root : agac
+ * @param node : eksik siyahi tasiyan dugum
+ * @param parent : ebeveyni
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+static void rb_erase_color(rb_root_t *root,rb_node_t *node,rb_node_t *parent,
+			   const rb_augment_t *aug){
+
+	rb_node_t *sibling;
+
+	while(node != root->root && rb_is_black(node)){
+
+		if(node == parent->left){
+
+			sibling = parent->right;
+			if(rb_is_red(sibling)){
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_left(root,parent,aug);
+				sibling = parent->right;
+			}
+
+			if(rb_is_black(sibling->left) && rb_is_black(sibling->right)){
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if(rb_is_black(sibling->right)){
+				sibling->left->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_right(root,sibling,aug);
+				sibling = parent->right;
+			}
+
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->right->color = RB_BLACK;
+			rb_rotate_left(root,parent,aug);
+
+		}else{
+
+			sibling = parent->left;
+			if(rb_is_red(sibling)){
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_right(root,parent,aug);
+				sibling = parent->left;
+			}
+
+			if(rb_is_black(sibling->left) && rb_is_black(sibling->right)){
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if(rb_is_black(sibling->left)){
+				sibling->right->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_left(root,sibling,aug);
+				sibling = parent->left;
+			}
+
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->left->color = RB_BLACK;
+			rb_rotate_right(root,parent,aug);
+
+		}
+
+		node = root->root;
+		break;
+
+	}
+
+	if(node)
+		node->color = RB_BLACK;
+
+}
+
+/*
+ * rb_erase, dugumu agactan cikarir. iki cocuklu dugumun yerini
+ * sirali ardili (sag alt agacin en kucugu) alir.
+ *
+ * @param root : agac
+ * @param node : cikarilacak dugum
+ * @param aug : artirilmis agac kancalari (NULL olabilir)
+ */
+void rb_erase(rb_root_t *root,rb_node_t *node,const rb_augment_t *aug){
+
+	rb_node_t *child,*parent;
+	uint32_t color;
+
+	if(!node->left || !node->right){
+
+		child = node->left ? node->left : node->right;
+		parent = node->parent;
+		color = node->color;
+
+		rb_replace_child(root,node,child,parent);
+		if(child)
+			child->parent = parent;
+
+	}else{
+
+		rb_node_t *next = node->right;
+
+		while(next->left)
+			next = next->left;
+
+		color = next->color;
+		child = next->right;
+
+		if(next->parent == node)
+			parent = next;
+		else{
+			parent = next->parent;
+			parent->left = child;
+			if(child)
+				child->parent = parent;
+
+			next->right = node->right;
+			node->right->parent = next;
+		}
+
+		next->left = node->left;
+		node->left->parent = next;
+		next->parent = node->parent;
+		next->color = node->color;
+		rb_replace_child(root,node,next,node->parent);
+
+	}
+
+	root->count--;
+
+	/* en derindeki degisen dugumden koke kadar bilgi yeniden hesaplanir */
+	if(aug && parent)
+		aug->propagate(parent,NULL);
+
+	if(color == RB_BLACK)
+		rb_erase_color(root,child,parent,aug);
+
+}
+
+/*
+ * rb_first, en kucuk dugumu dondurur, agac bossa NULL doner.
+ *
+ * @param root : agac
+ */
+rb_node_t *rb_first(rb_root_t *root){
+
+	rb_node_t *node = root->root;
+
+	if(node)
+		while(node->left)
+			node = node->left;
+
+	return node;
+
+}
+
+/*
+ * rb_last, en buyuk dugumu dondurur, agac bossa NULL doner.
+ *
+ * @param root : agac
+ */
+rb_node_t *rb_last(rb_root_t *root){
+
+	rb_node_t *node = root->root;
+
+	if(node)
+		while(node->right)
+			node = node->right;
+
+	return node;
+
+}
+
+/*
+ * rb_next, siradaki dugumu dondurur, son dugumse NULL doner.
+ *
+ * @param node : dugum
+ */
+rb_node_t *rb_next(rb_node_t *node){
+
+	rb_node_t *parent;
+
+	if(node->right){
+		node = node->right;
+		while(node->left)
+			node = node->left;
+		return node;
+	}
+
+	/* soldan gelinen ilk ata */
+	while((parent = node->parent) && node == parent->right)
+		node = parent;
+
+	return parent;
+
+}
+
+/*
+ * rb_prev, onceki dugumu dondurur, ilk dugumse NULL doner.
+ *
+ * @param node : dugum
+ */
+rb_node_t *rb_prev(rb_node_t *node){
+
+	rb_node_t *parent;
+
+	if(node->left){
+		node = node->left;
+		while(node->right)
+			node = node->right;
+		return node;
+	}
+
+	while((parent = node->parent) && node == parent->left)
+		node = parent;
+
+	return parent;
+
+}
+
+/*
+ * rb_lower_bound, anahtardan kucuk olmayan ilk dugumu dondurur,
+ * yoksa NULL doner. aralik dolasimi icin baslangic noktasidir.
+ *
+ * @param root : agac
+ * @param key : anahtar
+ * @param cmp : anahtar karsilastirma fonksiyonu
+ */
+rb_node_t *rb_lower_bound(rb_root_t *root,const void *key,rb_key_cmp_t cmp){
+
+	rb_node_t *node = root->root,*result = NULL;
+
+	while(node){
+		if(cmp(key,node) <= 0){
+			result = node;
+			node = node->left;
+		}else
+			node = node->right;
+	}
+
+	return result;
+
+}
+
+/*
+ * rb_upper_bound, anahtardan buyuk ilk dugumu dondurur, yoksa NULL
+ * doner.
+ *
+ * @param root : agac
+ * @param key : anahtar
+ * @param cmp : anahtar karsilastirma fonksiyonu
+ */
+rb_node_t *rb_upper_bound(rb_root_t *root,const void *key,rb_key_cmp_t cmp){
+
+	rb_node_t *node = root->root,*result = NULL;
+
+	while(node){
+		if(cmp(key,node) < 0){
+			result = node;
+			node = node->left;
+		}else
+			node = node->right;
+	}
+
+	return result;
+
+}
+
+/*
+ * rb_find, anahtara esit ilk dugumu dondurur, yoksa NULL doner.
+ *
+ * @param root : agac
+ * @param key : anahtar
+ * @param cmp : anahtar karsilastirma fonksiyonu
+ */
+rb_node_t *rb_find(rb_root_t *root,const void *key,rb_key_cmp_t cmp){
+
+	rb_node_t *node = rb_lower_bound(root,key,cmp);
+
+	if(node && !cmp(key,node))
+		return node;
+
+	return NULL;
+
+}
+
+/*
+ * fuzz testi. rastgele anahtarlarla ekleme/silme yapilir, her adimda
+ * sira, renk kurallari, siyah yukseklik, ebeveyn isaretcileri ve
+ * artirilmis alt agac boyutu dogrulanir.
+ */
+#define RB_TEST_NODES		256
+#define RB_TEST_ROUNDS		20000
+
+typedef struct{
+	rb_node_t node;
+	uint32_t key;
+	uint32_t size;			/* alt agactaki dugum sayisi (artirilmis) */
+	bool linked;
+}rb_test_t;
+
+static rb_test_t rb_test_nodes[RB_TEST_NODES];
+
+static uint32_t rb_test_size(rb_node_t *node){
+
+	return node ? rb_entry(node,rb_test_t,node)->size : 0;
+
+}
+
+static void rb_test_propagate(rb_node_t *node,rb_node_t *stop){
+
+	for(; node != stop; node = node->parent)
+		rb_entry(node,rb_test_t,node)->size = 1 + rb_test_size(node->left) +
+							  rb_test_size(node->right);
+
+}
+
+static void rb_test_rotate(rb_node_t *old,rb_node_t *new){
+
+	rb_entry(new,rb_test_t,node)->size = rb_entry(old,rb_test_t,node)->size;
+	rb_entry(old,rb_test_t,node)->size = 1 + rb_test_size(old->left) + rb_test_size(old->right);
+
+}
+
+static const rb_augment_t rb_test_aug = { rb_test_propagate, rb_test_rotate };
+
+static int32_t rb_test_cmp(const rb_node_t *a,const rb_node_t *b){
+
+	uint32_t x = rb_entry(a,rb_test_t,node)->key,y = rb_entry(b,rb_test_t,node)->key;
+
+	return x < y ? -1 : x > y;
+
+}
+
+static int32_t rb_test_key_cmp(const void *key,const rb_node_t *node){
+
+	uint32_t x = *(const uint32_t*)key,y = rb_entry(node,rb_test_t,node)->key;
+
+	return x < y ? -1 : x > y;
+
+}
+
+/*
+ * rb_test_check, alt agaci dogrular ve siyah yuksekligini dondurur,
+ * hata varsa -1 doner.
+ */
+static int32_t rb_test_check(rb_node_t *node,rb_node_t *parent){
+
+	int32_t left,right;
+
+	if(!node)
+		return 1;
+
+	if(node->parent != parent)
+		return -1;
+
+	if(rb_is_red(node) && (rb_is_red(node->left) || rb_is_red(node->right)))
+		return -1;
+
+	if((node->left && rb_test_cmp(node->left,node) > 0) ||
+	   (node->right && rb_test_cmp(node->right,node) < 0))
+		return -1;
+
+	if(rb_test_size(node) != 1 + rb_test_size(node->left) + rb_test_size(node->right))
+		return -1;
+
+	left = rb_test_check(node->left,node);
+	right = rb_test_check(node->right,node);
+	if(left < 0 || left != right)
+		return -1;
+
+	return left + rb_is_black(node);
+
+}
+
+/*
+ * __rbtree_test
+ */
+void __rbtree_test(void){
+
+	rb_root_t root = RB_ROOT_INIT;
+	uint32_t seed = 0x2545F491,linked = 0;
+
+	debug_print(KERN_INFO,"rbtree fuzz test, %u rounds...",RB_TEST_ROUNDS);
+
+	for(uint32_t round = 0; round < RB_TEST_ROUNDS; round++){
+
+		rb_test_t *test;
+		rb_node_t *node,*prev = NULL;
+		uint32_t count = 0,key;
+
+		seed = seed * 1664525 + 1013904223;
+		test = &rb_test_nodes[(seed >> 8) % RB_TEST_NODES];
+
+		if(test->linked){
+			rb_erase(&root,&test->node,&rb_test_aug);
+			test->linked = false;
+			linked--;
+		}else{
+			/* kucuk anahtar araligi, esit anahtarlar da denenir */
+			test->key = (seed >> 16) % (RB_TEST_NODES * 2);
+			test->size = 1;
+			rb_insert(&root,&test->node,rb_test_cmp,&rb_test_aug);
+			test->linked = true;
+			linked++;
+		}
+
+		if(rb_test_check(root.root,NULL) < 0 || rb_test_size(root.root) != linked ||
+		   root.count != linked){
+			debug_print(KERN_ERROR,"rbtree: invariant broken at round %u",round);
+			return;
+		}
+
+		rb_for_each(node,&root){
+			if(prev && rb_test_cmp(prev,node) > 0){
+				debug_print(KERN_ERROR,"rbtree: iteration out of order at round %u",round);
+				return;
+			}
+			prev = node;
+			count++;
+		}
+
+		key = seed % (RB_TEST_NODES * 2);
+		node = rb_lower_bound(&root,&key,rb_test_key_cmp);
+		if(count != linked || (node && rb_test_key_cmp(&key,node) > 0) ||
+		   (node && rb_prev(node) && rb_test_key_cmp(&key,rb_prev(node)) <= 0)){
+			debug_print(KERN_ERROR,"rbtree: lookup mismatch at round %u",round);
+			return;
+		}
+
+	}
+
+	debug_print(KERN_DUMP,"rbtree fuzz test passed, %u nodes left",linked);
+
+}
+
+MODULE_AUTHOR("Burak Köken");
+MODULE_LICENSE("GNU GPL v2");
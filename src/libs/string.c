@@ -21,6 +21,123 @@
 #include <ctype.h>
 #include <uniq/module.h>
 #include <uniq/kernel.h>
+#include <uniq/cpuid.h>
+#include <uniq/div64.h>
+#include <uniq/word.h>
+
+/*
+ * mem* fonksiyonlari kucuk boyutlarda rep movs/stos ile, buyuk
+ * boyutlarda islemci destekliyorsa sse2 ile calisir. strlen, strchr
+ * ve memchr once kelime kelime, uzun dizilerde sse2 ile tarar. sse2 string_init
+ * tarafindan acilir, o zamana kadar (ve desteklenmiyorsa) rep yolu
+ * kullanilir. xmm kaydedicileri surec degisiminde saklanmadigi icin
+ * sse2 dongusu kesmeler kapaliyken, en fazla MEM_SSE2_CHUNK bayt
+ * boyunca calisir. cekirdek -msse olmadan derlendigi icin derleyici
+ * xmm kaydedicilerini kullanmaz, asm bloklari bunlari clobber listesine
+ * yazmadan serbestce kullanabilir.
+ */
+#define MEM_SSE2_MIN		512		/* sse2'nin rep'i gectigi boyut */
+#define MEM_SSE2_CHUNK		4096		/* kesmeler kapaliyken islenen en fazla bayt */
+
+static bool mem_sse2 = false;
+
+/* hizali kelime okumasi, diger tiplerle ayni bellege erisebilir */
+typedef uint32_t __attribute__((may_alias)) str_word_t;
+
+#define STR_SSE2_MIN		64		/* sse2 taramasina gecmeden once bakilan bayt */
+#define STR_HORSPOOL_MIN	4		/* strstr'in horspool kullandigi igne boyu */
+
+/*
+ * mem_scan_sse2, 16 bayt hizali p'den end'e kadar 16 baytlik bloklari
+ * tarar ve c'ye (nul ise sifira da) esit olan ilk baytin adresini
+ * dondurur, bulunamazsa end doner. aralik MEM_SSE2_CHUNK'u gecmemelidir.
+ * hizali okumalar sayfa sinirini asmadigi icin dizinin sonundan sonraki
+ * baytlara bakmak guvenlidir.
+ *
+ * @param p : baslangic adresi (16 bayt hizali)
+ * @param end : bitis adresi (16 bayt hizali)
+ * @param c : aranan bayt
+ * @param nul : sifir bayti da eslesir mi?
+ */
+static const uint8_t *mem_scan_sse2(const uint8_t *p,const uint8_t *end,uint8_t c,bool nul){
+
+	uint32_t flags = irq_save(),mask = 0;
+	uint32_t pattern = c * WORD_ONES;
+
+	/* xmm1 aranan bayt, xmm2 sifir (nul degilse yine aranan bayt) */
+	__asm__ volatile("movd %0, %%xmm1\n\t"
+			 "pshufd $0, %%xmm1, %%xmm1\n\t"
+			 "movd %1, %%xmm2\n\t"
+			 "pshufd $0, %%xmm2, %%xmm2"
+			 : : "r"(pattern), "r"(nul ? 0 : pattern));
+
+	for(; p < end; p += 16){
+
+		__asm__ volatile("movdqa (%1), %%xmm0\n\t"
+				 "movdqa %%xmm0, %%xmm3\n\t"
+				 "pcmpeqb %%xmm1, %%xmm0\n\t"
+				 "pcmpeqb %%xmm2, %%xmm3\n\t"
+				 "por %%xmm3, %%xmm0\n\t"
+				 "pmovmskb %%xmm0, %0"
+				 : "=r"(mask) : "r"(p));
+
+		if(mask)
+			break;
+
+	}
+
+	irq_restore(flags);
+
+	return mask ? p + __builtin_ctz(mask) : end;
+
+}
+
+/*
+ * str_scan, s'den itibaren c'ye ya da sifira esit olan ilk bayti
+ * bulur. once kelime hizasina kadar bayt bayt, sonra kelime kelime
+ * bakilir. dizi STR_SSE2_MIN bayttan uzunsa sse2'ye gecilir.
+ *
+ * @param s : karakter dizisi
+ * @param c : aranan bayt
+ */
+static const uint8_t *str_scan(const uint8_t *s,uint8_t c){
+
+	const uint8_t *p = s,*q;
+	uint32_t pattern = c * WORD_ONES,w;
+
+	for(; (uint32_t)p & 3; p++)
+		if(*p == c || !*p)
+			return p;
+
+	/* hizali kelime okumasi sayfa sinirini asamaz */
+	for(;;){
+
+		if(mem_sse2 && p - s >= STR_SSE2_MIN && !((uint32_t)p & 15))
+			break;
+
+		w = *(const str_word_t*)p;
+		if(word_haszero(w) || word_hasbyte(w,pattern))
+			goto bytes;
+
+		p += 4;
+
+	}
+
+	for(;; p += MEM_SSE2_CHUNK){
+
+		q = mem_scan_sse2(p,p + MEM_SSE2_CHUNK,c,true);
+		if(q < p + MEM_SSE2_CHUNK)
+			return q;
+
+	}
+
+bytes:
+	for(; *p != c && *p; p++);
+
+	return p;
+
+}
+
 
 /*
  * strlen, verilen karakter dizisinin uzunlugu verir.
@@ -29,10 +146,8 @@
  */
 size_t strlen(const char *s){
  
-	size_t i = 0;
-	while(s[i++]);
-	
-	return --i;
+	return (const char*)str_scan((const uint8_t*)s,0) - s;
+
 }
 
 /*
@@ -332,12 +447,9 @@ char *strim(char *s){
  */
 char *strchr(const char *s, int c){
 
-	do{
-		if(*s == (char)c)
-			return (char*)s; 
-	}while(*(++s));
+	const char *p = (const char*)str_scan((const uint8_t*)s,(uint8_t)c);
 
-	return NULL;
+	return *p == (char)c ? (char*)p : NULL;
 
 }
 
@@ -482,9 +594,169 @@ char *strrtok(char *s,const char *delim){
 	return (char*)start;
 }
 
+/*
+ * memcpy_rep, once c / 4 kelimeyi rep movsl, kalan baytlari rep movsb
+ * ile kopyalar.
+ */
+static inline void memcpy_rep(void *dest,const void *src,size_t c){
+
+	uint32_t d0,d1,d2;
+
+	__asm__ volatile("rep; movsl\n\t"
+			 "movl %4, %%ecx\n\t"
+			 "rep; movsb"
+			 : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+			 : "0"(c >> 2), "g"(c & 3), "1"(dest), "2"(src)
+			 : "memory");
+
+}
+
+/*
+ * memset_rep, deger 4 bayta cogaltilip rep stosl, kalan baytlar
+ * rep stosb ile doldurulur.
+ */
+static inline void memset_rep(void *s,uint8_t v,size_t c){
+
+	uint32_t d0,d1;
+
+	__asm__ volatile("rep; stosl\n\t"
+			 "movl %3, %%ecx\n\t"
+			 "rep; stosb"
+			 : "=&c"(d0), "=&D"(d1)
+			 : "a"(v * 0x01010101), "g"(c & 3), "0"(c >> 2), "1"(s)
+			 : "memory");
+
+}
+
+/*
+ * memcpy_sse2, hedef 16 bayta hizalandiktan sonra 64 baytlik bloklar
+ * movdqu ile okunup movdqa ile yazilir.
+ */
+static void memcpy_sse2(uint8_t *d,const uint8_t *s,size_t c){
+
+	uint32_t head = -(uint32_t)d & 15,flags;
+
+	memcpy_rep(d,s,head);
+	d += head;
+	s += head;
+	c -= head;
+
+	while(c >= 64){
+
+		size_t chunk = c < MEM_SSE2_CHUNK ? c & ~63 : MEM_SSE2_CHUNK;
+
+		c -= chunk;
+		flags = irq_save();
+
+		for(; chunk; chunk -= 64,d += 64,s += 64)
+			__asm__ volatile("movdqu (%0), %%xmm0\n\t"
+					 "movdqu 16(%0), %%xmm1\n\t"
+					 "movdqu 32(%0), %%xmm2\n\t"
+					 "movdqu 48(%0), %%xmm3\n\t"
+					 "movdqa %%xmm0, (%1)\n\t"
+					 "movdqa %%xmm1, 16(%1)\n\t"
+					 "movdqa %%xmm2, 32(%1)\n\t"
+					 "movdqa %%xmm3, 48(%1)"
+					 : : "r"(s), "r"(d)
+					 : "memory");
+
+		irq_restore(flags);
+
+	}
+
+	memcpy_rep(d,s,c);
+
+}
+
+/*
+ * memset_sse2, hedef hizalandiktan sonra 64 baytlik bloklar movdqa
+ * ile doldurulur.
+ */
+static void memset_sse2(uint8_t *d,uint8_t v,size_t c){
+
+	uint32_t head = -(uint32_t)d & 15,flags;
+	uint32_t pattern = v * 0x01010101;
+
+	memset_rep(d,v,head);
+	d += head;
+	c -= head;
+
+	while(c >= 64){
+
+		size_t chunk = c < MEM_SSE2_CHUNK ? c & ~63 : MEM_SSE2_CHUNK;
+
+		c -= chunk;
+		flags = irq_save();
+
+		__asm__ volatile("movd %0, %%xmm0\n\t"
+				 "pshufd $0, %%xmm0, %%xmm0"
+				 : : "r"(pattern));
+
+		for(; chunk; chunk -= 64,d += 64)
+			__asm__ volatile("movdqa %%xmm0, (%0)\n\t"
+					 "movdqa %%xmm0, 16(%0)\n\t"
+					 "movdqa %%xmm0, 32(%0)\n\t"
+					 "movdqa %%xmm0, 48(%0)"
+					 : : "r"(d) : "memory");
+
+		irq_restore(flags);
+
+	}
+
+	memset_rep(d,v,c);
+
+}
+
+/*
+ * memcmp_bytes, ilk farkli bayta gore sonucu dondurur.
+ */
+static inline int memcmp_bytes(const uint8_t *t1,const uint8_t *t2,size_t c){
+
+	for(; c; c--,t1++,t2++)
+		if(*t1 != *t2)
+			return *t1 - *t2;
+
+	return 0;
+
+}
+
+/*
+ * memcmp_sse2, 16 baytlik bloklari pcmpeqb ile karsilastirir, farkli
+ * blok bulundugunda sonucu bayt bayt belirler. t1 ve t2'nin kalan
+ * boyutu c'ye esittir, islenen kisim kadar ilerletilir.
+ */
+static size_t memcmp_sse2(const uint8_t **t1,const uint8_t **t2,size_t c){
+
+	uint32_t flags = irq_save(),mask;
+	size_t done = 0;
+
+	for(; c - done >= 16 && done < MEM_SSE2_CHUNK; done += 16){
+
+		__asm__ volatile("movdqu (%1), %%xmm0\n\t"
+				 "movdqu (%2), %%xmm1\n\t"
+				 "pcmpeqb %%xmm1, %%xmm0\n\t"
+				 "pmovmskb %%xmm0, %0"
+				 : "=r"(mask)
+				 : "r"(*t1 + done), "r"(*t2 + done));
+
+		if(mask != 0xFFFF)
+			break;
+
+	}
+
+	irq_restore(flags);
+
+	*t1 += done;
+	*t2 += done;
+
+	return done;
+
+}
+
 /*
  * memcmp, verilen 2 bellek bolgesini belirtilen alan
- * boyutu kadar karsilastirir.
+ * boyutu kadar karsilastirir. kelime kelime karsilastirilir,
+ * farkli kelimede sonuc bayt bayt belirlenir.
  *
  * @param m1 : ilk bellek bolgesi
  * @param m2 : diger bellek bolgesi
@@ -492,36 +764,85 @@ char *strrtok(char *s,const char *delim){
  */
 int memcmp(const void *m1, const void *m2, size_t c){
 	
-	const unsigned char *t1, *t2;
-	int r = 0;
+	const uint8_t *t1 = m1,*t2 = m2;
 
-	t1 = m1;
-	t2 = m2;	
-	while(c--){
-		if((r = *t1++ - *t2++) != 0)
-			break;
-	}
+	if(mem_sse2)
+		while(c >= MEM_SSE2_MIN){
+
+			size_t done = memcmp_sse2(&t1,&t2,c);
+
+			c -= done;
+			/* farkli blok bulundu */
+			if(done < MEM_SSE2_CHUNK)
+				return memcmp_bytes(t1,t2,c < 16 ? c : 16);
+
+		}
+
+	for(; c >= 4; c -= 4,t1 += 4,t2 += 4)
+		if(read_unaligned32(t1) != read_unaligned32(t2))
+			return memcmp_bytes(t1,t2,4);
 
-	return r;
+	return memcmp_bytes(t1,t2,c);
 
 }
 
 /*
  * memcpy, bir bellek bolgesinden diger bolgeye belirtilen
- * alanin boyutu kadar kopyalar.
+ * alanin boyutu kadar kopyalar. bolgeler cakismamalidir.
  *
- * @param m1 : ilk bellek bolgesi
- * @param m2 : diger bellek bolgesi
+ * @param dest : hedef bellek bolgesi
+ * @param src : kaynak bellek bolgesi
  * @param c : alanin boyutu
  */
 void *memcpy(void *dest, const void *src, size_t c){
 
-	char *tmp = dest;
-	const char *s = src;
+	if(mem_sse2 && c >= MEM_SSE2_MIN)
+		memcpy_sse2(dest,src,c);
+	else
+		memcpy_rep(dest,src,c);
+
+	return dest;
+
+}
+
+/*
+ * memmove, memcpy gibi kopyalar fakat bolgeler cakisabilir. hedef
+ * kaynaktan sonra baslayip onunla cakisiyorsa sondan basa dogru
+ * kopyalanir, aksi halde ileri kopyalama guvenlidir.
+ *
+ * @param dest : hedef bellek bolgesi
+ * @param src : kaynak bellek bolgesi
+ * @param c : alanin boyutu
+ */
+void *memmove(void *dest, const void *src, size_t c){
+
+	uint8_t *d = (uint8_t*)dest + c;
+	const uint8_t *s = (const uint8_t*)src + c;
+	uint32_t d0,d1,d2,flags;
+
+	if((uint8_t*)dest <= (const uint8_t*)src || (uint8_t*)dest >= s)
+		return memcpy(dest,src,c);
+
+	for(size_t tail = c & 3; tail; tail--)
+		*--d = *--s;
+
+	/*
+	 * DF=1 iken gelen bir kesme isleyicisi rep'li string komutlarini
+	 * ters yonde calistirir. std/cld penceresi kesmeler kapali calisir.
+	 */
+	if(c >>= 2){
+		flags = irq_save();
+		__asm__ volatile("std\n\t"
+				 "rep; movsl\n\t"
+				 "cld"
+				 : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+				 : "0"(c), "1"(d - 4), "2"(s - 4)
+				 : "memory");
+		irq_restore(flags);
+	}
 
-	while (c--)
-		*tmp++ = *s++;
 	return dest;
+
 }
 
 /*
@@ -533,11 +854,56 @@ void *memcpy(void *dest, const void *src, size_t c){
  * @param c : doldurulacak alan
  */
 void *memset(void *s, int v, size_t c){
-	char *tmp = s;
 
-	while (c--)
-		*tmp++ = v;
+	if(mem_sse2 && c >= MEM_SSE2_MIN)
+		memset_sse2(s,(uint8_t)v,c);
+	else
+		memset_rep(s,(uint8_t)v,c);
+
 	return s;
+
+}
+
+/*
+ * memchr, bellek bolgesinde belirtilen bayti arar ve ilk
+ * rastlanan adresi dondurur. bulunamazsa NULL doner.
+ *
+ * @param s : bellek bolgesi
+ * @param v : aranan bayt
+ * @param c : aranacak boyut
+ */
+void *memchr(const void *s, int v, size_t c){
+
+	const uint8_t *p = s,*end,*q;
+	uint32_t pattern = (uint8_t)v * WORD_ONES;
+
+	if(mem_sse2 && c >= MEM_SSE2_MIN){
+
+		for(; (uint32_t)p & 15; p++,c--)
+			if(*p == (uint8_t)v)
+				return (void*)p;
+
+		for(; c >= 16; c -= end - p,p = end){
+
+			end = p + (c < MEM_SSE2_CHUNK ? c & ~15 : MEM_SSE2_CHUNK);
+			q = mem_scan_sse2(p,end,v,false);
+			if(q < end)
+				return (void*)q;
+
+		}
+
+	}
+
+	for(; c >= 4; c -= 4,p += 4)
+		if(word_hasbyte(read_unaligned32(p),pattern))
+			break;
+
+	for(; c; c--,p++)
+		if(*p == (uint8_t)v)
+			return (void*)p;
+
+	return NULL;
+
 }
 
 /*
@@ -550,14 +916,71 @@ void *memset(void *s, int v, size_t c){
  * @param c : aranacak boyut
  */
 void *memscan(void *s, int v, size_t c){
-	unsigned char *p = s;
 
-	while (c--){
-		if (*p == v)
-			break;
-		p++;
+	void *p = memchr(s,v,c);
+
+	return p ? p : (uint8_t*)s + c;
+
+}
+
+/*
+ * str_search, h'nin ilk hlen baytinda n'yi arar. kisa igneler icin
+ * ilk karakter memchr ile bulunup gerisi karsilastirilir, uzun
+ * igneler icin horspool kullanilir: igne ile hizalanan son bayta gore
+ * atlama tablosundan bakilip pencere o kadar kaydirilir.
+ *
+ * @param h : hedef bellek bolgesi
+ * @param hlen : hedefin boyutu
+ * @param n : aranacak igne
+ * @param nlen : ignenin boyutu (sifir olmamali)
+ */
+static char *str_search(const char *h,size_t hlen,const char *n,size_t nlen){
+
+	const uint8_t *hp = (const uint8_t*)h,*np = (const uint8_t*)n;
+	size_t last = nlen - 1;
+	uint8_t skip[256];
+
+	if(nlen < STR_HORSPOOL_MIN){
+
+		while(hlen >= nlen){
+
+			const uint8_t *p = memchr(hp,*np,hlen - last);
+
+			if(!p)
+				return NULL;
+
+			if(!memcmp(p + 1,np + 1,last))
+				return (char*)p;
+
+			hlen -= p + 1 - hp;
+			hp = p + 1;
+
+		}
+
+		return NULL;
+
 	}
-  	return (void *)p;
+
+	/* tablo bayt boyutunda, 255'ten uzun kaymalar kisaltilir */
+	memset(skip,nlen < 255 ? nlen : 255,sizeof(skip));
+	for(size_t i = 0; i < last; i++)
+		skip[np[i]] = last - i < 255 ? last - i : 255;
+
+	/* kayma hicbir zaman nlen'i gecmez, hlen tasmaz */
+	while(hlen >= nlen){
+
+		uint8_t shift = skip[hp[last]];
+
+		if(hp[last] == np[last] && !memcmp(hp,np,last))
+			return (char*)hp;
+
+		hlen -= shift;
+		hp += shift;
+
+	}
+
+	return NULL;
+
 }
 
 /*
@@ -570,20 +993,13 @@ void *memscan(void *s, int v, size_t c){
  */
 char *strstr(const char *s1, const char *s2){
 	
-	size_t l1, l2;
+	size_t l2 = strlen(s2);
 
-	l2 = strlen(s2);
 	if (!l2)
 		return (char *)s1;
 
-	l1 = strlen(s1);
-	while (l1 >= l2){
-		l1--;
-		if (!memcmp(s1, s2, l2))
-			return (char *)s1;
-		s1++;
-	}
-	return NULL;
+	return str_search(s1,strlen(s1),s2,l2);
+
 }
 
 /*
@@ -624,19 +1040,13 @@ char *strcasestr(char *s1,char *s2){
  */
 char *strnstr(const char *s1, const char *s2, size_t len){
 
-	size_t l2;
+	size_t l2 = strlen(s2);
 
-	l2 = strlen(s2);	
 	if (!l2)
 		return (char *)s1;
-	
-	while (len >= l2){
-		len--;
-		if (!memcmp(s1, s2, l2))
-			return (char *)s1;
-		s1++;
-	}
-	return NULL;
+
+	return str_search(s1,len,s2,l2);
+
 }
 
 /*
@@ -684,5 +1094,79 @@ char * strdup(const char *string){
 
 }
 
+/*
+ * string_init, islemci destekliyorsa sse2 ile calisan mem*
+ * fonksiyonlarini secer.
+ */
+void string_init(void){
+
+	mem_sse2 = cpu_enable_sse();
+
+	debug_print(KERN_INFO,"string: using %s mem* routines",mem_sse2 ? "sse2" : "rep");
+
+}
+
+#define STRING_BENCH_MAX	65536
+#define STRING_BENCH_BYTES	(1024 * 1024)	/* her boyutta islenen toplam bayt */
+
+/*
+ * __string_bench, 8 bayttan 64 KiB'a kadar boyutlarda memcpy, memset
+ * ve memcmp'nin cycle basina islenen bayt miktarini (x100) olcer.
+ */
+void __string_bench(void){
+
+	uint8_t *a = malloc(STRING_BENCH_MAX),*b = malloc(STRING_BENCH_MAX);
+
+	if(!a || !b){
+		free(a);
+		free(b);
+		return;
+	}
+
+	memset(a,0x5A,STRING_BENCH_MAX);
+	memset(b,0x5A,STRING_BENCH_MAX);
+
+	debug_print(KERN_INFO,"string bench (%s), size: memcpy memset memcmp (bytes/100 cycles)",
+			mem_sse2 ? "sse2" : "rep");
+
+	for(uint32_t size = 8; size <= STRING_BENCH_MAX; size <<= 2){
+
+		uint32_t loops = STRING_BENCH_BYTES / size,rate[3];
+		uint64_t start,cycles;
+
+		for(uint32_t test = 0; test < 3; test++){
+
+			start = rdtsc();
+
+			for(uint32_t i = 0; i < loops; i++){
+				if(test == 0)
+					memcpy(a,b,size);
+				else if(test == 1)
+					memset(a,i,size);
+				else
+					memcmp(a,b,size);
+			}
+
+			cycles = rdtsc() - start;
+			if(!cycles)
+				cycles = 1;
+
+			rate[test] = (uint32_t)div_u64((uint64_t)loops * size * 100,cycles);
+
+			/* memset a'yi bozdu, memcmp icin tekrar esitle */
+			if(test == 1)
+				memcpy(a,b,STRING_BENCH_MAX);
+
+		}
+
+		debug_print(KERN_DUMP,"%u: %u %u %u",size,rate[0],rate[1],rate[2]);
+
+	}
+
+	free(a);
+	free(b);
+
+}
+
 MODULE_AUTHOR("Burak Köken");
 MODULE_LICENSE("GNU GPL v2");
@@ -19,7 +19,6 @@
 
 #include <uniq/module.h>
 #include <uniq/kernel.h>
-#include <list.h>
 #include <tree.h>
 
 
@@ -37,22 +36,96 @@ tree_t *tree_create(void){
 
 }
 
+/*
+ * tree_node_init, baska bir yapinin icine gomulu dugumu hazirlar.
+ *
+ * @param node : agac dugumu
+ * @param item : item
+ */
+void tree_node_init(tree_node_t *node,void *item){
+
+	node->parent = NULL;
+	node->first_child = node->last_child = NULL;
+	node->prev_sibling = node->next_sibling = NULL;
+	node->child_count = 0;
+	node->item = item;
+
+}
+
+/*
+ * tree_node_next, root alt agacinda on sirali (preorder) dolasimda
+ * node'dan sonraki dugumu dondurur, dolasim bittiyse NULL doner.
+ * once cocuga, yoksa kardese, o da yoksa kardesi olan ilk atanin
+ * kardesine gecilir. stack ya da ozyineleme kullanilmaz.
+ *
+ * @param node : gecerli dugum
+ * @param root : dolasilan alt agacin koku
+ */
+tree_node_t *tree_node_next(tree_node_t *node,tree_node_t *root){
+
+	if(node->first_child)
+		return node->first_child;
+
+	for(; node != root; node = node->parent)
+		if(node->next_sibling)
+			return node->next_sibling;
+
+	return NULL;
+
+}
+
+/*
+ * tree_link_child, dugumu parent'in cocuklarinin sonuna baglar.
+ *
+ * @param parent : ebeveyn dugum
+ * @param child : cocuk dugum
+ */
+static void tree_link_child(tree_node_t *parent,tree_node_t *child){
+
+	child->parent = parent;
+	child->next_sibling = NULL;
+	child->prev_sibling = parent->last_child;
+
+	if(parent->last_child)
+		parent->last_child->next_sibling = child;
+	else
+		parent->first_child = child;
+
+	parent->last_child = child;
+	parent->child_count++;
+
+}
+
 /*
  * tree_node_free, verilen dugumden baslayarak bu
  * dugumun alt dugumleriyle birlikte bellekte bosa
- * cikarir.(free)
+ * cikarir.(free) alt agac ozyinelemesiz, once yapraklar
+ * olmak uzere (postorder) silinir.
  *
  * @param node : agac dugumu
  */
 void tree_node_free(tree_node_t *node){
 
+	tree_node_t *current = node,*next;
+
 	if(!node)
 		return;
 
-	node_t *child_list_node = node->child->first_node;
-	
-	for(;child_list_node; child_list_node = child_list_node->next)
-		tree_node_free((tree_node_t*)child_list_node->item);
+	for(;;){
+
+		while(current->first_child)
+			current = current->first_child;
+
+		if(current == node)
+			break;
+
+		/* yaprak ebeveyninin ilk cocugudur, ondan ayrilir */
+		next = current->next_sibling ? current->next_sibling : current->parent;
+		current->parent->first_child = current->next_sibling;
+		free(current);
+		current = next;
+
+	}
 	
 	free(node);
 
@@ -68,15 +141,13 @@ void tree_node_free(tree_node_t *node){
  */
 void tree_node_destroy(tree_node_t *node){
 
+	tree_node_t *pos;
+
 	if(!node)
 		return;
 
-	node_t *child_list_node = node->child->first_node;
-	
-	for(;child_list_node; child_list_node = child_list_node->next)
-		tree_node_destroy((tree_node_t*)child_list_node->item);
-	
-	free(node->item);
+	tree_for_each(pos,node)
+		free(pos->item);
 
 }
 
@@ -132,59 +203,67 @@ uint32_t tree_total_node(tree_t *tree){
 }
 
 /*
- * tree_child_count, verilen agac dugumundeki child
- * (cocuk) dugum sayisini dondurur.
+ * tree_child_count, verilen agac dugumunun altindaki tum
+ * (cocuk, torun...) dugumlerin sayisini dondurur.
  *
  * @param node : agac dugumu
  */
 uint32_t tree_child_count(tree_node_t *node){
 
-	if(!node || !node->child)
+	uint32_t count = 0;
+	tree_node_t *pos;
+
+	if(!node)
 		return 0;
 
-	uint32_t count = node->child->size;
-	node_t *child_list_node = node->child->first_node;
-	
-	for(;child_list_node; child_list_node = child_list_node->next)
-		count += tree_child_count((tree_node_t*)child_list_node->item);
+	tree_for_each(pos,node)
+		count++;
 
-	return count;
+	/* dugumun kendisi sayilmaz */
+	return count - 1;
 
 }
 
+/*
+ * tree_node_is_ancestor, ancestor dugumu node'un atasi mi? ebeveyn
+ * isaretcileri uzerinden yukari cikilir, O(derinlik).
+ *
+ * @param ancestor : ata dugum
+ * @param node : dugum
+ */
+bool tree_node_is_ancestor(tree_node_t *ancestor,tree_node_t *node){
+
+	for(node = node->parent; node; node = node->parent)
+		if(node == ancestor)
+			return true;
+
+	return false;
+
+}
 
 /*
- * tree_node_search_parent, verilen baslangic dugumunden
- * baslayarak buna bagli tum dugumlerde istenilen dugumu
- * bulmaya calisir, bulamazsa "NULL" doner.
+ * tree_node_search_parent, aranan dugum baslangic dugumunun
+ * altindaysa ebeveynini dondurur, degilse "NULL" doner.
+ * ebeveyn dugumde tutuldugu icin agacta arama yapilmaz.
  *
  * @param start_node : baslangic dugumu
  * @param search : aranan dugum
  */
 tree_node_t *tree_node_search_parent(tree_node_t *start_node,tree_node_t *search){
 
-	tree_node_t *node = NULL;
-	node_t *child_list_node = start_node->child->first_node;
-
-	for(;child_list_node;child_list_node = child_list_node->next){
-		
-		if(child_list_node->item == search)
-			return start_node;
-
-		node = tree_node_search_parent((tree_node_t*)child_list_node->item,search);
-
-		if(node)
-			break;
+	if(!start_node || !search)
+		return NULL;
 
-	}
+	if(search->parent != start_node && !tree_node_is_ancestor(start_node,search))
+		return NULL;
 
-	return node;
+	return search->parent;
 
 }
 
 /*
- * tree_search_parent, agac yapisinde istenilen dugumu
- * bulmaya calisir, bulamazsa "NULL" doner.
+ * tree_search_parent, agac yapisinda istenilen dugumun
+ * ebeveynini dondurur, bulamazsa "NULL" doner.
  *
  * @param tree : agac yapisi
  * @param search : aranan dugum
@@ -212,14 +291,34 @@ tree_node_t *tree_search_parent(tree_t *tree, tree_node_t *search){
 tree_node_t *tree_node_create(void *item){
 
 	tree_node_t *new_node = malloc(sizeof(tree_node_t));
-	new_node->parent = NULL;
-	new_node->child = list_create();
-	new_node->item  = item;
+
+	if(!new_node)
+		return NULL;
+
+	tree_node_init(new_node,item);
 
 	return new_node;
 
 }
 
+/*
+ * tree_set_root, hazir bir dugumu agacin koku yapar.
+ *
+ * @param tree : agac yapisi
+ * @param root : kok dugum
+ */
+void tree_set_root(tree_t *tree,tree_node_t *root){
+
+	if(!tree || !root)
+		return;
+
+	assert(tree->signature == TREE_SIGNATURE && "Wrong! tree signature");
+
+	tree->root_node = root;
+	tree->node_count = 1;
+
+}
+
 /*
  * tree_set_root_node, agac yapisindaki kok dugumu
  * ayarlar. 
@@ -232,11 +331,11 @@ tree_node_t *tree_set_root_node(tree_t *tree,void *item){
 	if(!tree)
 		return NULL;
 
-	assert(tree->signature == TREE_SIGNATURE && "Wrong! tree signature");
-
 	tree_node_t *root = tree_node_create(item);
-	tree->node_count = 1;
-	tree->root_node = root;
+	if(!root)
+		return NULL;
+
+	tree_set_root(tree,root);
 
 	return root;
 
@@ -244,7 +343,7 @@ tree_node_t *tree_set_root_node(tree_t *tree,void *item){
 
 /*
  * tree_push_child_node, child dugumunu parent dugumunun
- * child listesine ekler.
+ * cocuklarinin sonuna ekler.
  *
  * @param tree : agac yapisi
  * @param child : child(cocuk) dugum
@@ -261,8 +360,7 @@ void tree_push_child_node(tree_t *tree,tree_node_t *child,tree_node_t *parent){
 		return;
 
 	tree->node_count++;
-	child->parent = parent;
-	list_push(parent->child,child);
+	tree_link_child(parent,child);
 	
 }
 
@@ -270,7 +368,7 @@ void tree_push_child_node(tree_t *tree,tree_node_t *child,tree_node_t *parent){
  * tree_push_child, yukaridaki tree_push_child_node 
  * fonksiyonundan farkli olarak verilen item icin
  * dugum olusturur ve daha sonra parent dugumunun
- * child listesine bu dugumu ekler. usteki fonksiyonda
+ * cocuklarina bu dugumu ekler. usteki fonksiyonda
  * child dugumu zaten parametre olarak veriyoruz.
  *
  * @param tree : agac yapisi
@@ -288,6 +386,9 @@ tree_node_t *tree_push_child(tree_t *tree,void *item,tree_node_t *parent){
 		return NULL;
 
 	tree_node_t *child = tree_node_create(item);
+	if(!child)
+		return NULL;
+
 	tree_push_child_node(tree,child,parent);
 	
 	return child;
@@ -295,30 +396,69 @@ tree_node_t *tree_push_child(tree_t *tree,void *item,tree_node_t *parent){
 }
 
 /*
- * tree_node_unlink, verilen dugum parent dugumunden ayrilir.
+ * tree_node_unlink, verilen dugum alt agaciyla birlikte parent
+ * dugumunden ayrilir. O(1)
  *
  * @param node : dugum
  */
 void tree_node_unlink(tree_node_t *node){
 
-	 if(!node)
+	tree_node_t *parent;
+
+	if(!node || !(parent = node->parent))
 		return;
 
-	tree_node_t *parent = node->parent;
-	if(!parent)
+	if(node->prev_sibling)
+		node->prev_sibling->next_sibling = node->next_sibling;
+	else
+		parent->first_child = node->next_sibling;
+
+	if(node->next_sibling)
+		node->next_sibling->prev_sibling = node->prev_sibling;
+	else
+		parent->last_child = node->prev_sibling;
+
+	parent->child_count--;
+	node->parent = node->prev_sibling = node->next_sibling = NULL;
+
+}
+
+/*
+ * tree_node_reparent_children, dugumun tum cocuklarini new_parent'in
+ * cocuklarinin sonuna tasir. kardes zinciri tek seferde eklenir,
+ * sadece cocuklarin ebeveyn isaretcileri guncellenir.
+ *
+ * @param node : cocuklari tasinacak dugum
+ * @param new_parent : yeni ebeveyn
+ */
+void tree_node_reparent_children(tree_node_t *node,tree_node_t *new_parent){
+
+	tree_node_t *child;
+
+	if(!node || !new_parent || !node->first_child)
 		return;
 
-	node_t *search = list_search(parent->child,node);
-	list_unlink(parent->child,search);
+	tree_for_each_child(child,node)
+		child->parent = new_parent;
+
+	node->first_child->prev_sibling = new_parent->last_child;
+	if(new_parent->last_child)
+		new_parent->last_child->next_sibling = node->first_child;
+	else
+		new_parent->first_child = node->first_child;
+
+	new_parent->last_child = node->last_child;
+	new_parent->child_count += node->child_count;
+
+	node->first_child = node->last_child = NULL;
+	node->child_count = 0;
 
 }
 
 /* 
- * tree_node_parent_merge, verilen dugumu kendi parent
- * child listesinde arastirir eger bulunursa dugum
- * parent dugumunun child listesinden ayrilir. ve bu
- * dugumun child listesi parent dugumunun child listesiyle
- * birlestirilir.
+ * tree_node_parent_merge, verilen dugumu parent dugumunden
+ * ayirir ve dugumun cocuklarini parent dugumunun cocuklarina
+ * ekler. dugum bosa cikarilir.
  *
  * @param tree : agac yapisi
  * @param node : dugum
@@ -334,25 +474,18 @@ void tree_node_parent_merge(tree_t *tree,tree_node_t *node){
 	if(!parent)
 		return;
 
-	node_t *search = list_search(parent->child,node);
-	list_unlink(parent->child,search);
+	tree_node_unlink(node);
 	tree->node_count--;
 
-	node_t *child_list_node = node->child->first_node;
-	for(;child_list_node;child_list_node = child_list_node->next)
-		((tree_node_t*)child_list_node->item)->parent = parent;
-
-	list_merge(parent->child,node->child);
+	tree_node_reparent_children(node,parent);
 	free(node);
 
 }
 
 /* 
- * tree_parent_root, verilen dugumu kendi parent
- * child listesinde arastirir eger bulunursa dugum
- * parent dugumunun child listesinden ayrilir. ve
- * dugumun child listesi kok dugumun child listesiyle
- * birlestirilir.
+ * tree_parent_root, verilen dugumu parent dugumunden
+ * ayirir ve dugumun cocuklarini kok dugumun cocuklarina
+ * ekler. dugum bosa cikarilir.
  *
  * @param tree : agac yapisi
  * @param node : dugum
@@ -368,23 +501,17 @@ void tree_parent_root(tree_t *tree,tree_node_t *node){
 	if(!parent)
 		return;
 
-	node_t *search = list_search(parent->child,node);
-	list_unlink(parent->child,search);
+	tree_node_unlink(node);
 	tree->node_count--;
 
-	node_t *child_list_node = node->child->first_node;
-	for(;child_list_node;child_list_node = child_list_node->next)
-		((tree_node_t*)child_list_node->item)->parent = tree->root_node;
-
-	list_merge(tree->root_node->child,node->child);
+	tree_node_reparent_children(node,tree->root_node);
 	free(node);
 
 }
 
 /*
- * tree_node_parent_remove, verilen dugumu parent dugumunun
- * child listesinde arar, eger bu listede varsa bu dugum 
- * kaldirilir.
+ * tree_node_parent_remove, verilen dugum parent dugumunun
+ * cocuguysa alt agaciyla birlikte kaldirilir.
  *
  * @param tree : agac yapisi
  * @param node : dugum
@@ -397,11 +524,10 @@ void tree_node_parent_remove(tree_t *tree,tree_node_t *node,tree_node_t *parent)
 	
 	assert(tree->signature == TREE_SIGNATURE && "Wrong! tree signature");
 	
-	if(!parent || !node)
+	if(!parent || !node || node->parent != parent)
 		return;
 	
-	node_t *search = list_search(parent->child,node);
-	list_unlink(parent->child,search);
+	tree_node_unlink(node);
 
 	/*
 	 * +1 dugumun kendisi 
@@ -451,7 +577,7 @@ void __tree_test(void){
 	debug_print(KERN_DUMP,"tree addr : %p, root node addr : %p, node count : %u",tree,
 										     tree->root_node,
 										     tree_total_node(tree));
-	debug_print(KERN_DUMP,"root; child : %p, item : %p, parent : %p",tree->root_node->child,
+	debug_print(KERN_DUMP,"root; child : %p, item : %p, parent : %p",tree->root_node->first_child,
 									 tree->root_node->item,
 									 tree->root_node->parent);	
 }
@@ -26,7 +26,7 @@
 
 extern uintptr_t end;
 uintptr_t last_addr = (uintptr_t)&end;
-static volatile uint32_t mlock = 0;
+static spinlock_t mlock = SPIN_LOCK_UNLOCKED("heap");
 heap_info_t heap_info;
 
 
@@ -59,9 +59,9 @@ static void *_kmalloc(uint32_t size);
  */
 __malloc void *malloc(uint32_t size){
 	
-	spin_lock(&mlock);
+	uint32_t flags = spin_lock_irqsave(&mlock);
 	void *ret_addr = _kmalloc(size);
-	spin_unlock(&mlock);
+	spin_unlock_irqrestore(&mlock,flags);
 	
 	return ret_addr;
 
@@ -76,9 +76,9 @@ __malloc void *malloc(uint32_t size){
  */
 __malloc void *realloc(void *ptr,uint32_t size){
 	
-	spin_lock(&mlock);
+	uint32_t flags = spin_lock_irqsave(&mlock);
 	void *ret_addr = _krealloc(ptr,size);
-	spin_unlock(&mlock);
+	spin_unlock_irqrestore(&mlock,flags);
 	
 	return ret_addr;
 	
@@ -93,9 +93,9 @@ __malloc void *realloc(void *ptr,uint32_t size){
  */
 __malloc void *calloc(uint32_t n,uint32_t size){
 	
-	spin_lock(&mlock);
+	uint32_t flags = spin_lock_irqsave(&mlock);
 	void *ret_addr = _kcalloc(n,size);
-	spin_unlock(&mlock);
+	spin_unlock_irqrestore(&mlock,flags);
 	
 	return ret_addr;
 	
@@ -109,9 +109,9 @@ __malloc void *calloc(uint32_t n,uint32_t size){
  */
 __malloc void *valloc(uint32_t size){
 	
-	spin_lock(&mlock);
+	uint32_t flags = spin_lock_irqsave(&mlock);
 	void *ret_addr = _kvalloc(size);
-	spin_unlock(&mlock);
+	spin_unlock_irqrestore(&mlock,flags);
 	
 	return ret_addr;
 	
@@ -124,12 +124,12 @@ __malloc void *valloc(uint32_t size){
  */
 void free(void *ptr){
 
-	spin_lock(&mlock);
+	uint32_t flags = spin_lock_irqsave(&mlock);
 	
 	if(last_addr < (uint32_t)ptr)
 		_kfree(ptr);
 
-	spin_unlock(&mlock);
+	spin_unlock_irqrestore(&mlock,flags);
 
 }
 
@@ -155,14 +155,12 @@ uint32_t kmalloc_orig(uint32_t size,bool align,uint32_t *physic_addr){
 		else
 			ret_addr = valloc(size);
 
-		if(physic_addr){
-		
-			if(align && size >= (FRAME_SIZE_BYTE * 4)){
-				
-				
-			}	
-			
-		}
+		/*
+		 * heap sayfalari ardisik frame'lerde olmayabilir, donen
+		 * fiziksel adres sadece ilk sayfa icin gecerlidir.
+		 */
+		if(physic_addr)
+			*physic_addr = virt_to_phys((uint32_t)ret_addr);
 		
 		return (uint32_t)ret_addr;
 		
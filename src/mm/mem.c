@@ -27,6 +27,7 @@
 #include <compiler.h>
 #include <uniq/multiboot.h>
 #include <arch.h>
+#include <uniq/errno.h>
 
 #define PAGE_FAULT_INT		14		/* page fault kesme numarasi */
 /* page fault flags */
@@ -56,7 +57,9 @@ typedef struct{
 static mp_info_t mp_info;
 extern uint32_t last_addr;			/* linker "end" adresi */
 extern heap_info_t heap_info;
-static volatile uint32_t alloc_flock = 0;
+static spinlock_t alloc_flock = SPIN_LOCK_UNLOCKED("frame");
+static spinlock_t ioremap_lock = SPIN_LOCK_UNLOCKED("ioremap");
+static uint32_t ioremap_next = IOREMAP_BASE;	/* pencerenin bos kismi */
 
 page_dir_t *kernel_dir = NULL;
 page_dir_t *current_dir = NULL;
@@ -78,7 +81,7 @@ void sync_mmap(mboot_info_t *mboot_info){
 
 	mboot_memmap_t *memmap = (mboot_memmap_t*)mboot_info->mmap_addr;
 	debug_print(KERN_NOTICE,"synchronizing the memory map");
-	debug_print(KERN_DUMP,"memmap : %p, mmap_addr : %p, mmap_length : %u byte",memmap,mboot_info->mmap_addr,
+	debug_print(KERN_DUMP,"memmap : %p, mmap_addr : 0x%08x, mmap_length : %u byte",memmap,mboot_info->mmap_addr,
 										   mboot_info->mmap_length);
 	debug_print(KERN_DUMP,"type1 : available memory, type2 : reserved(system ROM, memory-mapped device, etc.)\n");
 
@@ -88,13 +91,11 @@ void sync_mmap(mboot_info_t *mboot_info){
 	while((uint32_t)memmap < mboot_info->mmap_addr + mboot_info->mmap_length){
 
 		/*
-		 * debug_print,printf fonksiyonunu cagirarak yazma islemi yapar. fakat bu
-		 * cekirdekteki printf 32bit desteklidir. eger yan yana 64 bit sayilari
-		 * yazmaya kalkarsaniz ortalik karisir ;).
+		 * base_addr ve length 64 bittir, %llx ile yazilmalidir.
 		 */
 		debug_print(KERN_DUMP,"-> memmap : %p , size : %u byte, type : %u",memmap,memmap->size,memmap->type);
-		debug_print(KERN_DUMP,"base_addr : %p",memmap->base_addr);
-		debug_print(KERN_DUMP,"length : %p byte",memmap->length);
+		debug_print(KERN_DUMP,"base_addr : 0x%08llx",memmap->base_addr);
+		debug_print(KERN_DUMP,"length : 0x%08llx byte",memmap->length);
 
 		if(memmap->type == MMAP_RESERVED){
 
@@ -426,7 +427,7 @@ void page_fault_handler(registers_t *regs){
 	uint32_t fault_addr;
 	__asm__ volatile("mov %%cr2, %0" : "=r"(fault_addr));
 	char err_desc[128];
-	snprintf(err_desc,sizeof(err_desc)-1,"Page Fault ! \033[1;37m%p\033[0m \nError description :",fault_addr);
+	snprintf(err_desc,sizeof(err_desc),"Page Fault ! \033[1;37m0x%08x\033[0m \nError description :",fault_addr);
 
 	if(!(regs->err_code & PF_PRESENT))
 		strcat(err_desc," present ");
@@ -477,6 +478,95 @@ page_t *get_page(uint32_t addr,bool make,page_dir_t *dir){
 
 }
 
+/*
+ * virt_to_phys, kernel_dir'e gore verilen sanal adresin fiziksel
+ * adresini dondurur. sayfa yoksa adres aynen doner (identity map).
+ *
+ * @param addr : sanal adres
+ */
+uint32_t virt_to_phys(uint32_t addr){
+
+	page_t *page = get_page(addr,false,kernel_dir);
+
+	if(!page || !page->frame)
+		return addr;
+
+	return page->frame * FRAME_SIZE_BYTE + (addr & PAGE_MASK);
+
+}
+
+/*
+ * user_access_check, sistem cagrisina verilen adres araliginin tamami
+ * kullanici penceresinde mi ve calisan surecin sayfa dizininde
+ * kullaniciya acik sayfalara eslenmis mi diye bakar. kernel bu
+ * adreslere dogrudan eristigi icin her isaretci parametresi once
+ * bundan gecmelidir. gecerliyse 0, degilse -EFAULT doner.
+ *
+ * @param addr : kullanici adresi
+ * @param size : aralik boyutu
+ * @param write : araliga yazilacak mi?
+ */
+int32_t user_access_check(const void *addr,size_t size,bool write){
+
+	uint32_t start = (uint32_t)addr;
+	uint32_t end = start + size;
+
+	if(!size)
+		return 0;
+
+	if(end < start || start < USER_SPACE_START || end > USER_SPACE_END)
+		return -EFAULT;
+
+	for(uint32_t page_addr = start & ~PAGE_MASK; page_addr < end; page_addr += FRAME_SIZE_BYTE){
+		page_t *page = get_page(page_addr,false,current_dir);
+
+		if(!page || !page->present || !page->user || (write && !page->rw))
+			return -EFAULT;
+	}
+
+	return 0;
+
+}
+
+/*
+ * ioremap, fiziksel adres araligini kernel_dir'de IOREMAP penceresine
+ * esler ve sanal adresini dondurur. pencere dolduysa NULL doner.
+ * eslemeler geri alinmaz, aygit ve firmware tablolari icin kullanilir.
+ *
+ * @param phys_addr : fiziksel adres
+ * @param size : boyut (byte olarak)
+ */
+void *ioremap(uint32_t phys_addr,uint32_t size){
+
+	uint32_t offset = phys_addr & PAGE_MASK;
+	uint32_t npages = (offset + size + FRAME_SIZE_BYTE - 1) / FRAME_SIZE_BYTE;
+	uint32_t virt,flags;
+
+	flags = spin_lock_irqsave(&ioremap_lock);
+
+	virt = ioremap_next;
+	if(virt + npages * FRAME_SIZE_BYTE > IOREMAP_BASE + IOREMAP_SIZE){
+		spin_unlock_irqrestore(&ioremap_lock,flags);
+		return NULL;
+	}
+	ioremap_next += npages * FRAME_SIZE_BYTE;
+
+	spin_unlock_irqrestore(&ioremap_lock,flags);
+
+	for(uint32_t i = 0; i < npages; i++){
+
+		uint32_t addr = virt + i * FRAME_SIZE_BYTE;
+
+		dma_frame(get_page(addr,false,kernel_dir),PAGE_RWRITE,PAGE_KERNEL_ACCESS,
+				(phys_addr - offset) + i * FRAME_SIZE_BYTE);
+		__asm__ volatile("invlpg (%0)" : : "r"(addr) : "memory");
+
+	}
+
+	return (void*)(virt + offset);
+
+}
+
 /*
  * change_page_dir,sayfa dizinini degistirir.
  *
@@ -546,7 +636,7 @@ static void dump_mp_info(mp_info_t *mp_info){
 	debug_print(KERN_DUMP,"Frame map address is \033[1;37m%p\033[0m, Frame map end address is \033[1;37m%p",
 												mp_info->frame_map,
 												mp_info->frame_map + mp_info->alloc_frame_size / 4);
-	debug_print(KERN_DUMP,"last_addr(end) : \033[1;37m%p",last_addr);	
+	debug_print(KERN_DUMP,"last_addr(end) : \033[1;37m0x%08x",last_addr);	
 	debug_print(KERN_DUMP,"total memory size : %u KiB, total frame : %u",mp_info->total_mem,mp_info->nframe);
 
 #ifdef MEM_NORMAL_USE
@@ -608,9 +698,9 @@ void paging_final(void){
 	if (tmp_heap_start <= last_addr + 0x4000){
 		
 		debug_print(KERN_ERROR, "Kernel heap init address error!");
-		debug_print(KERN_DUMP,"tmp_heap_start : %p, last_addr + 0x4000 : %p", tmp_heap_start,last_addr + 0x4000);
+		debug_print(KERN_DUMP,"tmp_heap_start : 0x%08x, last_addr + 0x4000 : 0x%08x", tmp_heap_start,last_addr + 0x4000);
 		tmp_heap_start = last_addr + 0x100000;
-		debug_print(KERN_DUMP,"new tmp_heap_start : %p",tmp_heap_start);
+		debug_print(KERN_DUMP,"new tmp_heap_start : 0x%08x",tmp_heap_start);
 		
 	}
 	heap_info.alloc_point = tmp_heap_start;
@@ -623,7 +713,7 @@ void paging_final(void){
 	for (uint32_t i = last_addr + 0x4000; i < tmp_heap_start  ; i += FRAME_SIZE_BYTE)
 		alloc_frame(get_page(i,true,kernel_dir),PAGE_RONLY,PAGE_KERNEL_ACCESS);
 
-	debug_print(KERN_DUMP,"(%p - %p) preallocation for heap. %u Byte / %u KiB",heap_info.alloc_point,
+	debug_print(KERN_DUMP,"(0x%08x - 0x%08x) preallocation for heap. %u Byte / %u KiB",heap_info.alloc_point,
 								  		   heap_info.end_point,
 								   	  	   heap_info.size,
 								  		   heap_info.size/1024);
@@ -638,8 +728,12 @@ void paging_final(void){
 	 */
 	for (uint32_t i = heap_info.alloc_point ; i < heap_info.end_point ; i += FRAME_SIZE_BYTE)
 		get_page(i,true,kernel_dir);
+
+	/* ioremap penceresinin sayfa tablolari */
+	for (uint32_t i = IOREMAP_BASE; i < IOREMAP_BASE + IOREMAP_SIZE; i += FRAME_SIZE_BYTE * PAGE_MAX_LIMIT)
+		get_page(i,true,kernel_dir);
 	
-	debug_print(KERN_DUMP,"last_addr(end) : \033[1;37m%p\033[0m",last_addr);
+	debug_print(KERN_DUMP,"last_addr(end) : \033[1;37m0x%08x\033[0m",last_addr);
 	debug_print(KERN_DUMP,"Memory mapping size : %u KiB",use_memory_size());
 	
 	/*
@@ -707,7 +801,7 @@ void *sbrk(uint32_t inc){
 		
 		for(uint32_t i = heap_info.current_end; i < heap_info.current_end + inc; i += FRAME_SIZE_BYTE){
 			
-			debug_print(KERN_DUMP,"frame addr : %p", i);
+			debug_print(KERN_DUMP,"frame addr : 0x%08x", i);
 			alloc_frame(get_page(i,false,kernel_dir),PAGE_RONLY,PAGE_KERNEL_ACCESS);
 			
 		}